@@ -3,19 +3,34 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
-#include <queue>
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 
-Geometry::Geometry() : EBO(0), flags(0) {
+CompactGeometryVertex::CompactGeometryVertex(const GeometryVertex& vertex)
+    : position(vertex.position)
+    , normal(glm::packSnorm3x10_1x2(glm::vec4(vertex.normal, 0.f)))
+    , texcoord(glm::packHalf2x16(vertex.texcoord))
+    , colour(vertex.colour) {
+}
+
+Geometry::Geometry() : flags(0) {
 }
 
 Geometry::~Geometry() {
-    if (EBO) {
-        glDeleteBuffers(1, &EBO);
+    if (arena) {
+        arena->release(allocation);
     }
 }
 
+size_t Geometry::getBufferSize() const {
+    if (!arena || !dbuff) {
+        return 0;
+    }
+    return allocation.vertexCount * arena->getVertexSize() +
+           allocation.indexCount * dbuff->getIndexSize();
+}
+
 ModelFrame::ModelFrame(unsigned int index, glm::mat3 dR, glm::vec3 dT)
     : index(index)
     , defaultRotation(dR)
@@ -27,7 +42,28 @@ ModelFrame::ModelFrame(unsigned int index, glm::mat3 dR, glm::vec3 dT)
 void ModelFrame::reset() {
     matrix = glm::translate(glm::mat4(1.0f), defaultTranslation) *
              glm::mat4(defaultRotation);
-    updateHierarchyTransform();
+    invalidate();
+}
+
+void ModelFrame::invalidate() {
+    if (parent_) {
+        // The descendants of a dirty frame are already dirty
+        if (dirty_) {
+            return;
+        }
+        dirty_ = true;
+    } else {
+        worldtransform_ = matrix;
+    }
+    for (const auto& child : children_) {
+        child->invalidate();
+    }
+}
+
+void ModelFrame::updateWorldTransform() const {
+    // Only frames with a parent are ever dirty
+    worldtransform_ = parent_->getWorldTransform() * matrix;
+    dirty_ = false;
 }
 
 void ModelFrame::updateHierarchyTransform() {
@@ -37,6 +73,7 @@ void ModelFrame::updateHierarchyTransform() {
     } else {
         worldtransform_ = matrix;
     }
+    dirty_ = false;
     for (const auto& child : children_) {
         child->updateHierarchyTransform();
     }
@@ -52,7 +89,7 @@ void ModelFrame::addChild(const ModelFramePtr& child) {
     }
     child->parent_ = this;
     children_.push_back(child);
-    child->updateHierarchyTransform();
+    child->invalidate();
 }
 
 ModelFrame* ModelFrame::findDescendant(const std::string& name) const {
@@ -90,12 +127,46 @@ AtomicPtr Atomic::clone() const {
     return newatomic;
 }
 
+constexpr size_t Clump::kNoFrame;
+
 ModelFrame* Clump::findFrame(const std::string& name) const {
-    if (rootframe_->getName() == name) {
-        return rootframe_.get();
+    auto index = findFrameIndex(name);
+    return index != kNoFrame ? frames_[index].get() : nullptr;
+}
+
+size_t Clump::findFrameIndex(const std::string& name) const {
+    auto it = frameNames_.find(name);
+    return it != frameNames_.end() ? it->second : kNoFrame;
+}
+
+void Clump::setFrame(const ModelFramePtr& root) {
+    rootframe_ = root;
+    frames_.clear();
+    frameNames_.clear();
+    if (!root) {
+        return;
     }
 
-    return rootframe_->findDescendant(name);
+    // Depth first, matching the order findDescendant searches in
+    std::vector<ModelFramePtr> open{root};
+    while (!open.empty()) {
+        auto frame = open.back();
+        open.pop_back();
+        frameNames_.emplace(frame->getName(), frames_.size());
+        frames_.push_back(frame);
+
+        const auto& children = frame->getChildren();
+        open.insert(open.end(), children.rbegin(), children.rend());
+    }
+}
+
+void Clump::updateTransforms() {
+    for (const auto& frame : frames_) {
+        // Parents come first, so this never has to look further up
+        if (frame->isDirty()) {
+            frame->getWorldTransform();
+        }
+    }
 }
 
 Clump::~Clump() = default;
@@ -119,22 +190,13 @@ ClumpPtr Clump::clone() const {
     auto clump = std::make_shared<Clump>();
     clump->setFrame(newroot);
 
-    // This isn't the most optimal implementation, but this code is likely
-    // to be replaced soon.
+    // The clone is flattened in the same order, so frames match by position
     auto find_new_frame = [&](const ModelFramePtr& old) -> ModelFramePtr {
-        std::queue<ModelFramePtr> open;
-        open.push(newroot);
-        while (!open.empty()) {
-            auto frame = open.front();
-            open.pop();
-            if (frame->getIndex() == old->getIndex()) {
-                return frame;
-            }
-            for (const auto& child : frame->getChildren()) {
-                open.push(child);
-            }
+        auto it = std::find(frames_.begin(), frames_.end(), old);
+        if (it == frames_.end()) {
+            return nullptr;
         }
-        return nullptr;
+        return clump->frames_[static_cast<size_t>(it - frames_.begin())];
     };
 
     // Generate new atomics
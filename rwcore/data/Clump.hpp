@@ -2,13 +2,16 @@
 #define _LIBRW_CLUMP_HPP_
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <glm/glm.hpp>
 
 #include <gl/gl_core_3_3.h>
 #include <gl/DrawBuffer.hpp>
+#include <gl/GeometryArena.hpp>
 #include <gl/GeometryBuffer.hpp>
 #include <gl/TextureData.hpp>
 #include <loaders/RWBinaryStream.hpp>
@@ -17,17 +20,29 @@
 
 /**
  * ModelFrame stores transformation hierarchy
+ *
+ * Changing a frame's transform doesn't touch the world transforms below it,
+ * they are only marked out of date. A frame's world transform is brought up
+ * to date when it is read, or for a whole clump at once by
+ * Clump::updateTransforms(). Root frames are always up to date.
+ *
+ * Since reading a frame that is out of date writes to it, frames shared
+ * between threads must be brought up to date before they are shared.
  */
 class ModelFrame {
     unsigned int index;
     glm::mat3 defaultRotation;
     glm::vec3 defaultTranslation;
     glm::mat4 matrix{1.0f};
-    glm::mat4 worldtransform_{1.0f};
+    mutable glm::mat4 worldtransform_{1.0f};
+    /// worldtransform_ is out of date, and so are all the descendants'
+    mutable bool dirty_ = false;
     ModelFrame* parent_;
     std::string name;
     std::vector<ModelFramePtr> children_;
 
+    void updateWorldTransform() const;
+
 public:
     ModelFrame(unsigned int index = 0, glm::mat3 dR = glm::mat3{1.0f},
                glm::vec3 dT = glm::vec3());
@@ -36,7 +51,7 @@ public:
 
     void setTransform(const glm::mat4& m) {
         matrix = m;
-        updateHierarchyTransform();
+        invalidate();
     }
 
     const glm::mat4& getTransform() const {
@@ -61,28 +76,42 @@ public:
 
     void setTranslation(const glm::vec3& t) {
         matrix[3] = glm::vec4(t, matrix[3][3]);
-        updateHierarchyTransform();
+        invalidate();
     }
 
     void setRotation(const glm::mat3& r) {
         for (unsigned int i = 0; i < 3; i++) {
             matrix[i] = glm::vec4(r[i], matrix[i][3]);
         }
-        updateHierarchyTransform();
+        invalidate();
     }
 
     /**
-     * Updates the cached matrix
+     * Marks the world transforms of this frame and its descendants out of
+     * date after the transform has changed
+     */
+    void invalidate();
+
+    /**
+     * Updates the cached matrix of this frame and all its descendants now
      */
     void updateHierarchyTransform();
 
     /**
-     * @return the cached world transformation for this Frame
+     * @return the world transformation for this Frame, updated first if it
+     * is out of date
      */
     const glm::mat4& getWorldTransform() const {
+        if (dirty_) {
+            updateWorldTransform();
+        }
         return worldtransform_;
     }
 
+    bool isDirty() const {
+        return dirty_;
+    }
+
     ModelFrame* getParent() const {
         return parent_;
     }
@@ -107,7 +136,12 @@ public:
  */
 
 struct SubGeometry {
+    /// First index, within the geometry until it's uploaded and then within
+    /// its GeometryArena page
     size_t start = 0;
+    /// Added to each index when drawing, the geometry's first vertex in its
+    /// GeometryArena page
+    GLint baseVertex = 0;
     size_t material = 0;
     std::vector<uint32_t> indices;
     size_t numIndices = 0;
@@ -138,6 +172,32 @@ struct GeometryVertex {
     GeometryVertex() = default;
 };
 
+/**
+ * Packed form of GeometryVertex, with the normal in 10:10:10:2 format and
+ * half float texture coordinates. Positions stay full precision.
+ */
+struct CompactGeometryVertex {
+    glm::vec3 position{}; /* 0 */
+    uint32_t normal{};    /* 12 */
+    uint32_t texcoord{};  /* 16 */
+    glm::u8vec4 colour{}; /* 20 */
+
+    /** @see GeometryBuffer */
+    static const AttributeList vertex_attributes() {
+        return {{ATRS_Position, 3, sizeof(CompactGeometryVertex), 0ul},
+                {ATRS_Normal, 4, sizeof(CompactGeometryVertex),
+                 sizeof(float) * 3, GL_INT_2_10_10_10_REV},
+                {ATRS_TexCoord, 2, sizeof(CompactGeometryVertex),
+                 sizeof(float) * 4, GL_HALF_FLOAT},
+                {ATRS_Colour, 4, sizeof(CompactGeometryVertex),
+                 sizeof(float) * 5, GL_UNSIGNED_BYTE}};
+    }
+
+    explicit CompactGeometryVertex(const GeometryVertex& vertex);
+
+    CompactGeometryVertex() = default;
+};
+
 /**
  * Geometry
  */
@@ -169,10 +229,11 @@ struct Geometry {
         float ambientIntensity;
     };
 
-    DrawBuffer dbuff;
-    GeometryBuffer gbuff;
+    /// The VAO of the arena page holding the vertices and indices
+    DrawBuffer* dbuff = nullptr;
 
-    GLuint EBO;
+    std::shared_ptr<GeometryArena> arena;
+    GeometryArena::Allocation allocation;
 
     RW::BSGeometryBounds geometryBounds;
 
@@ -187,6 +248,9 @@ struct Geometry {
 
     Geometry();
     ~Geometry();
+
+    /// Bytes of vertex and index data held in the arena
+    size_t getBufferSize() const;
 };
 
 /**
@@ -241,16 +305,28 @@ public:
 
 /**
  * A clump is a collection of Frames and Atomics
+ *
+ * The frame hierarchy is also kept flattened, with every frame after its
+ * parent, so the world transforms can be updated in one pass. Frames added
+ * to the hierarchy after setFrame() aren't seen until it is called again.
  */
 class Clump {
 public:
+    static constexpr size_t kNoFrame = std::numeric_limits<size_t>::max();
+
     /**
      * @brief findFrame Locates frame with name anywhere in the hierarchy
      * @param name
-     * @return
+     * @return The first frame with the name, searching depth first
      */
     ModelFrame* findFrame(const std::string& name) const;
 
+    /**
+     * @brief findFrameIndex Locates a frame like findFrame()
+     * @return The frame's position in getFrames(), or kNoFrame
+     */
+    size_t findFrameIndex(const std::string& name) const;
+
     ~Clump();
 
     void recalculateMetrics();
@@ -267,14 +343,25 @@ public:
         return atomics_;
     }
 
-    void setFrame(const ModelFramePtr& root) {
-        rootframe_ = root;
-    }
+    void setFrame(const ModelFramePtr& root);
 
     const ModelFramePtr& getFrame() const {
         return rootframe_;
     }
 
+    /**
+     * @return Every frame in the hierarchy, each after its parent
+     */
+    const std::vector<ModelFramePtr>& getFrames() const {
+        return frames_;
+    }
+
+    /**
+     * @brief updateTransforms Brings the world transform of every frame up
+     * to date
+     */
+    void updateTransforms();
+
     /**
      * @return A Copy of the frames and atomics in this clump
      */
@@ -284,6 +371,11 @@ private:
     float boundingRadius;
     AtomicList atomics_;
     ModelFramePtr rootframe_;
+
+    std::vector<ModelFramePtr> frames_;
+    /// Index of the first frame with each name, in the order they are
+    /// searched
+    std::unordered_map<std::string, size_t> frameNames_;
 };
 
 #endif
@@ -15,17 +15,21 @@ DrawBuffer::~DrawBuffer() {
 }
 
 void DrawBuffer::addGeometry(GeometryBuffer* gbuff) {
+    addGeometry(gbuff->getVBOName(), 0, gbuff->getDataAttributes());
+}
+
+void DrawBuffer::addGeometry(GLuint vbo, GLintptr offset,
+                             const AttributeList& attributes) {
     if (vao == 0) {
         glGenVertexArrays(1, &vao);
     }
 
     glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, gbuff->getVBOName());
-    // Iterate the attributes present in the gbuff
-    for (const AttributeIndex& at : gbuff->getDataAttributes()) {
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    for (const AttributeIndex& at : attributes) {
         auto vaoindex = static_cast<GLuint>(at.sem);
         glEnableVertexAttribArray(vaoindex);
         glVertexAttribPointer(vaoindex, static_cast<GLint>(at.size), at.type, GL_TRUE, at.stride,
-                              reinterpret_cast<void*>(at.offset));
+                              reinterpret_cast<void*>(static_cast<size_t>(offset) + at.offset));
     }
 }
@@ -1,8 +1,9 @@
 #ifndef _LIBRW_DRAWBUFFER_HPP_
 #define _LIBRW_DRAWBUFFER_HPP_
-#include <gl/gl_core_3_3.h>
+#include <cstddef>
 
-class GeometryBuffer;
+#include <gl/gl_core_3_3.h>
+#include <gl/GeometryBuffer.hpp>
 
 /**
  * DrawBuffer stores VAO state
@@ -12,6 +13,8 @@ class DrawBuffer {
 
     GLenum facetype;
 
+    GLenum indextype = GL_UNSIGNED_INT;
+
 public:
     DrawBuffer();
     ~DrawBuffer();
@@ -28,10 +31,33 @@ public:
         return facetype;
     }
 
+    /**
+     * Sets the type of the indices in the element buffer, GL_UNSIGNED_INT
+     * or GL_UNSIGNED_SHORT
+     */
+    void setIndexType(GLenum it) {
+        indextype = it;
+    }
+
+    GLenum getIndexType() const {
+        return indextype;
+    }
+
+    size_t getIndexSize() const {
+        return indextype == GL_UNSIGNED_SHORT ? 2 : 4;
+    }
+
     /**
      * Adds a Geometry Buffer to the Draw Buffer.
      */
     void addGeometry(GeometryBuffer* gbuff);
+
+    /**
+     * Adds vertex data starting at offset in a buffer that isn't owned by a
+     * Geometry Buffer.
+     */
+    void addGeometry(GLuint vbo, GLintptr offset,
+                     const AttributeList& attributes);
 };
 
 #endif
@@ -0,0 +1,190 @@
+#include "gl/GeometryArena.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <rw/debug.hpp>
+
+constexpr size_t RangeAllocator::kNoSpace;
+constexpr size_t GeometryArena::kPageVertices;
+constexpr size_t GeometryArena::kPageIndices;
+
+RangeAllocator::RangeAllocator(size_t capacity)
+    : capacity_(capacity), freeSize_(capacity) {
+    if (capacity > 0) {
+        free_.emplace(0, capacity);
+    }
+}
+
+size_t RangeAllocator::allocate(size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+        if (it->second < size) {
+            continue;
+        }
+
+        auto offset = it->first;
+        auto remaining = it->second - size;
+        free_.erase(it);
+        if (remaining > 0) {
+            free_.emplace(offset + size, remaining);
+        }
+        freeSize_ -= size;
+        return offset;
+    }
+
+    return kNoSpace;
+}
+
+void RangeAllocator::free(size_t offset, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    RW_ASSERT(offset + size <= capacity_);
+    freeSize_ += size;
+
+    auto next = free_.lower_bound(offset);
+    RW_CHECK(next == free_.end() || next->first >= offset + size,
+             "Freeing a range that overlaps a free range");
+
+    // Merge with the free range after this one
+    if (next != free_.end() && next->first == offset + size) {
+        size += next->second;
+        next = free_.erase(next);
+    }
+
+    // And the one before it
+    if (next != free_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            return;
+        }
+    }
+
+    free_.emplace_hint(next, offset, size);
+}
+
+GeometryArena::GeometryArena(const AttributeList& attributes)
+    : attributes_(attributes)
+    , vertexSize_(attributes.empty() ? 0 : attributes.front().stride) {
+}
+
+GeometryArena::~GeometryArena() {
+    for (auto& page : pages_) {
+        glDeleteBuffers(1, &page->vbo);
+        glDeleteBuffers(1, &page->ebo);
+    }
+}
+
+GeometryArena::Page& GeometryArena::createPage(GLenum faceType,
+                                               GLenum indexType,
+                                               size_t vertexCapacity,
+                                               size_t indexCapacity) {
+    pages_.push_back(
+        std::make_unique<Page>(vertexCapacity, indexCapacity));
+    auto& page = *pages_.back();
+    page.faceType = faceType;
+    page.indexType = indexType;
+
+    glGenBuffers(1, &page.vbo);
+    glGenBuffers(1, &page.ebo);
+
+    const auto vertexBytes = vertexCapacity * getVertexSize();
+    glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexBytes),
+                 nullptr, GL_STATIC_DRAW);
+
+    // Binding the element buffer while the VAO is bound attaches it
+    page.dbuff.setFaceType(faceType);
+    page.dbuff.setIndexType(indexType);
+    page.dbuff.addGeometry(page.vbo, 0, attributes_);
+    const auto indexBytes = indexCapacity * page.dbuff.getIndexSize();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexBytes),
+                 nullptr, GL_STATIC_DRAW);
+    page.memory.resize(vertexBytes + indexBytes);
+
+    return page;
+}
+
+GeometryArena::Allocation GeometryArena::allocate(GLenum faceType,
+                                                  GLenum indexType,
+                                                  size_t vertexCount,
+                                                  size_t indexCount) {
+    Allocation allocation;
+    allocation.vertexCount = vertexCount;
+    allocation.indexCount = indexCount;
+
+    for (size_t p = 0; p < pages_.size(); ++p) {
+        auto& page = *pages_[p];
+        if (page.faceType != faceType || page.indexType != indexType) {
+            continue;
+        }
+
+        auto firstVertex = page.vertices.allocate(vertexCount);
+        if (firstVertex == RangeAllocator::kNoSpace) {
+            continue;
+        }
+        auto firstIndex = page.indices.allocate(indexCount);
+        if (firstIndex == RangeAllocator::kNoSpace) {
+            page.vertices.free(firstVertex, vertexCount);
+            continue;
+        }
+
+        allocation.page = p;
+        allocation.firstVertex = firstVertex;
+        allocation.firstIndex = firstIndex;
+        return allocation;
+    }
+
+    // Geometry larger than a page gets a page of its own size
+    auto& page =
+        createPage(faceType, indexType, std::max(kPageVertices, vertexCount),
+                   std::max(kPageIndices, indexCount));
+    allocation.page = pages_.size() - 1;
+    allocation.firstVertex = page.vertices.allocate(vertexCount);
+    allocation.firstIndex = page.indices.allocate(indexCount);
+    return allocation;
+}
+
+void GeometryArena::release(const Allocation& allocation) {
+    RW_ASSERT(allocation.page < pages_.size());
+    auto& page = *pages_[allocation.page];
+    page.vertices.free(allocation.firstVertex, allocation.vertexCount);
+    page.indices.free(allocation.firstIndex, allocation.indexCount);
+}
+
+void GeometryArena::uploadVertices(const Allocation& allocation,
+                                   const void* data) {
+    if (allocation.vertexCount == 0) {
+        return;
+    }
+
+    // The copy target leaves the bound VAO's buffers alone
+    auto& page = *pages_[allocation.page];
+    glBindBuffer(GL_COPY_WRITE_BUFFER, page.vbo);
+    glBufferSubData(
+        GL_COPY_WRITE_BUFFER,
+        static_cast<GLintptr>(allocation.firstVertex) * vertexSize_,
+        static_cast<GLsizeiptr>(allocation.vertexCount) * vertexSize_, data);
+}
+
+void GeometryArena::uploadIndices(const Allocation& allocation, size_t offset,
+                                  size_t count, const void* data) {
+    RW_ASSERT(offset + count <= allocation.indexCount);
+    if (count == 0) {
+        return;
+    }
+
+    auto& page = *pages_[allocation.page];
+    const auto indexSize = page.dbuff.getIndexSize();
+    glBindBuffer(GL_COPY_WRITE_BUFFER, page.ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER,
+                    static_cast<GLintptr>((allocation.firstIndex + offset) *
+                                          indexSize),
+                    static_cast<GLsizeiptr>(count * indexSize), data);
+}
@@ -0,0 +1,152 @@
+#ifndef _LIBRW_GEOMETRYARENA_HPP_
+#define _LIBRW_GEOMETRYARENA_HPP_
+#include <gl/gl_core_3_3.h>
+#include <gl/DrawBuffer.hpp>
+#include <gl/GeometryBuffer.hpp>
+#include <rw/memory.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Hands out ranges of a fixed size space, reusing freed ranges
+ */
+class RangeAllocator {
+public:
+    static constexpr size_t kNoSpace = std::numeric_limits<size_t>::max();
+
+    explicit RangeAllocator(size_t capacity);
+
+    /**
+     * @brief allocate Finds the first free range that fits
+     * @return The offset of the range, or kNoSpace if none is large enough
+     */
+    size_t allocate(size_t size);
+
+    /**
+     * @brief free Returns a range, merging it with its free neighbours
+     */
+    void free(size_t offset, size_t size);
+
+    size_t getCapacity() const {
+        return capacity_;
+    }
+
+    size_t getFreeSize() const {
+        return freeSize_;
+    }
+
+private:
+    size_t capacity_;
+    size_t freeSize_;
+
+    /// Size of each free range by its offset
+    std::map<size_t, size_t> free_;
+};
+
+/**
+ * @brief Shared vertex and index buffers for model geometry
+ *
+ * Geometry is sub-allocated out of large pages, each with one vertex buffer,
+ * one element buffer and a VAO over both, so every model in a page is drawn
+ * without rebinding anything. Indices are stored relative to the geometry's
+ * first vertex and drawn with a base vertex, so 16-bit indices work for any
+ * geometry with fewer than 65536 vertices. Freed ranges are reused by
+ * later allocations. All the vertices share one vertex format.
+ */
+class GeometryArena {
+public:
+    static constexpr size_t kPageVertices = 1 << 18;
+    static constexpr size_t kPageIndices = 1 << 20;
+
+    /**
+     * Vertices and indices allocated to one geometry
+     */
+    struct Allocation {
+        size_t page = 0;
+        size_t firstVertex = 0;
+        size_t vertexCount = 0;
+        size_t firstIndex = 0;
+        size_t indexCount = 0;
+    };
+
+    /**
+     * @param attributes The vertex format, which every page uses
+     */
+    explicit GeometryArena(const AttributeList& attributes);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    /**
+     * @brief allocate Finds room for a geometry in a page drawn as faceType
+     * with indices of indexType, creating a new page if none has space
+     */
+    Allocation allocate(GLenum faceType, GLenum indexType, size_t vertexCount,
+                        size_t indexCount);
+
+    /**
+     * @brief release Frees an allocation's ranges for reuse
+     */
+    void release(const Allocation& allocation);
+
+    /**
+     * @brief uploadVertices Copies all of an allocation's vertices
+     */
+    void uploadVertices(const Allocation& allocation, const void* data);
+
+    /**
+     * @brief uploadIndices Copies indices into an allocation
+     * @param offset Index to start at, from the allocation's first index
+     * @param data Indices of the type the allocation was made with
+     */
+    void uploadIndices(const Allocation& allocation, size_t offset,
+                       size_t count, const void* data);
+
+    DrawBuffer* getDrawBuffer(const Allocation& allocation) {
+        return &pages_[allocation.page]->dbuff;
+    }
+
+    size_t getPageCount() const {
+        return pages_.size();
+    }
+
+    /// Bytes of each vertex
+    size_t getVertexSize() const {
+        return static_cast<size_t>(vertexSize_);
+    }
+
+private:
+    struct Page {
+        Page(size_t vertexCapacity, size_t indexCapacity)
+            : vertices(vertexCapacity)
+            , indices(indexCapacity)
+            , memory(MemoryTag::Geometry) {
+        }
+
+        GLenum faceType = GL_TRIANGLES;
+        GLenum indexType = GL_UNSIGNED_INT;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        DrawBuffer dbuff;
+        RangeAllocator vertices;
+        RangeAllocator indices;
+        /// Size of both buffers, which is reserved whether used or not
+        TrackedMemory memory;
+    };
+
+    Page& createPage(GLenum faceType, GLenum indexType, size_t vertexCapacity,
+                     size_t indexCapacity);
+
+    AttributeList attributes_;
+    GLsizei vertexSize_;
+
+    std::vector<std::unique_ptr<Page>> pages_;
+};
+
+#endif
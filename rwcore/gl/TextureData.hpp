@@ -2,7 +2,9 @@
 #define _LIBRW_TEXTUREDATA_HPP_
 #include <gl/gl_core_3_3.h>
 #include <glm/glm.hpp>
+#include <rw/memory.hpp>
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -12,8 +14,16 @@
  */
 class TextureData {
 public:
-    TextureData(GLuint name, const glm::ivec2& dims, bool alpha)
-        : texName(name), size(dims), hasAlpha(alpha) {
+    /**
+     * @param memorySize Bytes of video memory used, zero to estimate it
+     */
+    TextureData(GLuint name, const glm::ivec2& dims, bool alpha,
+                size_t memorySize = 0)
+        : texName(name)
+        , size(dims)
+        , hasAlpha(alpha)
+        , memory(MemoryTag::Textures,
+                 memorySize != 0 ? memorySize : estimateMemorySize(dims)) {
     }
 
     ~TextureData() {
@@ -32,17 +42,33 @@ public:
         return hasAlpha;
     }
 
+    size_t getMemorySize() const {
+        return memory.size();
+    }
+
+    /**
+     * @brief estimateMemorySize Guesses the video memory used by a texture,
+     * assuming 32-bit pixels and a full mip chain
+     */
+    static size_t estimateMemorySize(const glm::ivec2& dims) {
+        // A full mip chain adds a third
+        return static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y) * 4 *
+               4 / 3;
+    }
+
     typedef std::shared_ptr<TextureData> Handle;
 
     static Handle create(GLuint name, const glm::ivec2& size,
-                         bool transparent) {
-        return std::make_shared<TextureData>(name, size, transparent);
+                         bool transparent, size_t memorySize = 0) {
+        return std::make_shared<TextureData>(name, size, transparent,
+                                             memorySize);
     }
 
 private:
     GLuint texName;
     glm::ivec2 size;
     bool hasAlpha;
+    TrackedMemory memory;
 };
 using TextureArchive = std::map<std::string, TextureData::Handle>;
 
@@ -35,6 +35,9 @@ enum DFFChunks {
     CHUNK_NODENAME = 0x0253F2FE,
 };
 
+/// Geometry with more vertices than this needs 32-bit indices
+constexpr size_t kMaxShortIndexVertices = 1 << 16;
+
 // These structs are used to interpret raw bytes from the stream.
 /// @todo worry about endianness.
 
@@ -49,7 +52,7 @@ struct RWBSFrame {
     uint32_t matrixflags;  // Not used
 };
 
-LoaderDFF::FrameList LoaderDFF::readFrameList(const RWBStream &stream) {
+void LoaderDFF::readFrameList(ClumpData &clump, const RWBStream &stream) {
     auto listStream = stream.getInnerStream();
 
     auto listStructID = listStream.getNextChunk();
@@ -62,23 +65,22 @@ LoaderDFF::FrameList LoaderDFF::readFrameList(const RWBStream &stream) {
     unsigned int numFrames = *reinterpret_cast<std::uint32_t *>(headerPtr);
     headerPtr += sizeof(std::uint32_t);
 
-    FrameList framelist;
+    auto &framelist = clump.frames;
+    framelist.clear();
     framelist.reserve(numFrames);
 
     for (auto f = 0u; f < numFrames; ++f) {
         auto data = reinterpret_cast<RWBSFrame *>(headerPtr);
         headerPtr += sizeof(RWBSFrame);
-        auto frame =
-            std::make_shared<ModelFrame>(f, data->rotation, data->position);
 
         RW_CHECK(data->index < static_cast<int>(framelist.size()),
                  "Frame parent out of bounds");
-        if (data->index != -1 &&
-            data->index < static_cast<int>(framelist.size())) {
-            framelist[data->index]->addChild(frame);
-        }
+        auto parent = data->index >= 0 &&
+                              data->index < static_cast<int>(framelist.size())
+                          ? data->index
+                          : -1;
 
-        framelist.push_back(frame);
+        framelist.push_back({data->rotation, data->position, parent, {}});
     }
 
     size_t namedFrames = 0;
@@ -99,7 +101,8 @@ LoaderDFF::FrameList LoaderDFF::readFrameList(const RWBStream &stream) {
                                            fname.begin(), ::tolower);
 
                             if (namedFrames < framelist.size()) {
-                                framelist[namedFrames++]->setName(fname);
+                                framelist[namedFrames++].name =
+                                    std::move(fname);
                             }
                         } break;
                         default:
@@ -111,11 +114,9 @@ LoaderDFF::FrameList LoaderDFF::readFrameList(const RWBStream &stream) {
                 break;
         }
     }
-
-    return framelist;
 }
 
-LoaderDFF::GeometryList LoaderDFF::readGeometryList(const RWBStream &stream) {
+void LoaderDFF::readGeometryList(ClumpData &clump, const RWBStream &stream) {
     auto listStream = stream.getInnerStream();
 
     auto listStructID = listStream.getNextChunk();
@@ -128,7 +129,8 @@ LoaderDFF::GeometryList LoaderDFF::readGeometryList(const RWBStream &stream) {
     unsigned int numGeometries = bit_cast<std::uint32_t>(*headerPtr);
     headerPtr += sizeof(std::uint32_t);
 
-    std::vector<GeometryPtr> geometrylist;
+    auto &geometrylist = clump.geometries;
+    geometrylist.clear();
     geometrylist.reserve(numGeometries);
 
     for (auto chunkID = listStream.getNextChunk(); chunkID != 0;
@@ -141,11 +143,9 @@ LoaderDFF::GeometryList LoaderDFF::readGeometryList(const RWBStream &stream) {
                 break;
         }
     }
-
-    return geometrylist;
 }
 
-GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
+ClumpData::GeometryData LoaderDFF::readGeometry(const RWBStream &stream) {
     auto geomStream = stream.getInnerStream();
 
     auto geomStructID = geomStream.getNextChunk();
@@ -153,11 +153,11 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
         throw DFFLoaderException("Geometry missing struct chunk");
     }
 
-    auto geom = std::make_shared<Geometry>();
+    ClumpData::GeometryData geom;
 
     char *headerPtr = geomStream.getCursor();
 
-    geom->flags = bit_cast<std::uint16_t>(*headerPtr);
+    geom.flags = bit_cast<std::uint16_t>(*headerPtr);
     headerPtr += sizeof(std::uint16_t);
 
     /*unsigned short numUVs = bit_cast<std::uint8_t>(*headerPtr);*/
@@ -173,7 +173,7 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
     /*unsigned int numFrames = bit_cast<std::uint32_t>(*headerPtr);*/
     headerPtr += sizeof(std::uint32_t);
 
-    std::vector<GeometryVertex> verts;
+    auto &verts = geom.vertices;
     verts.resize(numVerts);
 
     if (geomStream.getChunkVersion() < 0x1003FFFF) {
@@ -182,7 +182,7 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
 
     /// @todo extract magic numbers.
 
-    if ((geom->flags & 8) == 8) {
+    if ((geom.flags & 8) == 8) {
         for (size_t v = 0; v < numVerts; ++v) {
             verts[v].colour = bit_cast<glm::u8vec4>(*headerPtr);
             headerPtr += sizeof(glm::u8vec4);
@@ -193,7 +193,7 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
         }
     }
 
-    if ((geom->flags & 4) == 4 || (geom->flags & 128) == 128) {
+    if ((geom.flags & 4) == 4 || (geom.flags & 128) == 128) {
         for (size_t v = 0; v < numVerts; ++v) {
             verts[v].texcoord = bit_cast<glm::vec2>(*headerPtr);
             headerPtr += sizeof(glm::vec2);
@@ -205,8 +205,8 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
     memcpy(triangles.get(), headerPtr, sizeof(RW::BSGeometryTriangle) * numTris);
     headerPtr += sizeof(RW::BSGeometryTriangle) * numTris;
 
-    geom->geometryBounds = bit_cast<RW::BSGeometryBounds>(*headerPtr);
-    geom->geometryBounds.radius = std::abs(geom->geometryBounds.radius);
+    geom.bounds = bit_cast<RW::BSGeometryBounds>(*headerPtr);
+    geom.bounds.radius = std::abs(geom.bounds.radius);
     headerPtr += sizeof(RW::BSGeometryBounds);
 
     for (size_t v = 0; v < numVerts; ++v) {
@@ -214,7 +214,7 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
         headerPtr += sizeof(glm::vec3);
     }
 
-    if ((geom->flags & 16) == 16) {
+    if ((geom.flags & 16) == 16) {
         for (size_t v = 0; v < numVerts; ++v) {
             verts[v].normal = bit_cast<glm::vec3>(*headerPtr);
             headerPtr += sizeof(glm::vec3);
@@ -249,29 +249,11 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
         }
     }
 
-    geom->dbuff.setFaceType(geom->facetype == Geometry::Triangles
-                                ? GL_TRIANGLES
-                                : GL_TRIANGLE_STRIP);
-    geom->gbuff.uploadVertices(verts);
-    geom->dbuff.addGeometry(&geom->gbuff);
-
-    glGenBuffers(1, &geom->EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom->EBO);
-
-    size_t icount = std::accumulate(
-        geom->subgeom.begin(), geom->subgeom.end(), size_t{0u},
-        [](size_t a, const SubGeometry &b) { return a + b.numIndices; });
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * icount, nullptr,
-                 GL_STATIC_DRAW);
-    for (auto &sg : geom->subgeom) {
-        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sg.start * sizeof(uint32_t),
-                        sizeof(uint32_t) * sg.numIndices, sg.indices.data());
-    }
-
     return geom;
 }
 
-void LoaderDFF::readMaterialList(const GeometryPtr &geom, const RWBStream &stream) {
+void LoaderDFF::readMaterialList(ClumpData::GeometryData &geom,
+                                 const RWBStream &stream) {
     auto listStream = stream.getInnerStream();
 
     auto listStructID = listStream.getNextChunk();
@@ -281,7 +263,7 @@ void LoaderDFF::readMaterialList(const GeometryPtr &geom, const RWBStream &strea
 
     unsigned int numMaterials = bit_cast<std::uint32_t>(*listStream.getCursor());
 
-    geom->materials.reserve(numMaterials);
+    geom.materials.reserve(numMaterials);
 
     RWBStream::ChunkID chunkID;
     while ((chunkID = listStream.getNextChunk())) {
@@ -295,7 +277,8 @@ void LoaderDFF::readMaterialList(const GeometryPtr &geom, const RWBStream &strea
     }
 }
 
-void LoaderDFF::readMaterial(const GeometryPtr &geom, const RWBStream &stream) {
+void LoaderDFF::readMaterial(ClumpData::GeometryData &geom,
+                             const RWBStream &stream) {
     auto materialStream = stream.getInnerStream();
 
     auto matStructID = materialStream.getNextChunk();
@@ -338,7 +321,7 @@ void LoaderDFF::readMaterial(const GeometryPtr &geom, const RWBStream &stream) {
         }
     }
 
-    geom->materials.push_back(material);
+    geom.materials.push_back(std::move(material));
 }
 
 void LoaderDFF::readTexture(Geometry::Material &material,
@@ -363,12 +346,11 @@ void LoaderDFF::readTexture(Geometry::Material &material,
     std::transform(name.begin(), name.end(), name.begin(), ::tolower);
     std::transform(alpha.begin(), alpha.end(), alpha.begin(), ::tolower);
 
-    TextureData::Handle textureinst =
-        texturelookup ? texturelookup(name, alpha) : nullptr;
-    material.textures.emplace_back(std::move(name), std::move(alpha), textureinst);
+    // The texture itself is looked up when the geometry is uploaded
+    material.textures.emplace_back(std::move(name), std::move(alpha), nullptr);
 }
 
-void LoaderDFF::readGeometryExtension(const GeometryPtr &geom,
+void LoaderDFF::readGeometryExtension(ClumpData::GeometryData &geom,
                                       const RWBStream &stream) {
     auto extStream = stream.getInnerStream();
 
@@ -384,10 +366,11 @@ void LoaderDFF::readGeometryExtension(const GeometryPtr &geom,
     }
 }
 
-void LoaderDFF::readBinMeshPLG(const GeometryPtr &geom, const RWBStream &stream) {
+void LoaderDFF::readBinMeshPLG(ClumpData::GeometryData &geom,
+                               const RWBStream &stream) {
     auto data = stream.getCursor();
 
-    geom->facetype = static_cast<Geometry::FaceType>(bit_cast<std::uint32_t>(*data));
+    geom.facetype = static_cast<Geometry::FaceType>(bit_cast<std::uint32_t>(*data));
     data += sizeof(std::uint32_t);
 
     unsigned int numSplits = bit_cast<std::uint32_t>(*data);
@@ -396,7 +379,7 @@ void LoaderDFF::readBinMeshPLG(const GeometryPtr &geom, const RWBStream &stream)
     // Number of triangles.
     data += sizeof(std::uint32_t);
 
-    geom->subgeom.reserve(numSplits);
+    geom.subgeom.reserve(numSplits);
 
     size_t start = 0;
 
@@ -414,13 +397,11 @@ void LoaderDFF::readBinMeshPLG(const GeometryPtr &geom, const RWBStream &stream)
                     sizeof(std::uint32_t) * sg.numIndices);
         data += sizeof(std::uint32_t) * sg.numIndices;
 
-        geom->subgeom.push_back(std::move(sg));
+        geom.subgeom.push_back(std::move(sg));
     }
 }
 
-AtomicPtr LoaderDFF::readAtomic(FrameList &framelist,
-                                GeometryList &geometrylist,
-                                const RWBStream &stream) {
+void LoaderDFF::readAtomic(ClumpData &clump, const RWBStream &stream) {
     auto atomicStream = stream.getInnerStream();
 
     auto atomicStructID = atomicStream.getNextChunk();
@@ -438,25 +419,16 @@ AtomicPtr LoaderDFF::readAtomic(FrameList &framelist,
     std::uint32_t flags = bit_cast<std::uint32_t>(*data);
 
     // Verify the atomic's particulars
-    RW_CHECK(frame < framelist.size(), "atomic frame " << frame
-                                                       << " out of bounds");
-    RW_CHECK(geometry < geometrylist.size(),
+    RW_CHECK(frame < clump.frames.size(), "atomic frame " << frame
+                                                          << " out of bounds");
+    RW_CHECK(geometry < clump.geometries.size(),
              "atomic geometry " << geometry << " out of bounds");
 
-    auto atomic = std::make_shared<Atomic>();
-    if (geometry < geometrylist.size()) {
-        atomic->setGeometry(geometrylist[geometry]);
-    }
-    if (frame < framelist.size()) {
-        atomic->setFrame(framelist[frame]);
-    }
-    atomic->setFlags(flags);
-
-    return atomic;
+    clump.atomics.push_back({frame, geometry, flags});
 }
 
-ClumpPtr LoaderDFF::loadFromMemory(const FileContentsInfo& file) {
-    auto model = std::make_shared<Clump>();
+ClumpData LoaderDFF::parse(const FileContentsInfo &file) {
+    ClumpData clump;
 
     RWBStream rootStream(file.data.get(), file.length);
 
@@ -476,33 +448,128 @@ ClumpPtr LoaderDFF::loadFromMemory(const FileContentsInfo& file) {
     std::uint32_t numAtomics = bit_cast<std::uint32_t>(*rootStream.getCursor());
     RW_UNUSED(numAtomics);
 
-    GeometryList geometrylist;
-    FrameList framelist;
-
     // Process everything inside the clump stream.
     RWBStream::ChunkID chunkID;
     while ((chunkID = modelStream.getNextChunk())) {
         switch (chunkID) {
             case CHUNK_FRAMELIST:
-                framelist = readFrameList(modelStream);
+                readFrameList(clump, modelStream);
                 break;
             case CHUNK_GEOMETRYLIST:
-                geometrylist = readGeometryList(modelStream);
+                readGeometryList(clump, modelStream);
+                break;
+            case CHUNK_ATOMIC:
+                readAtomic(clump, modelStream);
                 break;
-            case CHUNK_ATOMIC: {
-                auto atomic = readAtomic(framelist, geometrylist, modelStream);
-                RW_CHECK(atomic, "Failed to read atomic");
-                if (!atomic) {
-                    // Abort reading the rest of the clump
-                    return nullptr;
-                }
-                model->addAtomic(atomic);
-            } break;
             default:
                 break;
         }
     }
 
+    return clump;
+}
+
+GeometryPtr LoaderDFF::uploadGeometry(ClumpData::GeometryData &data) {
+    auto geom = std::make_shared<Geometry>();
+    geom->flags = data.flags;
+    geom->facetype = data.facetype;
+    geom->geometryBounds = data.bounds;
+    geom->subgeom = std::move(data.subgeom);
+    geom->materials = std::move(data.materials);
+
+    if (texturelookup) {
+        for (auto &material : geom->materials) {
+            for (auto &texture : material.textures) {
+                texture.texture =
+                    texturelookup(texture.name, texture.alphaName);
+            }
+        }
+    }
+
+    if (!arena) {
+        arena = std::make_shared<GeometryArena>(
+            compactVertices ? CompactGeometryVertex::vertex_attributes()
+                            : GeometryVertex::vertex_attributes());
+    }
+
+    size_t icount = std::accumulate(
+        geom->subgeom.begin(), geom->subgeom.end(), size_t{0u},
+        [](size_t a, const SubGeometry &b) { return a + b.numIndices; });
+    const auto faceType =
+        geom->facetype == Geometry::Triangles ? GL_TRIANGLES
+                                              : GL_TRIANGLE_STRIP;
+    // Indices are relative to the geometry's base vertex, so any geometry
+    // small enough can use 16-bit indices wherever it's placed
+    const bool shortIndices =
+        compactVertices && data.vertices.size() <= kMaxShortIndexVertices;
+    geom->arena = arena;
+    geom->allocation =
+        arena->allocate(faceType,
+                        shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                        data.vertices.size(), icount);
+    geom->dbuff = arena->getDrawBuffer(geom->allocation);
+
+    if (compactVertices) {
+        std::vector<CompactGeometryVertex> compact(data.vertices.begin(),
+                                                   data.vertices.end());
+        arena->uploadVertices(geom->allocation, compact.data());
+    } else {
+        arena->uploadVertices(geom->allocation, data.vertices.data());
+    }
+
+    std::vector<uint16_t> shortIndexData;
+    for (auto &sg : geom->subgeom) {
+        if (shortIndices) {
+            shortIndexData.assign(sg.indices.begin(), sg.indices.end());
+            arena->uploadIndices(geom->allocation, sg.start, sg.numIndices,
+                                 shortIndexData.data());
+        } else {
+            arena->uploadIndices(geom->allocation, sg.start, sg.numIndices,
+                                 sg.indices.data());
+        }
+        sg.start += geom->allocation.firstIndex;
+        sg.baseVertex = static_cast<GLint>(geom->allocation.firstVertex);
+        // Only the GL copy is used from here on
+        std::vector<uint32_t>().swap(sg.indices);
+    }
+
+    return geom;
+}
+
+ClumpPtr LoaderDFF::upload(ClumpData &&data) {
+    auto model = std::make_shared<Clump>();
+
+    FrameList framelist;
+    framelist.reserve(data.frames.size());
+    for (auto f = 0u; f < data.frames.size(); ++f) {
+        auto &fdata = data.frames[f];
+        auto frame =
+            std::make_shared<ModelFrame>(f, fdata.rotation, fdata.position);
+        frame->setName(fdata.name);
+        if (fdata.parent != -1) {
+            framelist[fdata.parent]->addChild(frame);
+        }
+        framelist.push_back(frame);
+    }
+
+    GeometryList geometrylist;
+    geometrylist.reserve(data.geometries.size());
+    for (auto &gdata : data.geometries) {
+        geometrylist.push_back(uploadGeometry(gdata));
+    }
+
+    for (const auto &adata : data.atomics) {
+        auto atomic = std::make_shared<Atomic>();
+        if (adata.geometry < geometrylist.size()) {
+            atomic->setGeometry(geometrylist[adata.geometry]);
+        }
+        if (adata.frame < framelist.size()) {
+            atomic->setFrame(framelist[adata.frame]);
+        }
+        atomic->setFlags(adata.flags);
+        model->addAtomic(atomic);
+    }
+
     if (!framelist.empty()) {
         model->setFrame(framelist[0]);
     }
@@ -512,3 +579,7 @@ ClumpPtr LoaderDFF::loadFromMemory(const FileContentsInfo& file) {
 
     return model;
 }
+
+ClumpPtr LoaderDFF::loadFromMemory(const FileContentsInfo &file) {
+    return upload(parse(file));
+}
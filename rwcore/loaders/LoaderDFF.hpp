@@ -3,9 +3,12 @@
 
 #include <data/Clump.hpp>
 #include <gl/TextureData.hpp>
+#include <rw/debug.hpp>
 #include <rw/forward.hpp>
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -24,6 +27,41 @@ public:
     }
 };
 
+/**
+ * @brief CPU side copy of a clump, as read from a DFF file.
+ *
+ * Holds everything needed to create a Clump without touching GL, so that it
+ * can be produced on any thread. Texture handles are left unset.
+ */
+struct ClumpData {
+    struct FrameData {
+        glm::mat3 rotation;
+        glm::vec3 position;
+        /// Index of the parent frame, or -1 for a root frame
+        int32_t parent;
+        std::string name;
+    };
+
+    struct GeometryData {
+        uint32_t flags = 0;
+        Geometry::FaceType facetype = Geometry::Triangles;
+        RW::BSGeometryBounds bounds{};
+        std::vector<GeometryVertex> vertices;
+        std::vector<SubGeometry> subgeom;
+        std::vector<Geometry::Material> materials;
+    };
+
+    struct AtomicData {
+        uint32_t frame;
+        uint32_t geometry;
+        uint32_t flags;
+    };
+
+    std::vector<FrameData> frames;
+    std::vector<GeometryData> geometries;
+    std::vector<AtomicData> atomics;
+};
+
 class LoaderDFF {
 public:
     using TextureLookupCallback = std::function<TextureData::Handle(
@@ -31,33 +69,78 @@ public:
     using GeometryList = std::vector<GeometryPtr>;
     using FrameList = std::vector<ModelFramePtr>;
 
+    /**
+     * @brief Parses and uploads a model, must be called on the GL thread
+     */
     ClumpPtr loadFromMemory(const FileContentsInfo& file);
 
+    /**
+     * @brief Reads a DFF file into CPU memory, safe to call from any thread
+     * @throws DFFLoaderException if the file is malformed
+     */
+    static ClumpData parse(const FileContentsInfo& file);
+
+    /**
+     * @brief Creates the GL buffers and textures for parsed clump data
+     */
+    ClumpPtr upload(ClumpData&& data);
+
     void setTextureLookupCallback(const TextureLookupCallback& tlc) {
         texturelookup = tlc;
     }
 
+    /**
+     * @brief setCompactVertices Uploads geometry as CompactGeometryVertex,
+     * with 16-bit indices where they fit. Must be set before the first upload
+     */
+    void setCompactVertices(bool compact) {
+        RW_CHECK(!arena, "Vertex format changed after geometry was uploaded");
+        compactVertices = compact;
+    }
+
+    bool getCompactVertices() const {
+        return compactVertices;
+    }
+
+    /**
+     * @brief getGeometryArena The arena uploaded geometry is allocated from,
+     * created by the first upload
+     */
+    const std::shared_ptr<GeometryArena>& getGeometryArena() const {
+        return arena;
+    }
+
 private:
     TextureLookupCallback texturelookup;
 
-    FrameList readFrameList(const RWBStream& stream);
+    std::shared_ptr<GeometryArena> arena;
+
+    bool compactVertices = false;
+
+    static void readFrameList(ClumpData& clump, const RWBStream& stream);
+
+    static void readGeometryList(ClumpData& clump, const RWBStream& stream);
 
-    GeometryList readGeometryList(const RWBStream& stream);
+    static ClumpData::GeometryData readGeometry(const RWBStream& stream);
 
-    GeometryPtr readGeometry(const RWBStream& stream);
+    static void readMaterialList(ClumpData::GeometryData& geom,
+                                 const RWBStream& stream);
 
-    void readMaterialList(const GeometryPtr& geom, const RWBStream& stream);
+    static void readMaterial(ClumpData::GeometryData& geom,
+                             const RWBStream& stream);
 
-    void readMaterial(const GeometryPtr& geom, const RWBStream& stream);
+    static void readTexture(Geometry::Material& material,
+                            const RWBStream& stream);
 
-    void readTexture(Geometry::Material& material, const RWBStream& stream);
+    static void readGeometryExtension(ClumpData::GeometryData& geom,
+                                      const RWBStream& stream);
 
-    void readGeometryExtension(const GeometryPtr& geom, const RWBStream& stream);
+    static void readBinMeshPLG(ClumpData::GeometryData& geom,
+                               const RWBStream& stream);
 
-    void readBinMeshPLG(const GeometryPtr& geom, const RWBStream& stream);
+    static void readAtomic(ClumpData& clump, const RWBStream& stream);
 
-    AtomicPtr readAtomic(FrameList& framelist, GeometryList& geometrylist,
-                         const RWBStream& stream);
+    GeometryPtr uploadGeometry(ClumpData::GeometryData& data);
 };
 
 #endif
@@ -1,10 +1,24 @@
 #include "loaders/LoaderIMG.hpp"
 
-#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <cctype>
 #include <cstdio>
+#include <cstring>
 
+#include "platform/MappedFile.hpp"
 #include "rw/debug.hpp"
 
+namespace {
+constexpr std::size_t kSectorSize = 2048;
+
+std::string foldAssetName(const char* name, std::size_t length) {
+    std::string folded(name, length);
+    std::transform(folded.begin(), folded.end(), folded.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(c)); });
+    return folded;
+}
+}
+
 bool LoaderIMG::load(const rwfs::path& filepath) {
     auto dirPath = filepath;
     dirPath.replace_extension(".dir");
@@ -26,9 +40,20 @@ bool LoaderIMG::load(const rwfs::path& filepath) {
         }
 
         fclose(fp);
+
+        m_assetIndex.clear();
+        m_assetIndex.reserve(m_assets.size());
+        for (std::size_t i = 0; i < m_assets.size(); ++i) {
+            const auto& name = m_assets[i].name;
+            auto key = foldAssetName(name, strnlen(name, sizeof(name)));
+            // Keep the first entry for duplicate names
+            m_assetIndex.emplace(std::move(key), i);
+        }
+
         auto imgPath = filepath;
         imgPath.replace_extension(".img");
         m_archive = imgPath;
+        m_mapping.reset();
         return true;
     } else {
         return false;
@@ -38,32 +63,59 @@ bool LoaderIMG::load(const rwfs::path& filepath) {
 /// Get the information of a asset in the examining archive
 bool LoaderIMG::findAssetInfo(const std::string& assetname,
                               LoaderIMGFile& out) {
-    for (auto &asset : m_assets) {
-        if (boost::iequals(asset.name, assetname)) {
-            out = asset;
-            return true;
-        }
+    size_t index;
+    if (!findAssetIndex(assetname, index)) {
+        return false;
     }
-    return false;
+    out = m_assets[index];
+    return true;
 }
 
-std::unique_ptr<char[]> LoaderIMG::loadToMemory(const std::string& assetname) {
-    LoaderIMGFile assetInfo;
-    bool found = findAssetInfo(assetname, assetInfo);
+bool LoaderIMG::findAssetIndex(const std::string& assetname,
+                               size_t& out) const {
+    auto it = m_assetIndex.find(
+        foldAssetName(assetname.data(), assetname.size()));
+    if (it == m_assetIndex.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
 
-    if (!found) {
-        RW_ERROR("Asset '" << assetname << "' not found!");
-        return nullptr;
+bool LoaderIMG::mapArchive() {
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->open(m_archive.string())) {
+        RW_ERROR("Failed to map IMG archive " << m_archive.string());
+        m_mapping.reset();
+        return false;
+    }
+    m_mapping = std::move(mapping);
+    return true;
+}
+
+std::unique_ptr<char[]> LoaderIMG::readAsset(const LoaderIMGFile& assetInfo) {
+    auto size = assetInfo.size * kSectorSize;
+    auto offset = assetInfo.offset * kSectorSize;
+
+    if (m_mapping) {
+        if (offset + size > m_mapping->size()) {
+            RW_ERROR("Asset " << assetInfo.name << " exceeds archive bounds");
+            return nullptr;
+        }
+        auto raw_data = std::make_unique<char[]>(size);
+        std::memcpy(raw_data.get(), m_mapping->data() + offset, size);
+        return raw_data;
     }
 
     auto imgName = m_archive;
 
     FILE* fp = fopen(imgName.string().c_str(), "rb");
     if (fp) {
-        auto raw_data = std::make_unique<char[]>(assetInfo.size * 2048);
+        auto raw_data = std::make_unique<char[]>(size);
 
-        fseek(fp, assetInfo.offset * 2048, SEEK_SET);
-        if (fread(raw_data.get(), 2048, assetInfo.size, fp) != assetInfo.size) {
+        fseek(fp, offset, SEEK_SET);
+        if (fread(raw_data.get(), kSectorSize, assetInfo.size, fp) !=
+            assetInfo.size) {
             RW_ERROR("Error reading asset " << assetInfo.name);
         }
 
@@ -73,20 +125,78 @@ std::unique_ptr<char[]> LoaderIMG::loadToMemory(const std::string& assetname) {
         return nullptr;
 }
 
+std::unique_ptr<char[]> LoaderIMG::loadToMemory(const std::string& assetname) {
+    LoaderIMGFile assetInfo;
+    bool found = findAssetInfo(assetname, assetInfo);
+
+    if (!found) {
+        RW_ERROR("Asset '" << assetname << "' not found!");
+        return nullptr;
+    }
+
+    return readAsset(assetInfo);
+}
+
+std::unique_ptr<char[]> LoaderIMG::loadToMemory(size_t index) {
+    if (index >= m_assets.size()) {
+        RW_ERROR("Asset index " << index << " out of range");
+        return nullptr;
+    }
+
+    return readAsset(m_assets[index]);
+}
+
+FileContentsInfo LoaderIMG::loadAsset(const std::string& assetname) {
+    size_t index;
+    if (!findAssetIndex(assetname, index)) {
+        RW_ERROR("Asset '" << assetname << "' not found!");
+        return {nullptr, 0};
+    }
+
+    return loadAsset(index);
+}
+
+FileContentsInfo LoaderIMG::loadAsset(size_t index) {
+    if (index >= m_assets.size()) {
+        RW_ERROR("Asset index " << index << " out of range");
+        return {nullptr, 0};
+    }
+
+    const auto& assetInfo = m_assets[index];
+    std::size_t length = assetInfo.size * kSectorSize;
+
+    if (m_mapping) {
+        std::size_t offset = assetInfo.offset * kSectorSize;
+        if (offset + length > m_mapping->size()) {
+            RW_ERROR("Asset " << assetInfo.name << " exceeds archive bounds");
+            return {nullptr, 0};
+        }
+        // The loaders only read file contents, the view stays read-only
+        return {m_mapping, const_cast<char*>(m_mapping->data()) + offset,
+                length};
+    }
+
+    auto data = readAsset(assetInfo);
+    if (!data) {
+        length = 0;
+    }
+    return {std::move(data), length};
+}
+
 /// Writes the contents of assetname to filename
 bool LoaderIMG::saveAsset(const std::string& assetname,
                           const std::string& filename) {
-    auto raw_data = loadToMemory(assetname);
+    size_t index;
+    if (!findAssetIndex(assetname, index)) return false;
+
+    auto raw_data = loadToMemory(index);
     if (!raw_data) return false;
 
     FILE* dumpFile = fopen(filename.c_str(), "wb");
     if (dumpFile) {
-        LoaderIMGFile asset;
-        if (findAssetInfo(assetname, asset)) {
-            fwrite(raw_data.get(), 2048, asset.size, dumpFile);
-            printf("=> IMG: Saved %s to disk with filename %s\n",
-                   assetname.c_str(), filename.c_str());
-        }
+        fwrite(raw_data.get(), kSectorSize, m_assets[index].size, dumpFile);
+        printf("=> IMG: Saved %s to disk with filename %s\n",
+               assetname.c_str(), filename.c_str());
         fclose(dumpFile);
 
         return true;
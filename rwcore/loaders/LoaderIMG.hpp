@@ -3,11 +3,16 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <platform/FileHandle.hpp>
 #include <rw/filesystem.hpp>
 
+class MappedFile;
+
 /// \brief Points to one file within the archive
 class LoaderIMGFile {
 public:
@@ -38,16 +43,41 @@ public:
     /// appropriate
     bool load(const rwfs::path& filename);
 
+    /// Map the .img file into memory, so assets can be read without copying
+    /// Must be called after load; returns false if the mapping failed, in
+    /// which case assets are still read from the file on demand
+    bool mapArchive();
+
+    /// Returns true if the archive has been mapped into memory
+    bool isMapped() const {
+        return m_mapping != nullptr;
+    }
+
     /// Load a file from the archive to memory and pass a pointer to it
     /// Warning: Returns nullptr if by any reason it can't load the file
     std::unique_ptr<char[]> loadToMemory(const std::string& assetname);
 
+    /// Load the file at index from the archive to memory
+    /// Warning: Returns nullptr if by any reason it can't load the file
+    std::unique_ptr<char[]> loadToMemory(size_t index);
+
+    /// Get the contents of a file in the archive. If the archive is mapped
+    /// this is a view into the mapping, otherwise the file is read to memory
+    /// Warning: data is nullptr if by any reason it can't load the file
+    FileContentsInfo loadAsset(const std::string& assetname);
+
+    /// Get the contents of the file at index, see loadAsset(assetname)
+    FileContentsInfo loadAsset(size_t index);
+
     /// Writes the contents of assetname to filename
     bool saveAsset(const std::string& assetname, const std::string& filename);
 
     /// Get the information of an asset in the examining archive
     bool findAssetInfo(const std::string& assetname, LoaderIMGFile& out);
 
+    /// Get the index of an asset in the examining archive (case insensitive)
+    bool findAssetIndex(const std::string& assetname, size_t& out) const;
+
     /// Get the information of an asset by its index
     const LoaderIMGFile& getAssetInfoByIndex(size_t index) const;
 
@@ -63,6 +93,14 @@ private:
     rwfs::path m_archive;  ///< Path to the archive being used (no extension)
 
     std::vector<LoaderIMGFile> m_assets;  ///< Asset info of the archive
+
+    /// Lower case asset name to its index in m_assets
+    std::unordered_map<std::string, size_t> m_assetIndex;
+
+    std::shared_ptr<MappedFile> m_mapping;  ///< Mapping of the archive
+
+    /// Copy the contents of an asset out of the archive
+    std::unique_ptr<char[]> readAsset(const LoaderIMGFile& assetInfo);
 };
 
 #endif  // LoaderIMG_h__
@@ -4,11 +4,13 @@
 #include <cctype>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "gl/gl_core_3_3.h"
 #include "loaders/RWBinaryStream.hpp"
+#include "loaders/TextureDecoder.hpp"
 #include "platform/FileHandle.hpp"
 #include "rw/debug.hpp"
 
@@ -34,146 +36,321 @@ TextureData::Handle getErrorTexture() {
     return tex;
 }
 
-const size_t paletteSize = 1024;
+/// Values of BSTextureNative::dxttype
+constexpr uint8_t kDXT1 = 1;
+constexpr uint8_t kDXT3 = 3;
 
-static
-void processPalette(uint32_t* fullColor, RW::BinaryStreamSection& rootSection) {
-    uint8_t* dataBase = reinterpret_cast<uint8_t*>(
-        rootSection.raw() + sizeof(RW::BSSectionHeader) +
-        sizeof(RW::BSTextureNative) - 4);
+/// Masks the pixel format out of BSTextureNative::rasterformat
+constexpr uint32_t kRasterFormatMask = 0x0F00;
+
+namespace {
+/**
+ * Reads the mip levels stored after the texture native struct, each a size
+ * followed by that many bytes
+ */
+class LevelReader {
+public:
+    LevelReader(const uint8_t* data, const uint8_t* end)
+        : next(data), end(end) {
+    }
+
+    /**
+     * @brief read Steps over the next level
+     * @return The level's data, or null if it is missing or smaller than
+     * minSize
+     */
+    const uint8_t* read(size_t minSize) {
+        if (next + sizeof(uint32_t) > end) {
+            return nullptr;
+        }
+        uint32_t size;
+        std::memcpy(&size, next, sizeof(size));
+        auto data = next + sizeof(uint32_t);
+        if (size < minSize || data + size > end) {
+            return nullptr;
+        }
+        next = data + size;
+        return data;
+    }
+
+    /// Skips bytes stored before the first level
+    void skip(size_t size) {
+        next += size;
+    }
 
-    uint8_t* coldata = (dataBase + paletteSize + sizeof(uint32_t));
-    uint32_t raster_size = *reinterpret_cast<uint32_t*>(dataBase + paletteSize);
-    uint32_t* palette = reinterpret_cast<uint32_t*>(dataBase);
+private:
+    const uint8_t* next;
+    const uint8_t* end;
+};
 
-    for (size_t j = 0; j < raster_size; ++j) {
-        *(fullColor++) = palette[coldata[j]];
+GLenum filterMode(const RW::BSTextureNative& texNative) {
+    switch (texNative.filterflags & 0xFF) {
+        default:
+        case RW::BSTextureNative::FILTER_LINEAR:
+            return GL_LINEAR;
+        case RW::BSTextureNative::FILTER_NEAREST:
+            return GL_NEAREST;
     }
 }
 
-static
-TextureData::Handle createTexture(RW::BSTextureNative& texNative,
-                                  RW::BinaryStreamSection& rootSection) {
-    // TODO: Exception handling.
+GLenum wrapMode(uint8_t wrap) {
+    switch (wrap) {
+        default:
+        case RW::BSTextureNative::WRAP_WRAP:
+            return GL_REPEAT;
+        case RW::BSTextureNative::WRAP_CLAMP:
+            return GL_CLAMP_TO_EDGE;
+        case RW::BSTextureNative::WRAP_MIRROR:
+            return GL_MIRRORED_REPEAT;
+    }
+}
+
+/// Reads DXT compressed levels, keeping them compressed if the driver can
+/// use them that way
+void decodeCompressed(const RW::BSTextureNative& texNative,
+                      LevelReader& reader, DecodedTexture& texture) {
+    auto format =
+        texNative.dxttype == kDXT1 ? BlockFormat::DXT1 : BlockFormat::DXT3;
+    texture.transparent = format == BlockFormat::DXT3 || texNative.alpha != 0;
+    texture.compressed = ogl_ext_EXT_texture_compression_s3tc != 0;
+    if (texture.compressed) {
+        texture.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+        if (format == BlockFormat::DXT1) {
+            texture.internalFormat = texNative.alpha
+                                         ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+                                         : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        }
+    }
+
+    size_t width = texNative.width;
+    size_t height = texNative.height;
+    for (auto l = 0; l < std::max(1, int(texNative.nummipmaps)); ++l) {
+        auto size = blockDataSize(format, width, height);
+        auto blocks = reader.read(size);
+        if (!blocks) {
+            break;
+        }
+
+        if (texture.compressed) {
+            texture.levels.emplace_back(blocks, blocks + size);
+        } else {
+            texture.levels.emplace_back(width * height * 4);
+            decodeBlocks(format, blocks, width, height,
+                         texture.levels.back().data());
+        }
+
+        width = std::max<size_t>(1, width / 2);
+        height = std::max<size_t>(1, height / 2);
+    }
+}
+
+/// Expands each palettised level to RGBA
+void decodePalette(const RW::BSTextureNative& texNative, LevelReader& reader,
+                   const uint8_t* palette, size_t paletteSize,
+                   DecodedTexture& texture) {
+    size_t width = texNative.width;
+    size_t height = texNative.height;
+    for (auto l = 0; l < std::max(1, int(texNative.nummipmaps)); ++l) {
+        auto indices = reader.read(width * height);
+        if (!indices) {
+            break;
+        }
+
+        texture.levels.emplace_back(width * height * 4);
+        expandPalette(reinterpret_cast<const uint32_t*>(palette), paletteSize,
+                      indices, width * height,
+                      reinterpret_cast<uint32_t*>(texture.levels.back().data()));
+
+        width = std::max<size_t>(1, width / 2);
+        height = std::max<size_t>(1, height / 2);
+    }
+}
+
+/// Copies each level of a format GL can use directly
+void decodeFullColour(const RW::BSTextureNative& texNative,
+                      LevelReader& reader, DecodedTexture& texture) {
+    size_t pixelSize = 4;
+    switch (texNative.rasterformat & kRasterFormatMask) {
+        case RW::BSTextureNative::FORMAT_1555:
+            texture.format = GL_RGBA;
+            texture.type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+            pixelSize = 2;
+            break;
+        default:
+            texture.format = GL_BGRA;
+            texture.type = GL_UNSIGNED_BYTE;
+            break;
+    }
+
+    size_t width = texNative.width;
+    size_t height = texNative.height;
+    for (auto l = 0; l < std::max(1, int(texNative.nummipmaps)); ++l) {
+        auto size = width * height * pixelSize;
+        auto pixels = reader.read(size);
+        if (!pixels) {
+            break;
+        }
+
+        texture.levels.emplace_back(pixels, pixels + size);
+
+        width = std::max<size_t>(1, width / 2);
+        height = std::max<size_t>(1, height / 2);
+    }
+}
+
+/// Fills in the rest of the mip chain from the first level
+void buildMipChain(DecodedTexture& texture) {
+    size_t width = static_cast<size_t>(texture.size.x);
+    size_t height = static_cast<size_t>(texture.size.y);
+    auto count = mipLevelCount(width, height);
+    texture.levels.reserve(count);
+    for (size_t l = 1; l < count; ++l) {
+        auto outWidth = std::max<size_t>(1, width / 2);
+        auto outHeight = std::max<size_t>(1, height / 2);
+        std::vector<uint8_t> level(outWidth * outHeight * 4);
+        downsample(texture.levels.back().data(), width, height, level.data());
+        texture.levels.push_back(std::move(level));
+        width = outWidth;
+        height = outHeight;
+    }
+}
+
+void decodeTexture(const RW::BSTextureNative& texNative,
+                   RW::BinaryStreamSection& rootSection, bool buildMipmaps,
+                   DecodedTexture& texture) {
+    texture.size = {texNative.width, texNative.height};
+    texture.magFilter = filterMode(texNative);
+    texture.wrapS = wrapMode(texNative.wrapU);
+    texture.wrapT = wrapMode(texNative.wrapV);
+
     if (texNative.platform != 8) {
         RW_ERROR("Unsupported texture platform " << std::dec
                   << texNative.platform);
-        return getErrorTexture();
+        return;
     }
 
+    const auto rasterFormat = texNative.rasterformat & kRasterFormatMask;
     bool isPal8 =
         (texNative.rasterformat & RW::BSTextureNative::FORMAT_EXT_PAL8) ==
         RW::BSTextureNative::FORMAT_EXT_PAL8;
-    bool isFulc = texNative.rasterformat == RW::BSTextureNative::FORMAT_1555 ||
-                  texNative.rasterformat == RW::BSTextureNative::FORMAT_8888 ||
-                  texNative.rasterformat == RW::BSTextureNative::FORMAT_888;
-    // Export this value
-    bool transparent =
+    bool isPal4 =
+        (texNative.rasterformat & RW::BSTextureNative::FORMAT_EXT_PAL4) ==
+        RW::BSTextureNative::FORMAT_EXT_PAL4;
+    bool isFulc = rasterFormat == RW::BSTextureNative::FORMAT_1555 ||
+                  rasterFormat == RW::BSTextureNative::FORMAT_8888 ||
+                  rasterFormat == RW::BSTextureNative::FORMAT_888;
+    // D3D8 rasters record their DXT compression separately from the format
+    bool isDXT = texNative.dxttype == kDXT1 || texNative.dxttype == kDXT3;
+    texture.transparent =
         !((texNative.rasterformat & RW::BSTextureNative::FORMAT_888) ==
           RW::BSTextureNative::FORMAT_888);
 
-    if (!(isPal8 || isFulc)) {
+    // The palette and levels follow the struct, in place of its datasize
+    auto structSize = rootSection.structure ? rootSection.structure->size : 0u;
+    auto data = reinterpret_cast<const uint8_t*>(
+        rootSection.raw() + sizeof(RW::BSSectionHeader) +
+        sizeof(RW::BSTextureNative) - sizeof(uint32_t));
+    auto end = reinterpret_cast<const uint8_t*>(
+        rootSection.raw() + sizeof(RW::BSSectionHeader) + structSize);
+    LevelReader reader(data, end);
+
+    if (isDXT) {
+        decodeCompressed(texNative, reader, texture);
+    } else if (isPal8 || isPal4) {
+        // D3D stores both palette sizes with a byte per index
+        size_t paletteSize = isPal8 ? 256 : 16;
+        auto paletteBytes = paletteSize * sizeof(uint32_t);
+        if (data + paletteBytes > end) {
+            RW_ERROR("Truncated palette in " << texNative.diffuseName);
+            return;
+        }
+        reader.skip(paletteBytes);
+        decodePalette(texNative, reader, data, paletteSize, texture);
+    } else if (isFulc) {
+        decodeFullColour(texNative, reader, texture);
+    } else {
         RW_ERROR("Unsupported raster format " << std::dec
                   << texNative.rasterformat);
-        return getErrorTexture();
+        return;
     }
 
-    GLuint textureName = 0;
-
-    if (isPal8) {
-        std::vector<uint32_t> fullColor(texNative.width * texNative.height);
-
-        processPalette(fullColor.data(), rootSection);
+    if (texture.levels.empty()) {
+        RW_ERROR("Truncated texture " << texNative.diffuseName);
+        return;
+    }
 
-        glGenTextures(1, &textureName);
-        glBindTexture(GL_TEXTURE_2D, textureName);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texNative.width,
-                     texNative.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                     fullColor.data());
-    } else if (isFulc) {
-        auto coldata = rootSection.raw() + sizeof(RW::BSTextureNative);
-        coldata += sizeof(uint32_t);
-
-        GLenum type = GL_UNSIGNED_BYTE, format = GL_RGBA;
-        switch (texNative.rasterformat) {
-            case RW::BSTextureNative::FORMAT_1555:
-                format = GL_RGBA;
-                type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
-                break;
-            case RW::BSTextureNative::FORMAT_8888:
-                format = GL_BGRA;
-                // type = GL_UNSIGNED_INT_8_8_8_8_REV;
-                coldata += 8;
-                type = GL_UNSIGNED_BYTE;
-                break;
-            case RW::BSTextureNative::FORMAT_888:
-                format = GL_BGRA;
-                type = GL_UNSIGNED_BYTE;
-                break;
-            default:
-                break;
-        }
+    // Only 32-bit pixels can be filtered here, the rest is left to GL
+    bool filterable = !texture.compressed &&
+                      texture.type == GL_UNSIGNED_BYTE;
+    if (buildMipmaps && filterable && texture.levels.size() == 1) {
+        buildMipChain(texture);
+    }
+}
 
-        glGenTextures(1, &textureName);
-        glBindTexture(GL_TEXTURE_2D, textureName);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texNative.width,
-                     texNative.height, 0, format, type, coldata);
-    } else {
+TextureData::Handle uploadTexture(const DecodedTexture& texture) {
+    if (texture.levels.empty()) {
         return getErrorTexture();
     }
 
-    GLenum texFilter = GL_LINEAR;
-    switch (texNative.filterflags & 0xFF) {
-        default:
-        case RW::BSTextureNative::FILTER_LINEAR:
-            texFilter = GL_LINEAR;
-            break;
-        case RW::BSTextureNative::FILTER_NEAREST:
-            texFilter = GL_NEAREST;
-            break;
+    GLuint textureName = 0;
+    glGenTextures(1, &textureName);
+    glBindTexture(GL_TEXTURE_2D, textureName);
+
+    // Rows of the smaller 16-bit levels aren't 4 byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    size_t memorySize = 0;
+    GLsizei width = texture.size.x;
+    GLsizei height = texture.size.y;
+    GLint level = 0;
+    for (const auto& data : texture.levels) {
+        memorySize += data.size();
+        if (texture.compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level,
+                                   texture.internalFormat, width, height, 0,
+                                   static_cast<GLsizei>(data.size()),
+                                   data.data());
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, level, texture.internalFormat, width,
+                         height, 0, texture.format, texture.type,
+                         data.data());
+        }
+        level++;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
     }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
                     GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.magFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture.wrapT);
 
-    GLenum texwrap = GL_REPEAT;
-    switch (texNative.wrapU) {
-        default:
-        case RW::BSTextureNative::WRAP_WRAP:
-            texwrap = GL_REPEAT;
-            break;
-        case RW::BSTextureNative::WRAP_CLAMP:
-            texwrap = GL_CLAMP_TO_EDGE;
-            break;
-        case RW::BSTextureNative::WRAP_MIRROR:
-            texwrap = GL_MIRRORED_REPEAT;
-            break;
-    }
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texwrap);
-
-    switch (texNative.wrapV) {
-        default:
-        case RW::BSTextureNative::WRAP_WRAP:
-            texwrap = GL_REPEAT;
-            break;
-        case RW::BSTextureNative::WRAP_CLAMP:
-            texwrap = GL_CLAMP_TO_EDGE;
-            break;
-        case RW::BSTextureNative::WRAP_MIRROR:
-            texwrap = GL_MIRRORED_REPEAT;
-            break;
+    if (level > 1 || texture.compressed) {
+        // Use the levels from the file, or built while parsing. GL can't
+        // generate levels for compressed formats, a compressed texture with
+        // a single level stays complete by not sampling past it.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level - 1);
+    } else {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        // The generated levels add a third
+        memorySize = memorySize * 4 / 3;
     }
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texwrap);
 
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    return TextureData::create(textureName, {texNative.width, texNative.height},
-                               transparent);
+    return TextureData::create(textureName, texture.size,
+                               texture.transparent, memorySize);
 }
+}  // namespace
 
 bool TextureLoader::loadFromMemory(const FileContentsInfo& file,
-                                   TextureArchive& inTextures) {
+                                   TextureArchive& inTextures) const {
+    upload(parse(file), inTextures);
+    return true;
+}
+
+std::vector<DecodedTexture> TextureLoader::parse(
+    const FileContentsInfo& file) const {
+    std::vector<DecodedTexture> textures;
     auto data = file.data.get();
     RW::BinaryStreamSection root(data);
     /*auto texDict =*/root.readStructure<RW::BSTextureDictionary>();
@@ -191,10 +368,18 @@ bool TextureLoader::loadFromMemory(const FileContentsInfo& file,
         std::transform(name.begin(), name.end(), name.begin(), ::tolower);
         std::transform(alpha.begin(), alpha.end(), alpha.begin(), ::tolower);
 
-        auto texture = createTexture(texNative, rootSection);
-
-        inTextures[name] = texture;
+        textures.emplace_back();
+        textures.back().name = name;
+        decodeTexture(texNative, rootSection, buildMipmaps, textures.back());
     }
 
-    return true;
+    return textures;
+}
+
+void TextureLoader::upload(std::vector<DecodedTexture>&& textures,
+                           TextureArchive& inTextures) const {
+    for (auto& texture : textures) {
+        inTextures[texture.name] = uploadTexture(texture);
+    }
+    textures.clear();
 }
@@ -4,9 +4,73 @@
 #include <gl/TextureData.hpp>
 #include <rw/forward.hpp>
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief CPU side copy of a texture, as read from a TXD file.
+ *
+ * Holds the pixels of each mip level in the form they are given to GL, so
+ * that textures can be decoded on any thread and uploaded later.
+ */
+struct DecodedTexture {
+    std::string name;
+    glm::ivec2 size{};
+    bool transparent = false;
+
+    /// Levels hold compressed blocks of internalFormat instead of pixels
+    bool compressed = false;
+    GLenum internalFormat = GL_RGBA;
+    GLenum format = GL_RGBA;
+    GLenum type = GL_UNSIGNED_BYTE;
+
+    /// Data for each mip level from the largest, the remaining levels are
+    /// generated by GL if there is only one. Empty if decoding failed
+    std::vector<std::vector<uint8_t>> levels;
+
+    GLenum magFilter = GL_LINEAR;
+    GLenum wrapS = GL_REPEAT;
+    GLenum wrapT = GL_REPEAT;
+};
+
 class TextureLoader {
 public:
-    bool loadFromMemory(const FileContentsInfo& file, TextureArchive& inTextures);
+    /**
+     * @brief Parses and uploads a texture dictionary, must be called on the
+     * GL thread
+     */
+    bool loadFromMemory(const FileContentsInfo& file,
+                        TextureArchive& inTextures) const;
+
+    /**
+     * @brief Decodes a texture dictionary into CPU memory, safe to call from
+     * any thread
+     */
+    std::vector<DecodedTexture> parse(const FileContentsInfo& file) const;
+
+    /**
+     * @brief Creates GL textures for decoded textures, failed textures are
+     * replaced with the error texture
+     */
+    void upload(std::vector<DecodedTexture>&& textures,
+                TextureArchive& inTextures) const;
+
+    /**
+     * @brief setBuildMipmaps Builds the mip chain of textures that don't
+     * store one while parsing, rather than leaving it to the driver when
+     * uploading. Moves that work onto whichever thread is parsing.
+     */
+    void setBuildMipmaps(bool build) {
+        buildMipmaps = build;
+    }
+
+    bool getBuildMipmaps() const {
+        return buildMipmaps;
+    }
+
+private:
+    bool buildMipmaps = false;
 };
 
 #endif
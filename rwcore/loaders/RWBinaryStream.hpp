@@ -35,8 +35,10 @@ public:
      * Moves the stream to the next chunk and returns it's ID
      */
     ChunkID getNextChunk() {
-        // Check that there's any data left
-        if ((_dataCur - _data) >= _size) return 0;
+        // Check that there's a whole chunk header left, so that the end of a
+        // stream doesn't read into whatever follows it
+        constexpr std::ptrdiff_t headerSize = sizeof(std::uint32_t) * 3;
+        if ((_nextChunk - _data) + headerSize > _size) return 0;
 
         // _nextChunk is initally = to _data, making this a non-op
         _dataCur = _nextChunk;
@@ -0,0 +1,204 @@
+#include "loaders/TextureDecoder.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include <rw/debug.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RW_TEXTURE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+constexpr size_t kBlockSize = 4;
+
+using BlockColours = std::array<std::array<uint8_t, 4>, 4>;
+
+uint16_t readU16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) |
+           (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+std::array<uint8_t, 4> expand565(uint16_t colour) {
+    auto r = (colour >> 11) & 0x1F;
+    auto g = (colour >> 5) & 0x3F;
+    auto b = colour & 0x1F;
+    return {{static_cast<uint8_t>((r << 3) | (r >> 2)),
+             static_cast<uint8_t>((g << 2) | (g >> 4)),
+             static_cast<uint8_t>((b << 3) | (b >> 2)), 255}};
+}
+
+uint8_t mix(uint8_t a, uint8_t b, int weightA, int weightB) {
+    return static_cast<uint8_t>((a * weightA + b * weightB) /
+                                (weightA + weightB));
+}
+
+/// Works out the four colours of a colour block. DXT1 blocks with the first
+/// colour no greater than the second have three colours and transparency.
+BlockColours colourTable(const uint8_t* block, bool allowTransparent) {
+    auto c0 = readU16(block);
+    auto c1 = readU16(block + 2);
+
+    BlockColours colours;
+    colours[0] = expand565(c0);
+    colours[1] = expand565(c1);
+    if (c0 > c1 || !allowTransparent) {
+        for (size_t i = 0; i < 3; ++i) {
+            colours[2][i] = mix(colours[0][i], colours[1][i], 2, 1);
+            colours[3][i] = mix(colours[0][i], colours[1][i], 1, 2);
+        }
+        colours[2][3] = colours[3][3] = 255;
+    } else {
+        for (size_t i = 0; i < 3; ++i) {
+            colours[2][i] = mix(colours[0][i], colours[1][i], 1, 1);
+        }
+        colours[2][3] = 255;
+        colours[3] = {{0, 0, 0, 0}};
+    }
+    return colours;
+}
+}  // namespace
+
+size_t blockDataSize(BlockFormat format, size_t width, size_t height) {
+    auto blocks = ((width + kBlockSize - 1) / kBlockSize) *
+                  ((height + kBlockSize - 1) / kBlockSize);
+    return blocks * (format == BlockFormat::DXT1 ? 8 : 16);
+}
+
+void decodeBlocks(BlockFormat format, const uint8_t* blocks, size_t width,
+                  size_t height, uint8_t* rgba) {
+    const bool hasAlphaBlock = format == BlockFormat::DXT3;
+
+    for (size_t by = 0; by < height; by += kBlockSize) {
+        for (size_t bx = 0; bx < width; bx += kBlockSize) {
+            const uint8_t* alpha = nullptr;
+            if (hasAlphaBlock) {
+                alpha = blocks;
+                blocks += 8;
+            }
+            auto colours = colourTable(blocks, !hasAlphaBlock);
+            auto indices = readU32(blocks + 4);
+            blocks += 8;
+
+            auto rows = std::min(kBlockSize, height - by);
+            auto columns = std::min(kBlockSize, width - bx);
+            for (size_t y = 0; y < rows; ++y) {
+                for (size_t x = 0; x < columns; ++x) {
+                    auto texel = y * kBlockSize + x;
+                    auto pixel = rgba + ((by + y) * width + bx + x) * 4;
+                    const auto& colour = colours[(indices >> (texel * 2)) & 3];
+                    std::copy(colour.begin(), colour.end(), pixel);
+                    if (alpha) {
+                        // 4 bits per texel, expanded to 8
+                        auto a = (alpha[texel / 2] >> ((texel % 2) * 4)) & 0xF;
+                        pixel[3] = static_cast<uint8_t>(a * 17);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void expandPalette(const uint32_t* palette, size_t paletteSize,
+                   const uint8_t* indices, size_t count, uint32_t* rgba) {
+    RW_ASSERT(paletteSize == 16 || paletteSize == 256);
+    const auto mask = static_cast<uint8_t>(paletteSize - 1);
+    size_t i = 0;
+#if defined(__AVX2__)
+    // Eight pixels at a time, the indices widened and gathered from the
+    // palette in one instruction
+    for (; i + 8 <= count; i += 8) {
+        auto packed = _mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(indices + i));
+        auto offsets = _mm256_and_si256(_mm256_cvtepu8_epi32(packed),
+                                        _mm256_set1_epi32(mask));
+        auto pixels = _mm256_i32gather_epi32(
+            reinterpret_cast<const int*>(palette), offsets, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i), pixels);
+    }
+#else
+    // Without a gather the loads are independent, unrolling lets them overlap
+    for (; i + 4 <= count; i += 4) {
+        auto a = palette[indices[i + 0] & mask];
+        auto b = palette[indices[i + 1] & mask];
+        auto c = palette[indices[i + 2] & mask];
+        auto d = palette[indices[i + 3] & mask];
+        rgba[i + 0] = a;
+        rgba[i + 1] = b;
+        rgba[i + 2] = c;
+        rgba[i + 3] = d;
+    }
+#endif
+    for (; i < count; ++i) {
+        rgba[i] = palette[indices[i] & mask];
+    }
+}
+
+size_t mipLevelCount(size_t width, size_t height) {
+    size_t levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max<size_t>(1, width / 2);
+        height = std::max<size_t>(1, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+void downsample(const uint8_t* rgba, size_t width, size_t height,
+                uint8_t* out) {
+    const auto outWidth = std::max<size_t>(1, width / 2);
+    const auto outHeight = std::max<size_t>(1, height / 2);
+    const auto stride = width * 4;
+
+    for (size_t y = 0; y < outHeight; ++y) {
+        // Odd sizes drop the last row or column, 1 pixel sizes repeat it
+        const auto row0 = rgba + std::min(y * 2, height - 1) * stride;
+        const auto row1 = rgba + std::min(y * 2 + 1, height - 1) * stride;
+        auto dst = out + y * outWidth * 4;
+
+        size_t x = 0;
+#if defined(RW_TEXTURE_SSE)
+        if (width > 1) {
+            // Two output pixels from each 16 bytes of both rows
+            const auto zero = _mm_setzero_si128();
+            const auto round = _mm_set1_epi16(2);
+            for (; x + 2 <= outWidth; x += 2) {
+                auto a = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(row0 + x * 8));
+                auto b = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(row1 + x * 8));
+                auto lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+                                        _mm_unpacklo_epi8(b, zero));
+                auto hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+                                        _mm_unpackhi_epi8(b, zero));
+                lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+                auto sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round);
+                auto pixels = _mm_packus_epi16(_mm_srli_epi16(sum, 2), zero);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4),
+                                 pixels);
+            }
+        }
+#endif
+        for (; x < outWidth; ++x) {
+            const auto x0 = std::min(x * 2, width - 1) * 4;
+            const auto x1 = std::min(x * 2 + 1, width - 1) * 4;
+            for (size_t c = 0; c < 4; ++c) {
+                auto sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] +
+                           row1[x1 + c] + 2;
+                dst[x * 4 + c] = static_cast<uint8_t>(sum / 4);
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef _LIBRW_TEXTUREDECODER_HPP_
+#define _LIBRW_TEXTUREDECODER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Block compressed texture formats stored in TXD files
+ */
+enum class BlockFormat { DXT1, DXT3 };
+
+/**
+ * @brief blockDataSize Bytes of block data for an image
+ *
+ * Images are stored as 4x4 pixel blocks, partial blocks at the edges are
+ * stored whole.
+ */
+size_t blockDataSize(BlockFormat format, size_t width, size_t height);
+
+/**
+ * @brief decodeBlocks Expands block compressed data to RGBA8 pixels
+ *
+ * For drivers without S3TC support.
+ *
+ * @param blocks blockDataSize() bytes of block data
+ * @param rgba Receives width * height pixels, 4 bytes each
+ */
+void decodeBlocks(BlockFormat format, const uint8_t* blocks, size_t width,
+                  size_t height, uint8_t* rgba);
+
+/**
+ * @brief expandPalette Looks up count palette indices, writing RGBA8 pixels
+ *
+ * Indices only keep as many low bits as address the palette, so that bad
+ * indices can't read past it.
+ *
+ * @param paletteSize Entries in the palette, 256 for PAL8 and 16 for PAL4
+ * rasters
+ */
+void expandPalette(const uint32_t* palette, size_t paletteSize,
+                   const uint8_t* indices, size_t count, uint32_t* rgba);
+
+/**
+ * @brief mipLevelCount Levels in a full mip chain, down to 1x1
+ */
+size_t mipLevelCount(size_t width, size_t height);
+
+/**
+ * @brief downsample Box filters RGBA8 pixels into the next mip level, of
+ * max(1, width / 2) by max(1, height / 2) pixels
+ */
+void downsample(const uint8_t* rgba, size_t width, size_t height,
+                uint8_t* out);
+
+#endif
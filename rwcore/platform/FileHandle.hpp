@@ -6,13 +6,25 @@
 
 /**
  * @brief Contains a pointer to a file's contents.
+ *
+ * The contents are either owned by this object, or are a non-owning view
+ * into a larger buffer (e.g. a memory mapped archive) that is kept alive
+ * for as long as the view exists.
  */
 struct FileContentsInfo {
-    std::unique_ptr<char[]> data;
+    std::shared_ptr<char> data;
     size_t length;
 
     FileContentsInfo(std::unique_ptr<char[]> mem, size_t len)
-        : data(std::move(mem)), length(len) {
+        : data(mem.release(), std::default_delete<char[]>()), length(len) {
+    }
+
+    /**
+     * @brief Constructs a view of len bytes at view, owned by owner
+     */
+    template <class T>
+    FileContentsInfo(const std::shared_ptr<T>& owner, char* view, size_t len)
+        : data(owner, view), length(len) {
     }
 
     FileContentsInfo(FileContentsInfo&& info)
@@ -34,10 +34,10 @@ void FileIndex::indexTree(const rwfs::path &path) {
         }
         auto relPath = path.lexically_relative(basePath);
         std::string relPathName = normalizeFilePath(relPath.string());
-        indexedData_[relPathName] = {IndexedDataType::FILE, path.string(), ""};
+        indexedData_[relPathName] = {IndexedDataType::FILE, path.string(), 0};
 
         auto filename = normalizeFilePath(path.filename().string());
-        indexedData_[filename] = {IndexedDataType::FILE, path.string(), ""};
+        indexedData_[filename] = {IndexedDataType::FILE, path.string(), 0};
     }
 }
 
@@ -80,6 +80,9 @@ void FileIndex::indexArchive(const std::string &archive) {
         throw std::runtime_error("Failed to load IMG archive: " + path.string());
     }
 
+    // Falls back to reading from the file if the archive can't be mapped
+    img.mapArchive();
+
     for (size_t i = 0; i < img.getAssetCount(); ++i) {
         auto &asset = img.getAssetInfoByIndex(i);
 
@@ -87,8 +90,10 @@ void FileIndex::indexArchive(const std::string &archive) {
 
         std::string assetName = normalizeFilePath(asset.name);
 
-        indexedData_[assetName] = {IndexedDataType::ARCHIVE, path.string(), asset.name};
+        indexedData_[assetName] = {IndexedDataType::ARCHIVE, path.string(), i};
     }
+
+    archives_[path.string()] = std::move(img);
 }
 
 FileContentsInfo FileIndex::openFile(const std::string &filePath) {
@@ -101,34 +106,25 @@ FileContentsInfo FileIndex::openFile(const std::string &filePath) {
 
     const auto &indexedData = indexedDataPos->second;
 
-    std::unique_ptr<char[]> data = nullptr;
-    size_t length = 0;
-
     if (indexedData.type == IndexedDataType::ARCHIVE) {
-        LoaderIMG img;
-
-        if (!img.load(indexedData.path)) {
-            throw std::runtime_error("Failed to load IMG archive: " + indexedData.path);
+        auto archive = archives_.find(indexedData.path);
+        if (archive == archives_.end()) {
+            throw std::runtime_error("IMG archive not indexed: " + indexedData.path);
         }
 
-        LoaderIMGFile file;
-        auto filename = rwfs::path(indexedData.assetData).filename().string();
-        if (img.findAssetInfo(filename, file)) {
-            length = file.size * 2048;
-            data = img.loadToMemory(filename);
-        }
-    } else {
-        std::ifstream dfile(indexedData.path, std::ios::binary);
-        if (!dfile.is_open()) {
-            throw std::runtime_error("Unable to open file: " + indexedData.path);
-        }
+        return archive->second.loadAsset(indexedData.assetIndex);
+    }
 
-        dfile.seekg(0, std::ios::end);
-        length = dfile.tellg();
-        dfile.seekg(0);
-        data = std::make_unique<char[]>(length);
-        dfile.read(data.get(), length);
+    std::ifstream dfile(indexedData.path, std::ios::binary);
+    if (!dfile.is_open()) {
+        throw std::runtime_error("Unable to open file: " + indexedData.path);
     }
 
+    dfile.seekg(0, std::ios::end);
+    size_t length = dfile.tellg();
+    dfile.seekg(0);
+    auto data = std::make_unique<char[]>(length);
+    dfile.read(data.get(), length);
+
     return {std::move(data), length};
 }
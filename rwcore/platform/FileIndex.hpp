@@ -1,6 +1,7 @@
 #ifndef _LIBRW_FILEINDEX_HPP_
 #define _LIBRW_FILEINDEX_HPP_
 
+#include "loaders/LoaderIMG.hpp"
 #include "rw/filesystem.hpp"
 #include "rw/forward.hpp"
 
@@ -42,7 +43,8 @@ public:
 
     /**
      * Adds the files contained within the given Archive file to the
-     * file index.
+     * file index. The archive is memory mapped once, files opened from it
+     * are views into the mapping.
      * @param filePath path to the archive
      * @throws if this FileIndex has not indexed the archive itself
      */
@@ -75,8 +77,8 @@ private:
         IndexedDataType type;
         /// Path of indexed data.
         std::string path;
-        /// Extra data of assets (FIXME: use c++17 std::variant or std::option)
-        std::string assetData;
+        /// Index of the entry within the archive, for ARCHIVE data
+        size_t assetIndex;
     };
 
     /**
@@ -84,6 +86,11 @@ private:
      */
     std::unordered_map<std::string, IndexedData> indexedData_;
 
+    /**
+     * @brief archives_ Indexed archives, by their path on disk.
+     */
+    std::unordered_map<std::string, LoaderIMG> archives_;
+
     /**
      * @brief getIndexedDataAt Get IndexedData for filePath
      * @param filePath the file path to get the IndexedData for
@@ -0,0 +1,53 @@
+#ifndef _LIBRW_MAPPEDFILE_HPP_
+#define _LIBRW_MAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Views into the mapping are shared by everything that loads from it, so
+ * the pages are mapped read-only and writing through them faults.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief open Maps the file at path into memory
+     * @param path the file to map
+     * @return true if the file was mapped
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief close Unmaps the file, invalidating all pointers into it
+     */
+    void close();
+
+    bool isOpen() const {
+        return data_ != nullptr;
+    }
+
+    const char* data() const {
+        return data_;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef RW_WINDOWS
+    void* mapping_ = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "rw/memory.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace {
+
+std::array<std::atomic<size_t>, MemoryUsage::kTagCount> counts{};
+
+std::atomic<size_t>& countOf(MemoryTag tag) {
+    return counts[static_cast<size_t>(tag)];
+}
+
+}  // namespace
+
+namespace MemoryUsage {
+
+void add(MemoryTag tag, size_t bytes) {
+    countOf(tag).fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void remove(MemoryTag tag, size_t bytes) {
+    countOf(tag).fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void set(MemoryTag tag, size_t bytes) {
+    countOf(tag).store(bytes, std::memory_order_relaxed);
+}
+
+size_t get(MemoryTag tag) {
+    return countOf(tag).load(std::memory_order_relaxed);
+}
+
+size_t total() {
+    size_t bytes = 0;
+    for (const auto& count : counts) {
+        bytes += count.load(std::memory_order_relaxed);
+    }
+    return bytes;
+}
+
+const char* getName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::Textures:
+            return "textures";
+        case MemoryTag::Geometry:
+            return "geometry";
+        case MemoryTag::Collision:
+            return "collision";
+        case MemoryTag::Animation:
+            return "animation";
+        case MemoryTag::Audio:
+            return "audio";
+        case MemoryTag::Objects:
+            return "objects";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+}  // namespace MemoryUsage
@@ -0,0 +1,110 @@
+#ifndef _LIBRW_MEMORY_HPP_
+#define _LIBRW_MEMORY_HPP_
+
+#include <cstddef>
+
+/**
+ * Subsystems that memory is accounted to
+ */
+enum class MemoryTag {
+    /// Estimated video memory of textures
+    Textures,
+    /// Vertex and index buffers of model geometry
+    Geometry,
+    /// Bullet shapes and bodies of collision instances
+    Collision,
+    /// Keyframes of loaded animations
+    Animation,
+    /// Sample data in OpenAL buffers
+    Audio,
+    /// Game objects in the world's pools
+    Objects,
+    _Count
+};
+
+/**
+ * @brief Process wide byte counts for each MemoryTag
+ *
+ * Owners report what they hold as they acquire and release it, so the
+ * totals can be read at any time without walking the data. Counts are
+ * atomic, owners may live on any thread.
+ */
+namespace MemoryUsage {
+
+constexpr size_t kTagCount = static_cast<size_t>(MemoryTag::_Count);
+
+void add(MemoryTag tag, size_t bytes);
+
+void remove(MemoryTag tag, size_t bytes);
+
+/**
+ * @brief set Replaces a tag's count, for owners that are measured
+ * periodically rather than tracked
+ */
+void set(MemoryTag tag, size_t bytes);
+
+size_t get(MemoryTag tag);
+
+/**
+ * @brief total Sums the counts of all tags
+ */
+size_t total();
+
+const char* getName(MemoryTag tag);
+
+}  // namespace MemoryUsage
+
+/**
+ * @brief Accounts a number of bytes to a tag for as long as it is alive
+ *
+ * Meant as a member of whatever owns the memory, so the count follows the
+ * owner through moves and is released when it is destroyed.
+ */
+class TrackedMemory {
+public:
+    explicit TrackedMemory(MemoryTag tag, size_t bytes = 0)
+        : tag_(tag), bytes_(bytes) {
+        MemoryUsage::add(tag_, bytes_);
+    }
+
+    ~TrackedMemory() {
+        MemoryUsage::remove(tag_, bytes_);
+    }
+
+    TrackedMemory(TrackedMemory&& other) noexcept
+        : tag_(other.tag_), bytes_(other.bytes_) {
+        other.bytes_ = 0;
+    }
+
+    TrackedMemory& operator=(TrackedMemory&& other) noexcept {
+        if (this != &other) {
+            MemoryUsage::remove(tag_, bytes_);
+            tag_ = other.tag_;
+            bytes_ = other.bytes_;
+            other.bytes_ = 0;
+        }
+        return *this;
+    }
+
+    TrackedMemory(const TrackedMemory&) = delete;
+    TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+    /**
+     * @brief resize Changes the number of bytes accounted
+     */
+    void resize(size_t bytes) {
+        MemoryUsage::remove(tag_, bytes_);
+        bytes_ = bytes;
+        MemoryUsage::add(tag_, bytes_);
+    }
+
+    size_t size() const {
+        return bytes_;
+    }
+
+private:
+    MemoryTag tag_;
+    size_t bytes_;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4305)
@@ -205,73 +206,69 @@ bool CharacterController::checkForObstacles()
     // The minimal distance we test for objects
     static constexpr float minColDist = 20.f;
 
+    // Only check objects that are near our vehicle
+    std::vector<GameObject *> nearby;
+    character->engine->spatialIndex.queryRadius(vehicle->getPosition(),
+                                                minColDist, nearby);
+
     // Try to stop before pedestrians
-    for (const auto &obj : character->engine->pedestrianPool.objects) {
+    for (const auto &obj : nearby) {
+        if (obj->type() != GameObject::Character) {
+            continue;
+        }
         // Verify that the character isn't the driver and is walking
-        if (obj.second.get() != character &&
-            static_cast<CharacterObject *>(obj.second.get())->getCurrentVehicle() ==
+        if (obj != character &&
+            static_cast<CharacterObject *>(obj)->getCurrentVehicle() ==
                 nullptr) {
-            // Only check characters that are near our vehicle
-            if (glm::distance(vehicle->getPosition(),
-                              obj.second->getPosition()) <= minColDist) {
-                // Check if the character is in front of us and in our way
-                if (vehicle->isInFront(obj.second->getPosition()) > -3.f &&
-                    vehicle->isInFront(obj.second->getPosition()) < 10.f &&
-                    glm::abs(vehicle->isOnSide(obj.second->getPosition())) <
-                        3.f) {
-                    return true;
-                }
+            // Check if the character is in front of us and in our way
+            if (vehicle->isInFront(obj->getPosition()) > -3.f &&
+                vehicle->isInFront(obj->getPosition()) < 10.f &&
+                glm::abs(vehicle->isOnSide(obj->getPosition())) < 3.f) {
+                return true;
             }
         }
     }
 
     // Brake when a car is in front of us and change lanes when possible
-    for (const auto &obj : character->engine->vehiclePool.objects) {
+    for (const auto &obj : nearby) {
+        if (obj->type() != GameObject::Vehicle) {
+            continue;
+        }
         // Verify that the vehicle isn't our vehicle
-        if (obj.second.get() != vehicle) {
-            // Only check vehicles that are near our vehicle
-            if (glm::distance(vehicle->getPosition(),
-                              obj.second->getPosition()) <= minColDist) {
-                // Check if the vehicle is in front of us and in our way
-                if (vehicle->isInFront(obj.second->getPosition()) > 0.f &&
-                    vehicle->isInFront(obj.second->getPosition()) < 10.f &&
-                    glm::abs(vehicle->isOnSide(obj.second->getPosition())) <
-                        2.5f) {
-                    // Check if the road has more than one lane
-                    // @todo we don't know the direction of the road, so for
-                    // now, choose the bigger value
-                    int maxLanes =
-                        targetNode->rightLanes > targetNode->leftLanes
-                            ? targetNode->rightLanes
-                            : targetNode->leftLanes;
-                    if (maxLanes > 1) {
-                        // Change the lane, firstly check if there is an
-                        // occupant
-                        if (static_cast<VehicleObject *>(obj.second.get())
-                                ->getDriver() != nullptr) {
-                            // @todo for now we don't know the lane where the
-                            // player is currently driving so just slow down, in
-                            // the future calculate the lane
-                            if (static_cast<VehicleObject *>(obj.second.get())
-                                    ->getDriver()
-                                    ->isPlayer()) {
-                                return true;
-                            } else {
-                                int avoidLane =
-                                    static_cast<VehicleObject *>(obj.second.get())
-                                        ->getDriver()
-                                        ->controller->getLane();
-
-                                // @todo for now just two lanes
-                                if (avoidLane == 1)
-                                    character->controller->setLane(2);
-                                else
-                                    character->controller->setLane(1);
-                            }
+        if (obj != vehicle) {
+            // Check if the vehicle is in front of us and in our way
+            if (vehicle->isInFront(obj->getPosition()) > 0.f &&
+                vehicle->isInFront(obj->getPosition()) < 10.f &&
+                glm::abs(vehicle->isOnSide(obj->getPosition())) < 2.5f) {
+                // Check if the road has more than one lane
+                // @todo we don't know the direction of the road, so for
+                // now, choose the bigger value
+                int maxLanes = targetNode->rightLanes > targetNode->leftLanes
+                                   ? targetNode->rightLanes
+                                   : targetNode->leftLanes;
+                if (maxLanes > 1) {
+                    // Change the lane, firstly check if there is an
+                    // occupant
+                    auto other = static_cast<VehicleObject *>(obj);
+                    if (other->getDriver() != nullptr) {
+                        // @todo for now we don't know the lane where the
+                        // player is currently driving so just slow down, in
+                        // the future calculate the lane
+                        if (other->getDriver()->isPlayer()) {
+                            return true;
+                        } else {
+                            int avoidLane =
+                                other->getDriver()->controller->getLane();
+
+                            // @todo for now just two lanes
+                            if (avoidLane == 1)
+                                character->controller->setLane(2);
+                            else
+                                character->controller->setLane(1);
                         }
-                    } else {
-                        return true;
                     }
+                } else {
+                    return true;
                 }
             }
         }
@@ -37,31 +37,19 @@ std::vector<AIGraphNode*> TrafficDirector::findAvailableNodes(
     graph->gatherExternalNodesNear(camera.position, radius, available, type);
 
     float density = type == AIGraphNode::Vehicle ? carDensity : pedDensity;
-    float minDist = (15.f / density) * (15.f / density);
+    float minDist = 15.f / density;
     float halfRadius2 = std::pow(radius / 2.f, 2.f);
+    std::vector<GameObject*> nearby;
 
     // Check if any of the nearby nodes are blocked by a pedestrian or vehicle standing on
     // it
     // or because it's inside the view frustum
     for (auto it = available.begin(); it != available.end();) {
-        bool blocked = false;
         float dist2 = glm::distance2(camera.position, (*it)->position);
 
-        for (const auto& obj : world->pedestrianPool.objects) {
-            if (glm::distance2((*it)->position, obj.second->getPosition()) <=
-                minDist) {
-                blocked = true;
-                break;
-            }
-        }
-
-        for (const auto& obj : world->vehiclePool.objects) {
-            if (glm::distance2((*it)->position, obj.second->getPosition()) <=
-                minDist) {
-                blocked = true;
-                break;
-            }
-        }
+        nearby.clear();
+        world->spatialIndex.queryRadius((*it)->position, minDist, nearby);
+        bool blocked = !nearby.empty();
 
         // Check that we're not going to spawn something right where the player
         // is looking
@@ -171,6 +159,9 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
             // Spawn a pedestrian from the available pool
             const auto pedId = static_cast<std::uint16_t>(
                 peds[std::uniform_int_distribution<size_t>(0, peds.size() - 1)(random)]);
+            if (!isModelStreamed(pedId)) {
+                continue;
+            }
             auto ped = world->createPedestrian(pedId, spawn->position);
             ped->applyOffset();
             ped->setLifetime(GameObject::TrafficLifetime);
@@ -238,13 +229,17 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
             // Spawn a vehicle from the available pool
             const auto carId = static_cast<std::uint16_t>(cars[std::uniform_int_distribution<std::size_t>(
                 0, cars.size() - 1)(random)]);
+            const auto pedId = peds[std::uniform_int_distribution<std::size_t>(0, peds.size() - 1)(random)];
+            if (!isModelStreamed(carId) || !isModelStreamed(pedId)) {
+                continue;
+            }
+
             auto vehicle = world->createVehicle(carId, next->position + diff + laneOffset, orientation);
             vehicle->applyOffset();
             vehicle->setLifetime(GameObject::TrafficLifetime);
             vehicle->setHandbraking(false);
 
             // Spawn a pedestrian and put it into the vehicle
-            const auto pedId = peds[std::uniform_int_distribution<std::size_t>(0, peds.size() - 1)(random)];
             CharacterObject* character = world->createPedestrian(pedId, vehicle->getPosition());
             character->setLifetime(GameObject::TrafficLifetime);
             character->setCurrentVehicle(vehicle, 0);
@@ -262,6 +257,18 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
     return created;
 }
 
+bool TrafficDirector::isModelStreamed(std::uint16_t model) {
+    auto info = world->data->modelinfo.find(model);
+    if (info == world->data->modelinfo.end()) {
+        return false;
+    }
+    if (info->second->isLoaded()) {
+        return true;
+    }
+    world->data->requestModel(model, StreamingPriority::Low);
+    return false;
+}
+
 void TrafficDirector::setPopulationLimits(int maxPeds, int maxCars) {
     maximumPedestrians = maxPeds;
     maximumCars = maxCars;
@@ -3,6 +3,7 @@
 
 #include "AIGraphNode.hpp"
 
+#include <cstdint>
 #include <vector>
 
 class AIGraph;
@@ -35,6 +36,12 @@ public:
     void setPopulationLimits(int maxPeds, int maxCars);
 
 private:
+    /**
+     * Returns true if the model is loaded, otherwise requests it so traffic
+     * can use it once it has been streamed in.
+     */
+    bool isModelStreamed(std::uint16_t model);
+
     AIGraph* graph = nullptr;
     GameWorld* world = nullptr;
     float pedDensity = 1.f;
@@ -21,13 +21,14 @@ SoundBuffer::~SoundBuffer() {
 }
 
 bool SoundBuffer::bufferData(SoundSource& soundSource) {
+    const auto size = soundSource.data.size() * sizeof(int16_t);
     alCheck(alBufferData(
         buffer,
         soundSource.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16,
-        &soundSource.data.front(),
-        static_cast<ALsizei>(soundSource.data.size() * sizeof(int16_t)),
+        &soundSource.data.front(), static_cast<ALsizei>(size),
         soundSource.sampleRate));
     alCheck(alSourcei(source, AL_BUFFER, buffer));
+    memory.resize(size);
 
     return true;
 }
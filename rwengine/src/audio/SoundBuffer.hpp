@@ -5,6 +5,8 @@
 #include <alc.h>
 #include <glm/glm.hpp>
 
+#include <rw/memory.hpp>
+
 #include "audio/SoundSource.hpp"
 
 /// OpenAL tool for playing
@@ -30,6 +32,9 @@ struct SoundBuffer {
 
     ALuint source;
     ALuint buffer;
+
+    /// Size of the samples held by the buffer
+    TrackedMemory memory{MemoryTag::Audio};
 };
 
 #endif
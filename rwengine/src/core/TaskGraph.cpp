@@ -0,0 +1,113 @@
+#include "core/TaskGraph.hpp"
+
+#include <thread>
+#include <utility>
+
+#include <rw/debug.hpp>
+
+#include "core/Profiler.hpp"
+
+TaskGraph::TaskID TaskGraph::add(Task&& task,
+                                 std::initializer_list<TaskID> dependencies,
+                                 Affinity affinity) {
+    TaskID id = tasks_.size();
+    tasks_.push_back({std::move(task), affinity, 0, {}});
+    for (auto dependency : dependencies) {
+        RW_ASSERT(dependency < id);
+        tasks_[dependency].dependents.push_back(id);
+        tasks_[id].waitingOn++;
+    }
+    return id;
+}
+
+void TaskGraph::run(unsigned int workers) {
+    queue_.clear();
+    mainQueue_.clear();
+    completed_ = 0;
+    error_ = nullptr;
+
+    for (TaskID id = 0; id < tasks_.size(); ++id) {
+        if (tasks_[id].waitingOn == 0) {
+            auto& queue = tasks_[id].affinity == Affinity::MainThread
+                              ? mainQueue_
+                              : queue_;
+            queue.push_back(id);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (unsigned int i = 0; i < workers; ++i) {
+        threads.emplace_back([this]() {
+            RW_PROFILE_THREAD("TaskGraph");
+            work(false);
+        });
+    }
+
+    work(true);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    tasks_.clear();
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void TaskGraph::work(bool mainThread) {
+    for (;;) {
+        TaskID id;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [&]() {
+                return completed_ == tasks_.size() || !queue_.empty() ||
+                       (mainThread && !mainQueue_.empty());
+            });
+            if (completed_ == tasks_.size()) {
+                return;
+            }
+            // The main thread gives priority to the tasks only it can run
+            auto& queue =
+                mainThread && !mainQueue_.empty() ? mainQueue_ : queue_;
+            id = queue.front();
+            queue.pop_front();
+            if (error_) {
+                // Drain the graph without running anything else
+                lock.unlock();
+                complete(id);
+                continue;
+            }
+        }
+
+        try {
+            tasks_[id].task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+
+        complete(id);
+    }
+}
+
+void TaskGraph::complete(TaskID id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto dependent : tasks_[id].dependents) {
+            auto& node = tasks_[dependent];
+            if (--node.waitingOn == 0) {
+                auto& queue = node.affinity == Affinity::MainThread
+                                  ? mainQueue_
+                                  : queue_;
+                queue.push_back(dependent);
+            }
+        }
+        completed_++;
+    }
+    ready_.notify_all();
+}
@@ -0,0 +1,82 @@
+#ifndef _RWENGINE_TASKGRAPH_HPP_
+#define _RWENGINE_TASKGRAPH_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Runs a set of tasks with dependencies between them.
+ *
+ * Tasks without dependencies between them may run concurrently on a pool of
+ * worker threads. Tasks that must run on the thread that owns the GL context,
+ * or that touch shared state, are added with MainThread affinity; these are
+ * always run on the thread that called run(), one at a time.
+ */
+class TaskGraph {
+public:
+    using TaskID = size_t;
+    using Task = std::function<void()>;
+
+    enum class Affinity {
+        /// The task can run on any thread
+        Any,
+        /// The task must run on the thread calling run()
+        MainThread,
+    };
+
+    /**
+     * @brief add Adds a task to the graph
+     * @param task The work to do
+     * @param dependencies Tasks that must complete before this one starts,
+     * these must already have been added
+     * @param affinity Which threads may run the task
+     * @return The ID of the task, for use as a dependency
+     */
+    TaskID add(Task&& task, std::initializer_list<TaskID> dependencies = {},
+               Affinity affinity = Affinity::Any);
+
+    /**
+     * @brief run Runs all the tasks in the graph, returning once they are done
+     * @param workers The number of worker threads to start, if zero all tasks
+     * are run on the calling thread
+     *
+     * If a task throws, no further tasks are started and the exception is
+     * rethrown once the running tasks have finished.
+     */
+    void run(unsigned int workers);
+
+    size_t getTaskCount() const {
+        return tasks_.size();
+    }
+
+private:
+    struct Node {
+        Task task;
+        Affinity affinity;
+        size_t waitingOn;
+        std::vector<TaskID> dependents;
+    };
+
+    /// Runs tasks until the graph is complete
+    void work(bool mainThread);
+
+    /// Marks a task as complete and queues any tasks that were waiting on it
+    void complete(TaskID id);
+
+    std::vector<Node> tasks_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<TaskID> queue_;
+    std::deque<TaskID> mainQueue_;
+    size_t completed_ = 0;
+    std::exception_ptr error_;
+};
+
+#endif
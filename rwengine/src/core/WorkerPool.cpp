@@ -0,0 +1,89 @@
+#include "core/WorkerPool.hpp"
+
+#include "core/Profiler.hpp"
+
+WorkerPool::WorkerPool(unsigned int workers) {
+    workers_.reserve(workers);
+    for (unsigned int i = 0; i < workers; ++i) {
+        workers_.emplace_back([this]() {
+            RW_PROFILE_THREAD("WorkerPool");
+            work();
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    started_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkerPool::run(size_t count, const Job& job) {
+    if (count == 0) {
+        return;
+    }
+
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        count_ = count;
+        next_ = 0;
+        run_++;
+    }
+    started_.notify_all();
+
+    runJobs(job, count);
+
+    // Every index has been taken, wait for the workers running the last ones
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [&]() { return active_ == 0; });
+    job_ = nullptr;
+}
+
+void WorkerPool::work() {
+    uint64_t lastRun = 0;
+    for (;;) {
+        const Job* job;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // A worker that wakes after a run has finished waits for the next
+            started_.wait(lock, [&]() {
+                return stopping_ || (job_ != nullptr && run_ != lastRun);
+            });
+            if (stopping_) {
+                return;
+            }
+            lastRun = run_;
+            job = job_;
+            count = count_;
+            active_++;
+        }
+
+        runJobs(*job, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_--;
+        }
+        finished_.notify_one();
+    }
+}
+
+void WorkerPool::runJobs(const Job& job, size_t count) {
+    for (size_t i; (i = next_.fetch_add(1)) < count;) {
+        job(i);
+    }
+}
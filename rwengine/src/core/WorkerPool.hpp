@@ -0,0 +1,72 @@
+#ifndef _RWENGINE_WORKERPOOL_HPP_
+#define _RWENGINE_WORKERPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A set of threads kept alive for running short parallel loops.
+ *
+ * Unlike TaskGraph, which starts its threads for each run, the threads are
+ * started once, so the pool can be used every frame.
+ */
+class WorkerPool {
+public:
+    using Job = std::function<void(size_t index)>;
+
+    /**
+     * @param workers The number of threads to start, if zero all jobs are
+     * run on the calling thread
+     */
+    explicit WorkerPool(unsigned int workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @return The number of threads that run jobs, including the caller
+     */
+    size_t getThreadCount() const {
+        return workers_.size() + 1;
+    }
+
+    /**
+     * @brief run Calls job for each index below count, returning once all
+     * of them have finished
+     *
+     * The calling thread runs jobs too. Indices are handed out in order, but
+     * the order the jobs finish in is unspecified. Jobs must not throw.
+     */
+    void run(size_t count, const Job& job);
+
+private:
+    void work();
+
+    /// Runs jobs until there are no indices left
+    void runJobs(const Job& job, size_t count);
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable started_;
+    std::condition_variable finished_;
+    bool stopping_ = false;
+
+    /// The current job, null between runs
+    const Job* job_ = nullptr;
+    size_t count_ = 0;
+    uint64_t run_ = 0;
+    /// Workers that have joined the current run
+    size_t active_ = 0;
+
+    std::atomic<size_t> next_{0};
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef _RWENGINE_MODELDATA_HPP_
 #define _RWENGINE_MODELDATA_HPP_
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
@@ -76,6 +77,20 @@ public:
         return refcount_;
     }
 
+    /**
+     * @brief markUsed Records that the model was drawn, or wanted to be.
+     * Safe to call from the render workers
+     */
+    void markUsed(uint32_t frame) {
+        if (lastused_.load(std::memory_order_relaxed) != frame) {
+            lastused_.store(frame, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t getLastUsedFrame() const {
+        return lastused_.load(std::memory_order_relaxed);
+    }
+
     void setCollisionModel(std::unique_ptr<CollisionModel>& col) {
         collision = std::move(col);
     }
@@ -109,6 +124,7 @@ private:
     ModelID modelid_ = 0;
     ModelDataType type_;
     int refcount_ = 0;
+    std::atomic<uint32_t> lastused_{0};
     std::unique_ptr<CollisionModel> collision;
 };
 
@@ -200,6 +216,9 @@ public:
 
     void unload() override {
         model_ = nullptr;
+        for (auto& atomic : atomics_) {
+            atomic = nullptr;
+        }
     }
 
     enum {
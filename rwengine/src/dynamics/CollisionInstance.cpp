@@ -69,6 +69,9 @@ bool CollisionInstance::createPhysicsBody(GameObject* object,
     btTransform t;
     t.setIdentity();
 
+    size_t memorySize = sizeof(btCompoundShape) + sizeof(btRigidBody) +
+                        sizeof(GameObjectMotionState);
+
     // Boxes
     for (const auto &box : collision->boxes) {
         auto size = (box.max - box.min) / 2.f;
@@ -81,6 +84,7 @@ bool CollisionInstance::createPhysicsBody(GameObject* object,
         colMin = std::min(colMin, mid.z - size.z);
         colMax = std::max(colMax, mid.z + size.z);
 
+        memorySize += sizeof(btBoxShape);
         m_shapes.push_back(std::move(bshape));
     }
 
@@ -94,6 +98,7 @@ bool CollisionInstance::createPhysicsBody(GameObject* object,
         colMin = std::min(colMin, sphere.center.z - sphere.radius);
         colMax = std::max(colMax, sphere.center.z + sphere.radius);
 
+        memorySize += sizeof(btSphereShape);
         m_shapes.push_back(std::move(sshape));
     }
 
@@ -113,10 +118,16 @@ bool CollisionInstance::createPhysicsBody(GameObject* object,
         trishape->setMargin(0.05f);
         cmpShape->addChildShape(t, trishape.get());
 
+        auto bvh = trishape->getOptimizedBvh();
+        memorySize += sizeof(btTriangleIndexVertexArray) +
+                      sizeof(btBvhTriangleMeshShape) +
+                      (bvh ? bvh->calculateSerializeBufferSize() : 0);
         m_shapes.push_back(std::move(trishape));
     }
 
     m_collisionHeight = colMax - colMin;
+    memorySize += m_shapes.size() * sizeof(btCompoundShapeChild);
+    m_memory.resize(memorySize);
 
     if (dynamics) {
         if (dynamics->uprootForce > 0.f) {
@@ -4,6 +4,8 @@
 #include <memory>
 #include <vector>
 
+#include <rw/memory.hpp>
+
 class btCollisionShape;
 class btCompoundShape;
 class btMotionState;
@@ -48,6 +50,9 @@ private:
     std::unique_ptr<btMotionState> m_motionState;
 
     float m_collisionHeight{0.f};
+
+    /// Estimated size of the body, shapes and triangle BVH
+    TrackedMemory m_memory{MemoryTag::Collision};
 };
 
 #endif
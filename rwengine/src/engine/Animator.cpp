@@ -9,37 +9,162 @@
 #include "loaders/LoaderIFP.hpp"
 
 #include <algorithm>
-#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RW_ANIMATION_SSE
+#include <emmintrin.h>
+#endif
+
+void AnimationPose::resize(size_t size) {
+    rx.resize(size, 0.f);
+    ry.resize(size, 0.f);
+    rz.resize(size, 0.f);
+    rw.resize(size, 1.f);
+    tx.resize(size, 0.f);
+    ty.resize(size, 0.f);
+    tz.resize(size, 0.f);
+}
+
+#if defined(RW_ANIMATION_SSE)
+namespace {
+__m128 lerp(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+__m128 dot(__m128 ax, __m128 ay, __m128 az, __m128 aw, __m128 bx, __m128 by,
+           __m128 bz, __m128 bw) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                      _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+}
+}  // namespace
+#endif
+
+void AnimationPose::blend(const AnimationPose& other, const float* weights) {
+    RW_ASSERT(other.size() == size());
+    const auto count = size();
+    size_t f = 0;
+
+#if defined(RW_ANIMATION_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 signBit = _mm_set1_ps(-0.f);
+    for (; f + 4 <= count; f += 4) {
+        const __m128 w = _mm_loadu_ps(weights + f);
+
+        __m128 ax = _mm_loadu_ps(&rx[f]);
+        __m128 ay = _mm_loadu_ps(&ry[f]);
+        __m128 az = _mm_loadu_ps(&rz[f]);
+        __m128 aw = _mm_loadu_ps(&rw[f]);
+        __m128 bx = _mm_loadu_ps(&other.rx[f]);
+        __m128 by = _mm_loadu_ps(&other.ry[f]);
+        __m128 bz = _mm_loadu_ps(&other.rz[f]);
+        __m128 bw = _mm_loadu_ps(&other.rw[f]);
+
+        // Negate the other rotation where that is the shorter way round
+        __m128 d = dot(ax, ay, az, aw, bx, by, bz, bw);
+        __m128 flip = _mm_and_ps(_mm_cmplt_ps(d, zero), signBit);
+        __m128 x = lerp(ax, _mm_xor_ps(bx, flip), w);
+        __m128 y = lerp(ay, _mm_xor_ps(by, flip), w);
+        __m128 z = lerp(az, _mm_xor_ps(bz, flip), w);
+        __m128 q = lerp(aw, _mm_xor_ps(bw, flip), w);
+
+        __m128 scale =
+            _mm_div_ps(one, _mm_sqrt_ps(dot(x, y, z, q, x, y, z, q)));
+        _mm_storeu_ps(&rx[f], _mm_mul_ps(x, scale));
+        _mm_storeu_ps(&ry[f], _mm_mul_ps(y, scale));
+        _mm_storeu_ps(&rz[f], _mm_mul_ps(z, scale));
+        _mm_storeu_ps(&rw[f], _mm_mul_ps(q, scale));
+
+        _mm_storeu_ps(&tx[f], lerp(_mm_loadu_ps(&tx[f]),
+                                   _mm_loadu_ps(&other.tx[f]), w));
+        _mm_storeu_ps(&ty[f], lerp(_mm_loadu_ps(&ty[f]),
+                                   _mm_loadu_ps(&other.ty[f]), w));
+        _mm_storeu_ps(&tz[f], lerp(_mm_loadu_ps(&tz[f]),
+                                   _mm_loadu_ps(&other.tz[f]), w));
+    }
+#endif
+
+    for (; f < count; ++f) {
+        const float w = weights[f];
+        auto a = getRotation(f);
+        auto b = other.getRotation(f);
+        if (glm::dot(a, b) < 0.f) {
+            b = -b;
+        }
+        set(f, glm::normalize(a * (1.f - w) + b * w),
+            glm::mix(getTranslation(f), other.getTranslation(f), w));
+    }
+}
 
 Animator::Animator(const ClumpPtr& _model) : model(_model) {
 }
 
+void Animator::bindBones(AnimationState& state) {
+    state.bones.clear();
+    state.bones.reserve(state.animation->bones.size());
+    for (const auto& bone : state.animation->bones) {
+        if (bone.second->frames.empty()) {
+            continue;
+        }
+        auto frame = model->findFrameIndex(bone.first);
+        if (frame == Clump::kNoFrame) {
+            continue;
+        }
+        state.bones.push_back({bone.second.get(), frame, 0});
+    }
+    state.bound = true;
+}
+
+void Animator::samplePose(AnimationState& state, float time) {
+    std::fill(weights.begin(), weights.end(), 0.f);
+    for (auto& b : state.bones) {
+        auto kf = b.bone->getInterpolatedKeyframe(time, b.cursor);
+        glm::vec3 translation{};
+        if (b.bone->type != AnimationBone::R00) {
+            translation = kf.position;
+        }
+        sample.set(b.frame, kf.rotation, translation);
+
+        // The first animation to move a frame sets it outright
+        weights[b.frame] = posed[b.frame] ? state.weight : 1.f;
+        posed[b.frame] = 1;
+    }
+}
+
+void Animator::applyPose() {
+    const auto& frames = model->getFrames();
+    for (size_t f = 0; f < frames.size(); ++f) {
+        if (!posed[f]) {
+            continue;
+        }
+        const auto& frame = frames[f];
+        glm::mat4 matrix(glm::mat3_cast(pose.getRotation(f)));
+        matrix[3] = glm::vec4(
+            frame->getDefaultTranslation() + pose.getTranslation(f), 1.f);
+        frame->setTransform(matrix);
+    }
+
+    // The frames only marked their world transforms out of date
+    model->updateTransforms();
+}
+
 void Animator::tick(float dt) {
     if (model == nullptr || animations.empty()) {
         return;
     }
 
-    struct BoneTransform {
-        glm::vec3 translation{};
-        glm::quat rotation{1.0f,0.0f,0.0f,0.0f};
-    };
-
-#if 0
-    // Blend all active animations together
-    std::map<ModelFrame*, BoneTransform> blendFrames;
-#endif
+    const auto frameCount = model->getFrames().size();
+    pose.resize(frameCount);
+    sample.resize(frameCount);
+    weights.resize(frameCount);
+    posed.assign(frameCount, 0);
 
     for (AnimationState& state : animations) {
         if (state.animation == nullptr) continue;
 
-        if (state.boneInstances.empty()) {
-            for (const auto& bone : state.animation->bones) {
-                auto frame = model->findFrame(bone.first);
-                if (!frame) {
-                    continue;
-                }
-                state.boneInstances.emplace(bone.second.get(), frame);
-            }
+        if (!state.bound) {
+            bindBones(state);
         }
 
         state.time = state.time + dt;
@@ -51,42 +176,15 @@ void Animator::tick(float dt) {
             animTime = std::fmod(animTime, state.animation->duration);
         }
 
-        for (auto& b : state.boneInstances) {
-            if (b.first->frames.empty()) continue;
-            auto kf = b.first->getInterpolatedKeyframe(animTime);
-
-            BoneTransform xform;
-            xform.rotation = kf.rotation;
-            if (b.first->type != AnimationBone::R00) {
-                xform.translation = kf.position;
-            }
-
-#if 0
-			auto prevAnim = blendFrames.find(b.second.frameIndex);
-			if (prevAnim != blendFrames.end())
-			{
-				prevAnim->second.translation += xform.translation;
-				prevAnim->second.rotation *= xform.rotation;
-			}
-			else
-			{
-				blendFrames[b.second.frameIndex] = xform;
-			}
-#else
-            b.second->setTranslation(b.second->getDefaultTranslation() +
-                                     xform.translation);
-            b.second->setRotation(glm::mat3_cast(xform.rotation));
-#endif
+        if (state.weight <= 0.f || state.bones.empty()) {
+            continue;
         }
-    }
 
-#if 0
-    for (auto& p : blendFrames) {
-        p.first->setTranslation(p.first->getDefaultTranslation() +
-                                p.second.translation);
-        p.first->setRotation(glm::mat3_cast(p.second.rotation));
+        samplePose(state, animTime);
+        pose.blend(sample, weights.data());
     }
-#endif
+
+    applyPose();
 }
 
 bool Animator::isCompleted(unsigned int slot) const {
@@ -1,13 +1,64 @@
 #ifndef _RWENGINE_ANIMATOR_HPP_
 #define _RWENGINE_ANIMATOR_HPP_
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 #include <rw/debug.hpp>
 #include <rw/forward.hpp>
 
 struct AnimationBone;
-class ModelFrame;
+
+/**
+ * @brief Rotations and translations for a list of frames
+ *
+ * Each component is kept in its own array so that several frames can be
+ * blended at once.
+ */
+struct AnimationPose {
+    std::vector<float> rx, ry, rz, rw;
+    std::vector<float> tx, ty, tz;
+
+    /**
+     * @brief resize Changes the number of frames, new frames are given no
+     * rotation or translation
+     */
+    void resize(size_t size);
+
+    size_t size() const {
+        return rw.size();
+    }
+
+    void set(size_t frame, const glm::quat& rotation,
+             const glm::vec3& translation) {
+        rx[frame] = rotation.x;
+        ry[frame] = rotation.y;
+        rz[frame] = rotation.z;
+        rw[frame] = rotation.w;
+        tx[frame] = translation.x;
+        ty[frame] = translation.y;
+        tz[frame] = translation.z;
+    }
+
+    glm::quat getRotation(size_t frame) const {
+        return {rw[frame], rx[frame], ry[frame], rz[frame]};
+    }
+
+    glm::vec3 getTranslation(size_t frame) const {
+        return {tx[frame], ty[frame], tz[frame]};
+    }
+
+    /**
+     * @brief blend Moves each frame towards another pose of the same size,
+     * rotating with a normalised lerp along the shorter arc
+     * @param weights One for each frame, from 0 to keep this pose to 1 to
+     * take other's
+     */
+    void blend(const AnimationPose& other, const float* weights);
+};
 
 /**
  * @brief calculates animation frame matrices, as well as procedural frame
@@ -17,9 +68,23 @@ class ModelFrame;
  * the animation to the animator. This sets the configuration to use for the
  * animation, such as it's speed and time.
  *
- * The Animator will blend all active animations together.
+ * The Animator blends all active animations together in slot order, each
+ * by its weight over the slots before it. With the default weight of 1 a
+ * later slot replaces earlier ones on the frames it has bones for. The
+ * blended pose is written to the model's frames once per tick.
  */
 class Animator {
+    /**
+     * @brief Connects an animation bone to the frame it moves
+     */
+    struct BoneBinding {
+        AnimationBone* bone;
+        /// Position of the frame in the model's frame list
+        size_t frame;
+        /// The keyframe found when the bone was last sampled
+        size_t cursor;
+    };
+
     /**
      * @brief The AnimationState struct stores information about playing
      * animations
@@ -32,9 +97,26 @@ class Animator {
         float speed;
         /// Automatically restart
         bool repeat;
-        std::map<AnimationBone*, ModelFrame*> boneInstances;
+        /// How much the animation replaces the slots before it, 0 to 1
+        float weight;
+        /// Bones that have a frame in the model, bound on the first tick
+        std::vector<BoneBinding> bones;
+        bool bound;
     };
 
+    void bindBones(AnimationState& state);
+
+    /**
+     * @brief samplePose Samples an animation into the sample pose and sets
+     * the weight it is blended with for each of its frames
+     */
+    void samplePose(AnimationState& state, float time);
+
+    /**
+     * @brief applyPose Writes the blended pose to the frames it covers
+     */
+    void applyPose();
+
     /**
      * @brief model The model being animated.
      */
@@ -45,6 +127,15 @@ class Animator {
      */
     std::vector<AnimationState> animations;
 
+    /// All animations blended together, for every frame of the model
+    AnimationPose pose;
+    /// One animation before it is blended into pose
+    AnimationPose sample;
+    /// The weight of sample for each frame, zero where it has no bone
+    std::vector<float> weights;
+    /// Frames that an animation has a bone for this tick
+    std::vector<uint8_t> posed;
+
 public:
     Animator(const ClumpPtr& _model);
 
@@ -60,7 +151,7 @@ public:
         if (slot >= animations.size()) {
             animations.resize(slot + 1);
         }
-        animations[slot] = {anim, 0.f, speed, repeat, {}};
+        animations[slot] = {anim, 0.f, speed, repeat, 1.f, {}, false};
     }
 
     void setAnimationSpeed(unsigned int slot, float speed) {
@@ -70,6 +161,24 @@ public:
         }
     }
 
+    /**
+     * @brief setAnimationWeight Sets how much a slot's animation replaces
+     * the slots before it, 1 when it is played
+     */
+    void setAnimationWeight(unsigned int slot, float weight) {
+        RW_CHECK(slot < animations.size(), "Slot out of range");
+        if (slot < animations.size()) {
+            animations[slot].weight = glm::clamp(weight, 0.f, 1.f);
+        }
+    }
+
+    float getAnimationWeight(unsigned int slot) const {
+        if (slot < animations.size()) {
+            return animations[slot].weight;
+        }
+        return 0.f;
+    }
+
     /**
      * @brief tick Update animation paramters for server-side data.
      * @param dt
@@ -9,6 +9,8 @@
 #include <iterator>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <unordered_set>
 
 #include <boost/algorithm/string/predicate.hpp>
 
@@ -26,12 +28,30 @@
 #include "loaders/LoaderIFP.hpp"
 #include "loaders/LoaderIPL.hpp"
 #include "loaders/WeatherLoader.hpp"
+#include "loaders/WorldCache.hpp"
 #include "platform/FileHandle.hpp"
 #include "script/SCMFile.hpp"
 #include "loaders/GenericDATLoader.hpp"
 #include "loaders/LoaderGXT.hpp"
 #include "platform/FileIndex.hpp"
 
+namespace {
+constexpr unsigned int kStreamingWorkers = 2;
+
+/// Leave a core for the main thread, which uploads to GL while loading
+unsigned int loadingWorkers() {
+    auto cores = std::thread::hardware_concurrency();
+    return cores > 2 ? cores - 1 : 1;
+}
+
+/// Data read by a loading task, to be added on the main thread
+template <class T>
+struct LoadedData {
+    T data;
+    bool loaded = false;
+};
+}  // namespace
+
 GameData::GameData(Logger* log, const rwfs::path& path)
     : datpath(path), logger(log) {
     dffLoader.setTextureLookupCallback(
@@ -40,57 +60,130 @@ GameData::GameData(Logger* log, const rwfs::path& path)
         });
 }
 
-void GameData::load() {
-    index.indexTree(datpath);
-
-    loadIMG("models/gta3.img");
-    /// @todo cuts.img files should be loaded differently to gta3.img
-    loadIMG("anim/cuts.img");
+GameData::~GameData() {
+    // Stop the workers before the index they read from is destroyed
+    streamer.reset();
+}
 
-    textureslots["particle"] = loadTextureArchive("particle.txd");
-    textureslots["icons"] = loadTextureArchive("icons.txd");
-    textureslots["hud"] = loadTextureArchive("hud.txd");
-    textureslots["fonts"] = loadTextureArchive("fonts.txd");
-    textureslots["generic"] = loadTextureArchive("generic.txd");
-    auto misc = loadTextureArchive("misc.txd");
-    textureslots["generic"].insert(misc.begin(), misc.end());
+void GameData::load() {
+    RW_PROFILE_SCOPE(__func__);
+    using Affinity = TaskGraph::Affinity;
 
-    loadCarcols("data/carcols.dat");
-    loadWeather("data/timecyc.dat");
-    loadHandling("data/handling.cfg");
-    loadWaterpro("data/waterpro.dat");
-    loadWeaponDAT("data/weapon.dat");
-    loadPedStats("data/pedstats.dat");
-    loadPedRelations("data/ped.dat");
+    index.indexTree(datpath);
 
-    loadIFP("ped.ifp");
+    if (!worldCachePath.empty()) {
+        worldCache = std::make_unique<WorldCache>();
+        worldCached =
+            worldCache->read(worldCachePath.string(), modelinfo, ipls);
+        if (worldCached) {
+            logger->info("Data", "Read world data from cache " +
+                                      worldCachePath.string());
+        } else {
+            // IDEs look up ped stats by name
+            recordWorldSource("data/pedstats.dat");
+        }
+    }
 
-    /// @todo load real data
-    pedAnimGroups["player"] = std::make_unique<AnimGroup>(
-        AnimGroup::getBuiltInAnimGroup(animations, "player"));
+    TaskGraph tasks;
+
+    // Everything else reads from the index, so the archives come first
+    auto archives = tasks.add([this]() {
+        loadIMG("models/gta3.img");
+        /// @todo cuts.img files should be loaded differently to gta3.img
+        loadIMG("anim/cuts.img");
+    });
+
+    auto textures = tasks.add(
+        [this]() {
+            textureslots["particle"] = loadTextureArchive("particle.txd");
+            textureslots["icons"] = loadTextureArchive("icons.txd");
+            textureslots["hud"] = loadTextureArchive("hud.txd");
+            textureslots["fonts"] = loadTextureArchive("fonts.txd");
+            textureslots["generic"] = loadTextureArchive("generic.txd");
+            auto misc = loadTextureArchive("misc.txd");
+            textureslots["generic"].insert(misc.begin(), misc.end());
+        },
+        {archives}, Affinity::MainThread);
+
+    tasks.add([this]() { loadCarcols("data/carcols.dat"); }, {archives});
+    tasks.add([this]() { loadWeather("data/timecyc.dat"); }, {archives});
+    tasks.add([this]() { loadHandling("data/handling.cfg"); }, {archives});
+    tasks.add([this]() { loadWaterpro("data/waterpro.dat"); }, {archives});
+    tasks.add([this]() { loadWeaponDAT("data/weapon.dat"); }, {archives});
+    auto stats =
+        tasks.add([this]() { loadPedStats("data/pedstats.dat"); }, {archives});
+    tasks.add([this]() { loadPedRelations("data/ped.dat"); }, {archives});
+
+    tasks.add(
+        [this]() {
+            loadIFP("ped.ifp");
+
+            /// @todo load real data
+            pedAnimGroups["player"] = std::make_unique<AnimGroup>(
+                AnimGroup::getBuiltInAnimGroup(animations, "player"));
+        },
+        {archives});
 
     // Clear existing zones
     gamezones = ZoneDataList{
         {"CITYZON", 0, {-4000.f, -4000.f, -500.f}, {4000.f, 4000.f, 500.f}, 0, 0, 0}};
 
-    loadLevelFile("data/default.dat");
-    loadLevelFile("data/gta3.dat");
+    // IDEs need the ped stats to be read
+    auto level = addLevelFileTasks(tasks, "data/default.dat", stats, textures);
+    level = addLevelFileTasks(tasks, "data/gta3.dat", stats, level);
 
     // Load ped groups after IDEs so they can resolve
-    loadPedGroups("data/pedgrp.dat");
+    tasks.add([this]() { loadPedGroups("data/pedgrp.dat"); }, {level});
+
+    tasks.run(loadingWorkers());
+
+    if (worldCache) {
+        if (!worldCached) {
+            if (worldCache->write(worldCachePath.string(), modelinfo, ipls)) {
+                logger->info("Data", "Wrote world cache " +
+                                         worldCachePath.string());
+            } else {
+                logger->error("Data", "Failed to write world cache " +
+                                          worldCachePath.string());
+            }
+        }
+        // Level files loaded later aren't part of the cache
+        worldCache.reset();
+        worldCached = false;
+    }
+}
+
+void GameData::recordWorldSource(const std::string& path) {
+    if (worldCache && !worldCached) {
+        worldCache->addSource(index.findFilePath(path).string());
+    }
 }
 
 void GameData::loadLevelFile(const std::string& path) {
+    TaskGraph tasks;
+    auto start = tasks.add([]() {});
+    addLevelFileTasks(tasks, path, start, start);
+    tasks.run(loadingWorkers());
+}
+
+TaskGraph::TaskID GameData::addLevelFileTasks(TaskGraph& tasks,
+                                              const std::string& path,
+                                              TaskGraph::TaskID readAfter,
+                                              TaskGraph::TaskID addAfter) {
+    using Affinity = TaskGraph::Affinity;
+
     auto datpath = index.findFilePath(path);
     std::ifstream datfile(datpath.string());
 
     if (!datfile.is_open()) {
         logger->error("Data", "Failed to open game file " + path);
-        return;
+        return addAfter;
     }
+    recordWorldSource(path);
 
     // Reset texture slot
-    currenttextureslot = "generic";
+    auto last = tasks.add([this]() { currenttextureslot = "generic"; },
+                          {addAfter}, Affinity::MainThread);
 
     for (std::string line, cmd; std::getline(datfile, line);) {
         if (line.empty() || line[0] == '#') continue;
@@ -103,36 +196,149 @@ void GameData::loadLevelFile(const std::string& path) {
             cmd = line.substr(0, space);
             if (cmd == "IDE") {
                 auto path = line.substr(space + 1);
-                loadIDE(path);
+                if (worldCached) {
+                    continue;
+                }
+                recordWorldSource(path);
+                auto ide = std::make_shared<LoadedData<LoaderIDE>>();
+                auto read = tasks.add(
+                    [this, ide, path]() {
+                        auto systempath = index.findFilePath(path).string();
+                        ide->loaded = ide->data.load(systempath, pedstats);
+                    },
+                    {readAfter});
+                last = tasks.add(
+                    [this, ide, path]() {
+                        if (!ide->loaded) {
+                            logger->error("Data", "Failed to load IDE " + path);
+                            return;
+                        }
+                        std::move(ide->data.objects.begin(),
+                                  ide->data.objects.end(),
+                                  std::inserter(modelinfo, modelinfo.end()));
+                    },
+                    {last, read}, Affinity::MainThread);
             } else if (cmd == "SPLASH") {
-                splash = line.substr(space + 1);
+                auto name = line.substr(space + 1);
+                last = tasks.add([this, name]() { splash = name; }, {last},
+                                 Affinity::MainThread);
             } else if (cmd == "COLFILE") {
-                int zone = lexical_cast<int>(line.substr(space + 1, 1));
                 auto path = line.substr(space + 3);
-                loadCOL(zone, path);
+                if (worldCached) {
+                    continue;
+                }
+                recordWorldSource(path);
+                auto col = std::make_shared<LoadedData<LoaderCOL>>();
+                auto read = tasks.add(
+                    [this, col, path]() {
+                        auto systempath = index.findFilePath(path).string();
+                        col->loaded = col->data.load(systempath);
+                    },
+                    {readAfter});
+                // Collisions are matched by name to the IDEs before them
+                last = tasks.add(
+                    [this, col]() {
+                        if (col->loaded) {
+                            setupCollisions(col->data);
+                        }
+                    },
+                    {last, read}, Affinity::MainThread);
             } else if (cmd == "IPL") {
                 auto path = line.substr(space + 1);
-                loadIPL(path);
+                if (worldCache && !worldCached) {
+                    // Keep the parsed placements and zones to be cached
+                    recordWorldSource(path);
+                    auto ipl = std::make_shared<LoadedData<LoaderIPL>>();
+                    auto read = tasks.add(
+                        [this, ipl, path]() {
+                            auto systempath = index.findFilePath(path).string();
+                            ipl->loaded = ipl->data.load(systempath);
+                        },
+                        {readAfter});
+                    last = tasks.add(
+                        [this, ipl, path]() {
+                            if (ipl->loaded) {
+                                auto systempath =
+                                    index.findFilePath(path).string();
+                                ipls[systempath] = std::move(ipl->data);
+                            }
+                        },
+                        {last, read}, Affinity::MainThread);
+                }
+                last = tasks.add([this, path]() { loadIPL(path); }, {last},
+                                 Affinity::MainThread);
             } else if (cmd == "TEXDICTION") {
                 auto path = line.substr(space + 1);
-                /// @todo improve TXD handling
-                auto name = index.findFilePath(path).filename().string();
-                std::transform(name.begin(), name.end(), name.begin(),
-                               ::tolower);
-                loadTXD(name);
+                auto txd =
+                    std::make_shared<LoadedData<std::vector<DecodedTexture>>>();
+                auto read = tasks.add(
+                    [this, txd, path]() {
+                        auto file = index.openFileRaw(path);
+                        if (file.data) {
+                            txd->data = textureLoader.parse(file);
+                            txd->loaded = true;
+                        }
+                    },
+                    {readAfter});
+                last = tasks.add(
+                    [this, txd, path]() {
+                        /// @todo improve TXD handling
+                        auto name =
+                            index.findFilePath(path).filename().string();
+                        std::transform(name.begin(), name.end(), name.begin(),
+                                       ::tolower);
+                        if (!txd->loaded) {
+                            loadTXD(name);
+                            return;
+                        }
+                        // Only the GL textures are created here
+                        if (setTextureSlot(name)) {
+                            TextureArchive textures;
+                            textureLoader.upload(std::move(txd->data),
+                                                 textures);
+                            textureslots[currenttextureslot] =
+                                std::move(textures);
+                        }
+                    },
+                    {last, read}, Affinity::MainThread);
             } else if (cmd == "MODELFILE") {
                 auto path = line.substr(space + 1);
-                loadModelFile(path);
+                auto model = std::make_shared<LoadedData<ClumpData>>();
+                auto read = tasks.add(
+                    [this, model, path]() {
+                        auto file = index.openFileRaw(path);
+                        if (file.data) {
+                            model->data = LoaderDFF::parse(file);
+                            model->loaded = true;
+                        }
+                    },
+                    {readAfter});
+                // Textures are found in the slot set by the last TEXDICTION
+                last = tasks.add(
+                    [this, model, path]() {
+                        if (!model->loaded) {
+                            logger->log("Data", Logger::Error,
+                                        "Failed to load model file " + path);
+                            return;
+                        }
+                        setupModelFile(dffLoader.upload(std::move(model->data)));
+                    },
+                    {last, read}, Affinity::MainThread);
             }
         }
     }
 
-    for (const auto& model : modelinfo) {
-        if (model.second->type() == ModelDataType::SimpleInfo) {
-            auto simple = static_cast<SimpleModelInfo*>(model.second.get());
-            simple->setupBigBuilding(modelinfo);
-        }
-    }
+    return tasks.add(
+        [this]() {
+            for (const auto& model : modelinfo) {
+                if (model.second->type() == ModelDataType::SimpleInfo) {
+                    auto simple =
+                        static_cast<SimpleModelInfo*>(model.second.get());
+                    simple->setupBigBuilding(modelinfo);
+                }
+            }
+        },
+        {last}, Affinity::MainThread);
 }
 
 void GameData::loadIDE(const std::string& path) {
@@ -175,17 +381,21 @@ void GameData::loadCOL(const size_t zone, const std::string& name) {
     auto systempath = index.findFilePath(name).string();
 
     if (col.load(systempath)) {
-        // Associate loaded collisions with models
-        for (auto& c : col.collisions) {
-            // Find by name
-            auto id = findModelObject(c->name);
-            auto model = modelinfo.find(id);
-            if (model == modelinfo.end()) {
-                logger->error("Data", "no model for collsion " + c->name);
-                continue;
-            }
-            model->second->setCollisionModel(c);
+        setupCollisions(col);
+    }
+}
+
+void GameData::setupCollisions(LoaderCOL& col) {
+    // Associate loaded collisions with models
+    for (auto& c : col.collisions) {
+        // Find by name
+        auto id = findModelObject(c->name);
+        auto model = modelinfo.find(id);
+        if (model == modelinfo.end()) {
+            logger->error("Data", "no model for collsion " + c->name);
+            continue;
         }
+        model->second->setCollisionModel(c);
     }
 }
 
@@ -199,15 +409,22 @@ void GameData::loadIPL(const std::string& path) {
 }
 
 bool GameData::loadZone(const std::string& path) {
-    LoaderIPL ipll;
+    auto cached = ipls.find(path);
+    if (cached != ipls.end()) {
+        gamezones.insert(gamezones.end(), cached->second.zones.begin(),
+                         cached->second.zones.end());
+    } else {
+        LoaderIPL ipll;
 
-    // Load the zones
-    if (!ipll.load(path)) {
-        logger->error("Data", "Failed to load zones from " + path);
-        return false;
-    }
+        // Load the zones
+        if (!ipll.load(path)) {
+            logger->error("Data", "Failed to load zones from " + path);
+            return false;
+        }
 
-    gamezones.insert(gamezones.end(), ipll.zones.begin(), ipll.zones.end());
+        gamezones.insert(gamezones.end(), ipll.zones.begin(),
+                         ipll.zones.end());
+    }
 
     // Build zone hierarchy
     for (ZoneData& zone : gamezones) {
@@ -351,6 +568,12 @@ void GameData::loadWater(const std::string& path) {
 
 void GameData::loadTXD(const std::string& name) {
     RW_PROFILE_COUNTER_ADD("loadTXD", 1);
+    if (setTextureSlot(name)) {
+        textureslots[currenttextureslot] = loadTextureArchive(name);
+    }
+}
+
+bool GameData::setTextureSlot(const std::string& name) {
     auto slot = name;
     auto ext = name.find(".txd");
     if (ext != std::string::npos) {
@@ -361,18 +584,18 @@ void GameData::loadTXD(const std::string& name) {
     currenttextureslot = slot;
 
     // Check if this texture slot is loaded already
-    auto slotit = textureslots.find(slot);
-    if (slotit != textureslots.end()) {
-        return;
-    }
-
-    textureslots[slot] = loadTextureArchive(name);
+    return textureslots.find(slot) == textureslots.end();
 }
 
 TextureArchive GameData::loadTextureArchive(const std::string& name) {
     RW_PROFILE_COUNTER_ADD("loadTextureArchive", 1);
     /// @todo refactor loadTXD to use correct file locations
     auto file = index.openFile(name);
+    return loadTextureArchive(name, file);
+}
+
+TextureArchive GameData::loadTextureArchive(const std::string& name,
+                                            const FileContentsInfo& file) {
     if (!file.data) {
         logger->error("Data", "Failed to open txd: " + name);
         return {};
@@ -380,8 +603,7 @@ TextureArchive GameData::loadTextureArchive(const std::string& name) {
 
     TextureArchive textures;
 
-    TextureLoader l;
-    if (!l.loadFromMemory(file, textures)) {
+    if (!textureLoader.loadFromMemory(file, textures)) {
         logger->error("Data", "Error loading txd: " + name);
         return {};
     }
@@ -432,6 +654,10 @@ void GameData::loadModelFile(const std::string& name) {
         return;
     }
 
+    setupModelFile(m);
+}
+
+void GameData::setupModelFile(const ClumpPtr& m) {
     // Associate the frames with models.
     for (const auto& atomic : m->getAtomics()) {
         /// @todo this is useful elsewhere, please move elsewhere
@@ -453,11 +679,10 @@ void GameData::loadModelFile(const std::string& name) {
     }
 }
 
-bool GameData::loadModel(ModelID model) {
-    auto info = modelinfo[model].get();
-    /// @todo replace openFile with API for loading from CDIMAGE archives
-    auto name = info->name;
-    auto slotname = info->textureslot;
+void GameData::getModelFileNames(BaseModelInfo* info, std::string& name,
+                                 std::string& slotname) const {
+    name = info->name;
+    slotname = info->textureslot;
 
     // Re-direct special models
     switch (info->type()) {
@@ -483,20 +708,12 @@ bool GameData::loadModel(ModelID model) {
     std::transform(name.begin(), name.end(), name.begin(), ::tolower);
     std::transform(slotname.begin(), slotname.end(), slotname.begin(),
                    ::tolower);
+}
 
-    /// @todo remove this from here
-    loadTXD(slotname + ".txd");
-
-    auto file = index.openFile(name + ".dff");
-    if (!file.data) {
-        logger->error("Data", "Failed to load model for " +
-                                  std::to_string(model) + " [" + name + "]");
-        return false;
-    }
-    auto m = dffLoader.loadFromMemory(file);
+bool GameData::setupModel(BaseModelInfo* info, const ClumpPtr& m) {
     if (!m) {
         logger->error("Data",
-                      "Error loading model file for " + std::to_string(model));
+                      "Error loading model file for " + std::to_string(info->id()));
         return false;
     }
     /// @todo handle timeinfo models correctly.
@@ -519,9 +736,164 @@ bool GameData::loadModel(ModelID model) {
         /// @todo how is LOD handled for clump objects?
     }
 
+    trackModel(info, m);
     return true;
 }
 
+void GameData::trackModel(BaseModelInfo* info, const ClumpPtr& model) {
+    // LODs and clones can share geometry
+    std::unordered_set<const Geometry*> geometries;
+    size_t bytes = 0;
+    for (const auto& atomic : model->getAtomics()) {
+        const auto& geometry = atomic->getGeometry();
+        if (geometry && geometries.insert(geometry.get()).second) {
+            bytes += geometry->getBufferSize();
+        }
+    }
+
+    std::string name, slotname;
+    getModelFileNames(info, name, slotname);
+    residency.addModel(info, slotname, bytes);
+}
+
+std::vector<ModelID> GameData::updateResidency() {
+    RW_PROFILE_SCOPE(__func__);
+    residency.nextFrame();
+    auto evictions = residency.evict();
+    std::vector<ModelID> evicted;
+    evicted.reserve(evictions.models.size());
+    for (auto info : evictions.models) {
+        info->unload();
+        evicted.push_back(info->id());
+    }
+    for (const auto& slot : evictions.textureSlots) {
+        textureslots.erase(slot);
+    }
+
+    RW_PROFILE_COUNTER_SET("residency/models", residency.getModelCount());
+    RW_PROFILE_COUNTER_SET("residency/modelBytes", residency.getModelBytes());
+    RW_PROFILE_COUNTER_SET("residency/textureBytes",
+                           residency.getTextureBytes());
+    return evicted;
+}
+
+bool GameData::loadModel(ModelID model) {
+    auto info = modelinfo[model].get();
+    /// @todo replace openFile with API for loading from CDIMAGE archives
+    std::string name, slotname;
+    getModelFileNames(info, name, slotname);
+
+    // The synchronous load makes a queued request redundant
+    bool requested = streamer && streamer->isPending(model);
+    if (requested) {
+        streamer->cancel(model);
+    }
+
+    /// @todo remove this from here
+    bool slotLoaded = textureslots.find(slotname) != textureslots.end();
+    loadTXD(slotname + ".txd");
+    if (!slotLoaded) {
+        residency.addTextureSlot(slotname,
+                                 ResidencyManager::estimateTextureBytes(
+                                     textureslots[slotname]));
+    }
+
+    auto file = index.openFile(name + ".dff");
+    if (!file.data) {
+        logger->error("Data", "Failed to load model for " +
+                                  std::to_string(info->id()) + " [" + name + "]");
+        return false;
+    }
+    if (!setupModel(info, dffLoader.loadFromMemory(file))) {
+        return false;
+    }
+
+    // Let whoever requested the model know it is loaded
+    if (requested) {
+        synchronousLoads.push_back(model);
+    }
+    return true;
+}
+
+void GameData::requestModel(ModelID model, StreamingPriority priority) {
+    auto it = modelinfo.find(model);
+    if (it == modelinfo.end() || it->second->isLoaded()) {
+        return;
+    }
+
+    if (!streamer) {
+        streamer = std::make_unique<ModelStreamer>(index, textureLoader,
+                                                   kStreamingWorkers);
+    }
+
+    std::string name, slotname;
+    getModelFileNames(it->second.get(), name, slotname);
+
+    // Only read the texture archive if the slot isn't resident yet
+    std::string txdname;
+    if (textureslots.find(slotname) == textureslots.end()) {
+        txdname = slotname + ".txd";
+    }
+
+    streamer->request({model, name + ".dff", txdname, priority});
+}
+
+std::vector<ModelID> GameData::updateStreaming(bool flush) {
+    RW_PROFILE_SCOPE(__func__);
+    std::vector<ModelID> loaded;
+    loaded.swap(synchronousLoads);
+    if (!streamer) {
+        return loaded;
+    }
+
+    auto results = streamer->collect(streamingBudget, flush);
+    RW_PROFILE_COUNTER_SET("streaming/pending", streamer->getPendingCount());
+
+    for (auto& result : results) {
+        auto it = modelinfo.find(result.model);
+        if (it == modelinfo.end()) {
+            continue;
+        }
+        auto info = it->second.get();
+        // Loaded synchronously while the request was in flight
+        if (info->isLoaded()) {
+            continue;
+        }
+
+        auto ext = result.textureFile.find(".txd");
+        if (ext != std::string::npos) {
+            auto slot = result.textureFile.substr(0, ext);
+            if (textureslots.find(slot) == textureslots.end() &&
+                result.textureData.data) {
+                // Decoded by the worker, only the GL textures are made here
+                TextureArchive textures;
+                textureLoader.upload(std::move(result.textures), textures);
+                residency.addTextureSlot(
+                    slot, ResidencyManager::estimateTextureBytes(textures));
+                textureslots[slot] = std::move(textures);
+            }
+        }
+
+        if (!result.clump) {
+            logger->error("Data", "Failed to load model for " +
+                                      std::to_string(result.model) + " [" +
+                                      result.modelFile + "]");
+            continue;
+        }
+
+        std::string name, slotname;
+        getModelFileNames(info, name, slotname);
+        loadTXD(slotname + ".txd");
+
+        // Only the GL objects are created here, parsing was done by a worker
+        if (setupModel(info, dffLoader.upload(std::move(*result.clump)))) {
+            loaded.push_back(result.model);
+        }
+    }
+
+    return loaded;
+}
+
 void GameData::loadIFP(const std::string& name) {
     auto f = index.openFile(name);
 
@@ -17,23 +17,29 @@
 #include <rw/debug.hpp>
 #include <rw/forward.hpp>
 
+#include <core/TaskGraph.hpp>
 #include <data/AnimGroup.hpp>
 #include <data/ModelData.hpp>
 #include <data/PedData.hpp>
 #include <data/Weather.hpp>
 #include <data/ZoneData.hpp>
+#include <engine/ModelStreamer.hpp>
+#include <engine/ResidencyManager.hpp>
 #include <fonts/GameTexts.hpp>
 #include <loaders/LoaderDFF.hpp>
 #include <loaders/LoaderIMG.hpp>
+#include <loaders/LoaderIPL.hpp>
 #include <loaders/LoaderTXD.hpp>
 #include <objects/VehicleInfo.hpp>
 #include <gl/TextureData.hpp>
 
 class Logger;
+class LoaderCOL;
 struct WeaponData;
 class GameWorld;
 class TextureAtlas;
 class SCMFile;
+class WorldCache;
 
 /**
  * @brief Loads and stores all "static" data such as loaded models, handling
@@ -52,13 +58,70 @@ private:
     Logger* logger;
     LoaderDFF dffLoader;
 
+    /// Created on the first streaming request
+    std::unique_ptr<ModelStreamer> streamer;
+
+    /// Requested models that were loaded by loadModel instead
+    std::vector<ModelID> synchronousLoads;
+
+    /// Records the size of a model loaded on demand, so it can be evicted
+    void trackModel(BaseModelInfo* info, const ClumpPtr& model);
+
+    /// Collects the files the world data is read from while loading, null
+    /// if the world cache isn't used
+    std::unique_ptr<WorldCache> worldCache;
+
+    /// The world data was read from the cache, so the level files' IDE, COL
+    /// and IPL files don't need to be parsed
+    bool worldCached = false;
+
+    /**
+     * Finds the names of the model and texture slot to load for a model
+     */
+    void getModelFileNames(BaseModelInfo* info, std::string& name,
+                           std::string& slotname) const;
+
+    /**
+     * Associates a loaded clump with the model
+     */
+    bool setupModel(BaseModelInfo* info, const ClumpPtr& m);
+
+    /**
+     * Associates the atomics of a model file with the models they belong to
+     */
+    void setupModelFile(const ClumpPtr& m);
+
+    /**
+     * Associates the collisions read from a COL file with their models
+     */
+    void setupCollisions(LoaderCOL& col);
+
+    /**
+     * Adds a file to the sources of the world cache, if it is being written
+     */
+    void recordWorldSource(const std::string& path);
+
+    /**
+     * Adds the tasks to load a level file to the graph
+     *
+     * Files are parsed on any thread, then added to the data in the order
+     * they appear in the level file on the main thread.
+     * @param readAfter Task that must complete before files are read
+     * @param addAfter Task that must complete before anything is added
+     * @return The task that completes the level file
+     */
+    TaskGraph::TaskID addLevelFileTasks(TaskGraph& tasks,
+                                        const std::string& path,
+                                        TaskGraph::TaskID readAfter,
+                                        TaskGraph::TaskID addAfter);
+
 public:
     /**
      * ctor
      * @param path Path to the root of the game data.
      */
     GameData(Logger* log, const rwfs::path& path);
-    ~GameData() = default;
+    ~GameData();
 
     GameWorld* engine = nullptr;
 
@@ -127,11 +190,23 @@ public:
      */
     void loadTXD(const std::string& name);
 
+    /**
+     * Sets the current TXD slot to the one for a TXD file
+     * @return true if the slot hasn't been loaded yet
+     */
+    bool setTextureSlot(const std::string& name);
+
     /**
      * Loads a named texture archive from the game data
      */
     TextureArchive loadTextureArchive(const std::string& name);
 
+    /**
+     * Loads a texture archive from data that has already been read
+     */
+    TextureArchive loadTextureArchive(const std::string& name,
+                                      const FileContentsInfo& file);
+
     /**
      * Converts combined {name}_l{LOD} into name and lod.
      */
@@ -153,10 +228,41 @@ public:
     void loadModelFile(const std::string& name);
 
     /**
-     * Loads and associates a model's data
+     * Loads and associates a model's data, blocking until it is loaded
      */
     bool loadModel(ModelID model);
 
+    /**
+     * Requests that a model is read in the background, it will be loaded by
+     * a later call to updateStreaming. Does nothing if it is already loaded.
+     */
+    void requestModel(ModelID model,
+                      StreamingPriority priority = StreamingPriority::Normal);
+
+    /**
+     * Loads models that have finished streaming, up to streamingBudget bytes
+     * @param flush Wait for and load all outstanding requests
+     * @return The models that were loaded
+     */
+    std::vector<ModelID> updateStreaming(bool flush = false);
+
+    /**
+     * Bytes of streamed data to load per call to updateStreaming
+     */
+    size_t streamingBudget = 2 * 1024 * 1024;
+
+    /**
+     * Unloads models and texture slots loaded on demand while they are over
+     * the residency budget, should be called once per frame
+     * @return The models that were unloaded
+     */
+    std::vector<ModelID> updateResidency();
+
+    /**
+     * Memory used by models and textures loaded on demand, and its budget
+     */
+    ResidencyManager residency;
+
     /**
      * Loads an IFP file containing animations
      */
@@ -217,6 +323,17 @@ public:
      */
     std::map<std::string, std::string> iplLocations;
 
+    /**
+     * Parsed IPL files by system path, only kept if the world cache is used
+     */
+    std::map<std::string, LoaderIPL> ipls;
+
+    /**
+     * Where to cache the world data parsed from the level files, the cache
+     * isn't used if this is empty
+     */
+    rwfs::path worldCachePath;
+
     /**
      * Map of loaded archives
      */
@@ -9,9 +9,12 @@
 #pragma warning(default : 4305)
 #endif
 
+#include <algorithm>
+
 #include <glm/gtx/norm.hpp>
 
 #include <data/Clump.hpp>
+#include <rw/memory.hpp>
 
 #include "core/Profiler.hpp"
 #include "core/Logger.hpp"
@@ -34,6 +37,7 @@
 #include "objects/CutsceneObject.hpp"
 #include "objects/InstanceObject.hpp"
 #include "objects/PickupObject.hpp"
+#include "objects/ProjectileObject.hpp"
 #include "objects/VehicleObject.hpp"
 
 #include "platform/FileHandle.hpp"
@@ -47,6 +51,8 @@
 // Behaviour Tuning
 constexpr float kMaxTrafficSpawnRadius = 100.f;
 constexpr float kMaxTrafficCleanupRadius = kMaxTrafficSpawnRadius * 1.25f;
+constexpr float kSpatialIndexCellSize = 25.f;
+constexpr float kInstanceGridCellSize = 100.f;
 
 namespace {
 template <typename T>
@@ -73,7 +79,11 @@ public:
 };
 
 GameWorld::GameWorld(Logger* log, GameData* dat)
-    : logger(log), data(dat), sound(this) {
+    : logger(log)
+    , data(dat)
+    , sound(this)
+    , spatialIndex(kSpatialIndexCellSize)
+    , instanceGrid(kInstanceGridCellSize) {
     data->engine = this;
 
     collisionConfig = std::make_unique<btDefaultCollisionConfiguration>();
@@ -104,25 +114,27 @@ GameWorld::~GameWorld() {
 }
 
 bool GameWorld::placeItems(const std::string& name) {
+    // The IPL may already have been parsed for the world cache
     LoaderIPL ipll;
-
-    if (ipll.load(name)) {
-        // Find the object.
-        for (const auto& inst : ipll.m_instances) {
-            if (!createInstance(inst->id, inst->pos, inst->rot)) {
-                logger->error("World", "No object data for instance " +
-                                           std::to_string(inst->id) + " in " +
-                                           name);
-            }
-        }
-
-        return true;
-    } else {
+    const LoaderIPL* ipl = &ipll;
+    auto cached = data->ipls.find(name);
+    if (cached != data->ipls.end()) {
+        ipl = &cached->second;
+    } else if (!ipll.load(name)) {
         logger->error("Data", "Failed to load IPL " + name);
         return false;
     }
 
-    return false;
+    // Find the object.
+    for (const auto& inst : ipl->m_instances) {
+        if (!createInstance(inst->id, inst->pos, inst->rot)) {
+            logger->error("World", "No object data for instance " +
+                                       std::to_string(inst->id) + " in " +
+                                       name);
+        }
+    }
+
+    return true;
 }
 
 InstanceObject* GameWorld::createInstance(const uint16_t id,
@@ -130,12 +142,6 @@ InstanceObject* GameWorld::createInstance(const uint16_t id,
                                           const glm::quat& rot) {
     auto oi = data->findModelInfo<SimpleModelInfo>(id);
     if (oi) {
-        // Request loading of the model if it isn't loaded already.
-        /// @todo implment streaming properly
-        if (!oi->isLoaded()) {
-            data->loadModel(oi->id());
-        }
-
         // Check for dynamic data.
         auto dyit = data->dynamicObjectData.find(oi->name);
         std::shared_ptr<DynamicObjectData> dydata;
@@ -155,8 +161,10 @@ InstanceObject* GameWorld::createInstance(const uint16_t id,
 
         instancePool.insert(std::move(instance));
         allObjects.push_back(ptr);
+        instanceGrid.insert(ptr);
 
         modelInstances.emplace(oi->name, ptr);
+        instancesByModel[oi->id()].push_back(ptr);
 
         return ptr;
     }
@@ -164,6 +172,58 @@ InstanceObject* GameWorld::createInstance(const uint16_t id,
     return nullptr;
 }
 
+void GameWorld::updateStreaming(bool flush) {
+    RW_PROFILE_SCOPE(__func__);
+    auto loaded = data->updateStreaming(flush);
+    auto evicted = data->updateResidency();
+
+    for (auto model : evicted) {
+        auto it = instancesByModel.find(model);
+        if (it == instancesByModel.end()) {
+            continue;
+        }
+        for (auto instance : it->second) {
+            instance->modelEvicted();
+        }
+    }
+
+    for (auto model : loaded) {
+        auto it = instancesByModel.find(model);
+        if (it == instancesByModel.end()) {
+            continue;
+        }
+        for (auto instance : it->second) {
+            if (instance->isWaitingForModel()) {
+                instance->modelStreamed();
+            }
+        }
+    }
+}
+
+void GameWorld::updateMemoryUsage() {
+    MemoryUsage::set(
+        MemoryTag::Objects,
+        pedestrianPool.getMemorySize(sizeof(CharacterObject)) +
+            instancePool.getMemorySize(sizeof(InstanceObject)) +
+            vehiclePool.getMemorySize(sizeof(VehicleObject)) +
+            pickupPool.getMemorySize(sizeof(PickupObject)) +
+            cutscenePool.getMemorySize(sizeof(CutsceneObject)) +
+            projectilePool.getMemorySize(sizeof(ProjectileObject)));
+
+    RW_PROFILE_COUNTER_SET("memory/textures",
+                           MemoryUsage::get(MemoryTag::Textures));
+    RW_PROFILE_COUNTER_SET("memory/geometry",
+                           MemoryUsage::get(MemoryTag::Geometry));
+    RW_PROFILE_COUNTER_SET("memory/collision",
+                           MemoryUsage::get(MemoryTag::Collision));
+    RW_PROFILE_COUNTER_SET("memory/animation",
+                           MemoryUsage::get(MemoryTag::Animation));
+    RW_PROFILE_COUNTER_SET("memory/audio", MemoryUsage::get(MemoryTag::Audio));
+    RW_PROFILE_COUNTER_SET("memory/objects",
+                           MemoryUsage::get(MemoryTag::Objects));
+    RW_PROFILE_COUNTER_SET("memory/total", MemoryUsage::total());
+}
+
 void GameWorld::createTraffic(const ViewCamera& viewCamera) {
     TrafficDirector director(&aigraph, this);
 
@@ -312,6 +372,7 @@ VehicleObject* GameWorld::createVehicle(const uint16_t id, const glm::vec3& pos,
 
     vehiclePool.insert(std::move(vehicle));
     allObjects.push_back(ptr);
+    spatialIndex.insert(ptr);
 
     return ptr;
 }
@@ -336,6 +397,7 @@ CharacterObject* GameWorld::createPedestrian(const uint16_t id,
     ped->setGameObjectID(gid);
     pedestrianPool.insert(std::move(ped));
     allObjects.push_back(ptr);
+    spatialIndex.insert(ptr);
     return ptr;
 }
 
@@ -366,6 +428,7 @@ CharacterObject* GameWorld::createPlayer(const glm::vec3& pos,
     players.push_back(controller);
     pedestrianPool.insert(std::move(ped));
     allObjects.push_back(ptr);
+    spatialIndex.insert(ptr);
     return ptr;
 }
 
@@ -435,35 +498,86 @@ Payphone* GameWorld::createPayphone(const glm::vec2 coord) {
     return payphones.back().get();
 }
 
+constexpr uint32_t GameWorld::ObjectPool::kNoObject;
+
 void GameWorld::ObjectPool::insert(std::unique_ptr<GameObject> object) {
-    if (object->getGameObjectID() == 0) {
-        // Find the lowest free GameObjectID.
-        GameObjectID availID = 1;
-        for (auto& p : objects) {
-            if (p.first == availID) availID++;
+    auto id = object->getGameObjectID();
+    if (id == 0) {
+        id = nextFreeID();
+        object->setGameObjectID(id);
+    }
+
+    if (id >= slots_.size()) {
+        // Any IDs skipped over are free to be used later
+        for (auto skipped = std::max<size_t>(slots_.size(), 1); skipped < id;
+             ++skipped) {
+            freeIDs_.push(static_cast<GameObjectID>(skipped));
         }
+        slots_.resize(id + 1, kNoObject);
+    }
 
-        object->setGameObjectID(availID);
+    if (slots_[id] != kNoObject) {
+        objects[slots_[id]].second = std::move(object);
+        return;
     }
-    objects[object->getGameObjectID()] = std::move(object);
+
+    slots_[id] = static_cast<uint32_t>(objects.size());
+    objects.emplace_back(id, std::move(object));
+}
+
+GameObjectID GameWorld::ObjectPool::nextFreeID() {
+    while (!freeIDs_.empty()) {
+        auto id = freeIDs_.top();
+        freeIDs_.pop();
+        if (slots_[id] == kNoObject) {
+            return id;
+        }
+    }
+    // ID 0 means an object hasn't been given an ID yet
+    return static_cast<GameObjectID>(std::max<size_t>(slots_.size(), 1));
 }
 
 GameObject* GameWorld::ObjectPool::find(GameObjectID id) const {
-    auto it = objects.find(id);
-    return (it == objects.end()) ? nullptr : it->second.get();
+    if (id >= slots_.size() || slots_[id] == kNoObject) {
+        return nullptr;
+    }
+    return objects[slots_[id]].second.get();
 }
 
 void GameWorld::ObjectPool::remove(GameObject* object) {
-    if (object) {
-        auto it = objects.find(object->getGameObjectID());
-        if (it != objects.end()) {
-            it = objects.erase(it);
-        }
+    if (!object) {
+        return;
     }
+
+    auto id = object->getGameObjectID();
+    if (id >= slots_.size() || slots_[id] == kNoObject) {
+        return;
+    }
+
+    // Destroy the object once the pool is consistent again
+    auto index = slots_[id];
+    auto removed = std::move(objects[index].second);
+
+    // Fill the gap with the last object to keep the objects contiguous
+    if (index != objects.size() - 1) {
+        objects[index] = std::move(objects.back());
+        slots_[objects[index].first] = index;
+    }
+    objects.pop_back();
+    slots_[id] = kNoObject;
+    freeIDs_.push(id);
+}
+
+size_t GameWorld::ObjectPool::getMemorySize(size_t objectSize) const {
+    return objects.size() * objectSize + objects.capacity() * sizeof(Entry) +
+           slots_.capacity() * sizeof(uint32_t) +
+           freeIDs_.size() * sizeof(GameObjectID);
 }
 
 void GameWorld::ObjectPool::clear() {
     objects.clear();
+    slots_.clear();
+    freeIDs_ = decltype(freeIDs_)();
 }
 
 GameWorld::ObjectPool& GameWorld::getTypeObjectPool(GameObject* object) {
@@ -502,6 +616,17 @@ GameObject* GameWorld::getBlipTarget(const BlipData& blip) const {
 }
 
 void GameWorld::destroyObject(GameObject* object) {
+    spatialIndex.remove(object);
+    instanceGrid.remove(object);
+
+    auto info = object->getModelInfo<BaseModelInfo>();
+    if (object->type() == GameObject::Instance && info) {
+        auto& instances = instancesByModel[info->id()];
+        instances.erase(
+            std::remove(instances.begin(), instances.end(), object),
+            instances.end());
+    }
+
     auto& pool = getTypeObjectPool(object);
     pool.remove(object);
 
@@ -917,9 +1042,10 @@ VehicleObject* GameWorld::tryToSpawnVehicle(VehicleGenerator& gen) {
     }
 
     // Ensure there's no existing vehicles near our spawn point
-    for (auto& v : vehiclePool.objects) {
-        if (glm::distance2(position, v.second->getPosition()) <
-            kMinClearRadius * kMinClearRadius) {
+    std::vector<GameObject*> nearby;
+    spatialIndex.queryRadius(position, kMinClearRadius, nearby);
+    for (auto object : nearby) {
+        if (object->type() == GameObject::Vehicle) {
             return nullptr;
         }
     }
@@ -970,50 +1096,36 @@ bool GameWorld::isRaining() const {
 void GameWorld::clearObjectsWithinArea(const glm::vec3 center,
                                        const float radius,
                                        const bool clearParticles) {
-    bool skipFlag = false;
-
-    // Vehicles
-    for (auto& obj : vehiclePool.objects) {
-        skipFlag = false;
+    std::vector<GameObject*> nearby;
+    spatialIndex.queryRadius(center, radius, nearby);
 
+    for (auto obj : nearby) {
         // Skip if it's the player or owned by player or owned by mission
-        if (obj.second->getLifetime() == GameObject::PlayerLifetime ||
-            obj.second->getLifetime() == GameObject::MissionLifetime) {
+        if (obj->getLifetime() == GameObject::PlayerLifetime ||
+            obj->getLifetime() == GameObject::MissionLifetime) {
             continue;
         }
 
-        // Check if we have any important objects in a vehicle, if we do - don't
-        // erase it
-        for (auto& seat :
-             static_cast<VehicleObject*>(obj.second.get())->seatOccupants) {
-            auto character = static_cast<CharacterObject*>(seat.second);
-
-            if (character->getLifetime() == GameObject::PlayerLifetime ||
-                character->getLifetime() == GameObject::MissionLifetime) {
-                skipFlag = true;
+        if (obj->type() == GameObject::Vehicle) {
+            // Check if we have any important objects in a vehicle, if we do -
+            // don't erase it
+            bool skipFlag = false;
+            for (auto& seat :
+                 static_cast<VehicleObject*>(obj)->seatOccupants) {
+                auto character = static_cast<CharacterObject*>(seat.second);
+
+                if (character->getLifetime() == GameObject::PlayerLifetime ||
+                    character->getLifetime() == GameObject::MissionLifetime) {
+                    skipFlag = true;
+                }
             }
-        }
-
-        if (skipFlag) {
-            continue;
-        }
-
-        if (glm::distance(center, obj.second->getPosition()) < radius) {
-            destroyObjectQueued(obj.second.get());
-        }
-    }
 
-    // Peds
-    for (auto& obj : pedestrianPool.objects) {
-        // Skip if it's the player or owned by player or owned by mission
-        if (obj.second->getLifetime() == GameObject::PlayerLifetime ||
-            obj.second->getLifetime() == GameObject::MissionLifetime) {
-            continue;
+            if (skipFlag) {
+                continue;
+            }
         }
 
-        if (glm::distance(center, obj.second->getPosition()) < radius) {
-            destroyObjectQueued(obj.second.get());
-        }
+        destroyObjectQueued(obj);
     }
 
     /// @todo Do we also have to clear all projectiles + particles *in this
@@ -2,11 +2,15 @@
 #define _RWENGINE_GAMEWORLD_HPP_
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <queue>
 #include <random>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -25,7 +29,9 @@
 #include <audio/SoundManager.hpp>
 
 #include <engine/Garage.hpp>
+#include <engine/InstanceGrid.hpp>
 #include <engine/Payphone.hpp>
+#include <engine/SpatialHash.hpp>
 #include <objects/ObjectTypes.hpp>
 
 #include <render/VisualFX.hpp>
@@ -111,7 +117,20 @@ public:
     void cleanupTraffic(const ViewCamera& viewCamera);
 
     /**
-     * Creates an instance
+     * Loads models that have finished streaming in and hands them to the
+     * instances that are waiting for them.
+     * @param flush Wait for all outstanding requests to finish
+     */
+    void updateStreaming(bool flush = false);
+
+    /**
+     * Measures the object pools into the objects memory tag and publishes
+     * the memory used by each tag as profiler counters.
+     */
+    void updateMemoryUsage();
+
+    /**
+     * Creates an instance, its model is streamed in if it isn't loaded
      */
     InstanceObject* createInstance(const uint16_t id, const glm::vec3& pos,
                                    const glm::quat& rot = glm::quat{
@@ -253,7 +272,13 @@ public:
      * the individual pools.
      */
     struct ObjectPool {
-        std::map<GameObjectID, std::unique_ptr<GameObject>> objects;
+        using Entry = std::pair<GameObjectID, std::unique_ptr<GameObject>>;
+
+        /**
+         * The objects in the pool, stored contiguously in no particular
+         * order. Inserting or removing objects invalidates iterators.
+         */
+        std::vector<Entry> objects;
 
         /**
          * Allocates the game object a GameObjectID and inserts it into
@@ -275,6 +300,27 @@ public:
          * Removes all stored objects
          */
         void clear();
+
+        /**
+         * Estimates the memory held by the pool
+         * @param objectSize The size of the pool's object type
+         */
+        size_t getMemorySize(size_t objectSize) const;
+
+    private:
+        static constexpr uint32_t kNoObject = ~0u;
+
+        /// Finds the lowest GameObjectID not in use
+        GameObjectID nextFreeID();
+
+        /// The index into objects of each GameObjectID, or kNoObject
+        std::vector<uint32_t> slots_;
+
+        /// Released IDs, lowest first. Some may have been given to objects
+        /// again by an explicit ID, these are skipped
+        std::priority_queue<GameObjectID, std::vector<GameObjectID>,
+                            std::greater<GameObjectID>>
+            freeIDs_;
     };
 
     /**
@@ -282,6 +328,17 @@ public:
      */
     std::vector<GameObject*> allObjects;
 
+    /**
+     * Characters and vehicles by position, for finding the objects near a
+     * point without testing every object
+     */
+    SpatialHash spatialIndex;
+
+    /**
+     * Instances by position, for culling them by cell when rendering
+     */
+    InstanceGrid instanceGrid;
+
     ObjectPool pedestrianPool;
     ObjectPool instancePool;
     ObjectPool vehiclePool;
@@ -309,6 +366,13 @@ public:
      */
     std::map<std::string, InstanceObject*> modelInstances;
 
+    /**
+     * Instances of each model ID, so that only the instances of a model are
+     * told when it is streamed in or evicted
+     */
+    std::unordered_map<uint16_t, std::vector<InstanceObject*>>
+        instancesByModel;
+
     /**
      * AI Graph
      */
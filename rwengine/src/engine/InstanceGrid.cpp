@@ -0,0 +1,152 @@
+#include "engine/InstanceGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <rw/debug.hpp>
+
+#include "data/CollisionModel.hpp"
+#include "data/ModelData.hpp"
+#include "objects/GameObject.hpp"
+
+namespace {
+/// How far a model without collision is assumed to reach
+constexpr float kDefaultModelReach = 100.f;
+/// Added to the collision bounds, which can be smaller than the model
+constexpr float kModelReachMargin = 10.f;
+
+int32_t cellCoordinate(float position, float cellSize) {
+    return static_cast<int32_t>(std::floor(position / cellSize));
+}
+
+uint64_t makeKey(int32_t x, int32_t y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+}
+
+float modelReach(const SimpleModelInfo* modelinfo) {
+    if (!modelinfo) {
+        return kDefaultModelReach;
+    }
+
+    // LOD models have no collision of their own, but cover the same area as
+    // the model they stand in for
+    auto collision = modelinfo->getCollision();
+    if (!collision && modelinfo->related()) {
+        collision = modelinfo->related()->getCollision();
+    }
+    if (!collision) {
+        return kDefaultModelReach;
+    }
+
+    const auto& sphere = collision->boundingSphere;
+    return glm::length(sphere.center) + sphere.radius + kModelReachMargin;
+}
+
+float modelDrawDistance(const SimpleModelInfo* modelinfo) {
+    if (!modelinfo) {
+        return std::numeric_limits<float>::max();
+    }
+    return modelinfo->getLargestLodDistance();
+}
+
+/// Grows the cell's reach and draw distance to cover the model
+void includeModel(InstanceGrid::Cell& cell, const SimpleModelInfo* modelinfo) {
+    cell.radius = std::max(cell.radius, modelReach(modelinfo));
+    cell.drawDistance =
+        std::max(cell.drawDistance, modelDrawDistance(modelinfo));
+}
+
+void removeFromCell(InstanceGrid::Cell& cell, GameObject* object) {
+    auto& objects = cell.objects;
+    auto it = std::find(objects.begin(), objects.end(), object);
+    RW_CHECK(it != objects.end(), "Object missing from its cell");
+    if (it != objects.end()) {
+        *it = objects.back();
+        objects.pop_back();
+    }
+}
+}  // namespace
+
+InstanceGrid::InstanceGrid(float cellSize) : cellSize_(cellSize) {
+}
+
+InstanceGrid::CellKey InstanceGrid::cellAt(const glm::vec3& position) const {
+    return makeKey(cellCoordinate(position.x, cellSize_),
+                   cellCoordinate(position.y, cellSize_));
+}
+
+size_t InstanceGrid::addToCell(GameObject* object) {
+    const auto& position = object->getPosition();
+    auto key = cellAt(position);
+    auto found = cellIndices_.emplace(key, cells_.size());
+    if (found.second) {
+        cells_.emplace_back();
+        cells_.back().min = position;
+        cells_.back().max = position;
+    }
+
+    auto index = found.first->second;
+    auto& cell = cells_[index];
+    cell.objects.push_back(object);
+    cell.min = glm::min(cell.min, position);
+    cell.max = glm::max(cell.max, position);
+    includeModel(cell, object->getModelInfo<SimpleModelInfo>());
+    return index;
+}
+
+void InstanceGrid::insert(GameObject* object) {
+    if (objectCells_.find(object) != objectCells_.end()) {
+        update(object);
+        return;
+    }
+    objectCells_.emplace(object, addToCell(object));
+}
+
+void InstanceGrid::remove(GameObject* object) {
+    auto it = objectCells_.find(object);
+    if (it == objectCells_.end()) {
+        return;
+    }
+
+    removeFromCell(cells_[it->second], object);
+    objectCells_.erase(it);
+}
+
+void InstanceGrid::update(GameObject* object) {
+    auto it = objectCells_.find(object);
+    if (it == objectCells_.end()) {
+        return;
+    }
+
+    // The cell's bounds only grow, so an object moving inside its cell has
+    // to extend them as well
+    auto& current = cells_[it->second];
+    auto key = cellAt(object->getPosition());
+    auto target = cellIndices_.find(key);
+    if (target != cellIndices_.end() && target->second == it->second) {
+        current.min = glm::min(current.min, object->getPosition());
+        current.max = glm::max(current.max, object->getPosition());
+        return;
+    }
+
+    removeFromCell(current, object);
+    it->second = addToCell(object);
+}
+
+void InstanceGrid::refresh(GameObject* object) {
+    auto it = objectCells_.find(object);
+    if (it == objectCells_.end()) {
+        return;
+    }
+
+    // Like the bounds, the reach and draw distance only grow
+    includeModel(cells_[it->second], object->getModelInfo<SimpleModelInfo>());
+}
+
+void InstanceGrid::clear() {
+    cells_.clear();
+    cellIndices_.clear();
+    objectCells_.clear();
+}
@@ -0,0 +1,99 @@
+#ifndef _RWENGINE_INSTANCEGRID_HPP_
+#define _RWENGINE_INSTANCEGRID_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class GameObject;
+
+/**
+ * @brief Uniform grid of the world's instances, for culling them by cell.
+ *
+ * Each cell keeps the bounds of its objects and the furthest any of them can
+ * be drawn from, so the renderer can reject a whole cell against the view
+ * frustum and draw distance before looking at the objects inside it. Cells
+ * are kept in a flat array and never shrink, instances are moved between
+ * them by update().
+ */
+class InstanceGrid {
+public:
+    struct Cell {
+        std::vector<GameObject*> objects;
+
+        /// Bounds of the object positions
+        glm::vec3 min{};
+        glm::vec3 max{};
+
+        /// The furthest any object's model reaches from its position
+        float radius = 0.f;
+
+        /// The largest LOD distance of the objects' models
+        float drawDistance = 0.f;
+
+        glm::vec3 getCenter() const {
+            return (min + max) * 0.5f;
+        }
+
+        /// Radius of a sphere around the center containing every model
+        float getBoundingRadius() const {
+            return glm::length(max - min) * 0.5f + radius;
+        }
+    };
+
+    explicit InstanceGrid(float cellSize);
+
+    /**
+     * @brief insert Adds an object at its current position
+     */
+    void insert(GameObject* object);
+
+    /**
+     * @brief remove Removes an object, if it has been added
+     */
+    void remove(GameObject* object);
+
+    /**
+     * @brief update Moves an object to the cell for its current position,
+     * does nothing if the object hasn't been added
+     */
+    void update(GameObject* object);
+
+    /**
+     * @brief refresh Extends an object's cell to cover its current model,
+     * called when the model changes. Does nothing if the object hasn't been
+     * added
+     */
+    void refresh(GameObject* object);
+
+    void clear();
+
+    size_t size() const {
+        return objectCells_.size();
+    }
+
+    const std::vector<Cell>& getCells() const {
+        return cells_;
+    }
+
+private:
+    using CellKey = uint64_t;
+
+    CellKey cellAt(const glm::vec3& position) const;
+
+    /// Adds the object to a cell, creating the cell if needed
+    size_t addToCell(GameObject* object);
+
+    float cellSize_;
+
+    std::vector<Cell> cells_;
+    std::unordered_map<CellKey, size_t> cellIndices_;
+
+    /// The index of the cell each object was last placed in
+    std::unordered_map<GameObject*, size_t> objectCells_;
+};
+
+#endif
@@ -0,0 +1,185 @@
+#include "engine/ModelStreamer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <platform/FileIndex.hpp>
+#include <rw/debug.hpp>
+
+#include "core/Profiler.hpp"
+
+namespace {
+constexpr size_t kPageSize = 4096;
+
+/// Touch every page of a mapped file so that the reads happen on the worker
+void prefault(const FileContentsInfo& file) {
+    if (!file.data) {
+        return;
+    }
+    const volatile char* data = file.data.get();
+    char sink = 0;
+    for (size_t offset = 0; offset < file.length; offset += kPageSize) {
+        sink ^= data[offset];
+    }
+    RW_UNUSED(sink);
+}
+
+FileContentsInfo openStreamedFile(FileIndex& index, const std::string& name) {
+    if (name.empty()) {
+        return {nullptr, 0};
+    }
+    try {
+        auto file = index.openFile(name);
+        prefault(file);
+        return file;
+    } catch (const std::runtime_error& ex) {
+        RW_ERROR("Failed to stream " << name << ": " << ex.what());
+        return {nullptr, 0};
+    }
+}
+
+std::unique_ptr<ClumpData> parseStreamedModel(const std::string& name,
+                                              const FileContentsInfo& file) {
+    if (!file.data) {
+        return nullptr;
+    }
+    try {
+        return std::make_unique<ClumpData>(LoaderDFF::parse(file));
+    } catch (DFFLoaderException& ex) {
+        RW_UNUSED(name);
+        RW_ERROR("Failed to parse " << name << ": " << ex.which());
+        return nullptr;
+    }
+}
+}  // namespace
+
+ModelStreamer::ModelStreamer(FileIndex& index,
+                             const TextureLoader& textureLoader,
+                             unsigned int workers)
+    : index_(index), textureLoader_(textureLoader) {
+    workers = std::max(workers, 1u);
+    for (unsigned int i = 0; i < workers; ++i) {
+        workers_.emplace_back([this]() { work(); });
+    }
+}
+
+ModelStreamer::~ModelStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queued_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ModelStreamer::request(Request&& request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.count(request.model)) {
+            // Move the request to a higher priority queue if it hasn't started
+            auto wanted = static_cast<size_t>(request.priority);
+            for (size_t q = 0; q < wanted; ++q) {
+                auto& queue = queues_[q];
+                auto it = std::find_if(queue.begin(), queue.end(),
+                                       [&](const Request& r) {
+                                           return r.model == request.model;
+                                       });
+                if (it != queue.end()) {
+                    it->priority = request.priority;
+                    queues_[wanted].push_back(std::move(*it));
+                    queue.erase(it);
+                    break;
+                }
+            }
+            return;
+        }
+
+        pending_.insert(request.model);
+        queues_[static_cast<size_t>(request.priority)].push_back(
+            std::move(request));
+    }
+    queued_.notify_one();
+}
+
+bool ModelStreamer::cancel(ModelID model) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& queue : queues_) {
+        auto it = std::find_if(queue.begin(), queue.end(),
+                               [&](const Request& r) { return r.model == model; });
+        if (it != queue.end()) {
+            queue.erase(it);
+            pending_.erase(model);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModelStreamer::isPending(ModelID model) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.count(model) != 0;
+}
+
+size_t ModelStreamer::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+std::vector<ModelStreamer::Result> ModelStreamer::collect(size_t byteBudget,
+                                                          bool wait) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (wait) {
+        completed_.wait(lock, [&]() { return results_.size() == pending_.size(); });
+    }
+
+    std::vector<Result> collected;
+    size_t bytes = 0;
+    while (!results_.empty() && (wait || bytes < byteBudget)) {
+        auto& result = results_.front();
+        bytes += result.modelData.length + result.textureData.length;
+        pending_.erase(result.model);
+        collected.push_back(std::move(result));
+        results_.pop_front();
+    }
+    return collected;
+}
+
+void ModelStreamer::work() {
+    RW_PROFILE_THREAD("ModelStreamer");
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto next = queues_.rend();
+            queued_.wait(lock, [&]() {
+                next = std::find_if(
+                    queues_.rbegin(), queues_.rend(),
+                    [](const std::deque<Request>& q) { return !q.empty(); });
+                return stopping_ || next != queues_.rend();
+            });
+            if (stopping_) {
+                return;
+            }
+            request = std::move(next->front());
+            next->pop_front();
+        }
+
+        Result result{request.model, request.modelFile, request.textureFile,
+                      openStreamedFile(index_, request.modelFile),
+                      openStreamedFile(index_, request.textureFile), nullptr,
+                      {}};
+        result.clump = parseStreamedModel(result.modelFile, result.modelData);
+        if (result.textureData.data) {
+            result.textures = textureLoader_.parse(result.textureData);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            results_.push_back(std::move(result));
+        }
+        completed_.notify_all();
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef _RWENGINE_MODELSTREAMER_HPP_
+#define _RWENGINE_MODELSTREAMER_HPP_
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <loaders/LoaderDFF.hpp>
+#include <loaders/LoaderTXD.hpp>
+#include <platform/FileHandle.hpp>
+
+#include <data/ModelData.hpp>
+
+class FileIndex;
+
+enum class StreamingPriority {
+    /// Models that are not needed to continue, e.g. map instances
+    Low = 0,
+    Normal = 1,
+    /// Models that are about to be needed, e.g. model swaps
+    High = 2,
+};
+
+/**
+ * @brief Reads model and texture files on background threads.
+ *
+ * Requests are made from the main thread and serviced by a small pool of
+ * worker threads, in priority order. Models are parsed and textures decoded
+ * on the worker as well; completed requests are collected on the main thread,
+ * which is responsible for turning the data into GL objects.
+ */
+class ModelStreamer {
+public:
+    struct Request {
+        ModelID model;
+        /// File name of the model, e.g. "landstal.dff"
+        std::string modelFile;
+        /// Texture archive to load alongside, empty if already resident
+        std::string textureFile;
+        StreamingPriority priority;
+    };
+
+    struct Result {
+        ModelID model;
+        std::string modelFile;
+        std::string textureFile;
+        FileContentsInfo modelData;
+        FileContentsInfo textureData;
+        /// Parsed model, null if it couldn't be read
+        std::unique_ptr<ClumpData> clump;
+        /// Decoded textures, empty if no texture archive was read
+        std::vector<DecodedTexture> textures;
+    };
+
+    /**
+     * @param textureLoader Decodes streamed textures, must outlive this
+     */
+    ModelStreamer(FileIndex& index, const TextureLoader& textureLoader,
+                  unsigned int workers);
+    ~ModelStreamer();
+
+    ModelStreamer(const ModelStreamer&) = delete;
+    ModelStreamer& operator=(const ModelStreamer&) = delete;
+
+    /**
+     * @brief request Queue a model to be read in the background
+     *
+     * If the model is already queued its priority is raised if needed.
+     */
+    void request(Request&& request);
+
+    /**
+     * @brief cancel Removes a queued request that hasn't been started yet
+     * @return true if the request was removed
+     */
+    bool cancel(ModelID model);
+
+    /**
+     * @return true if the model has been requested and not yet collected
+     */
+    bool isPending(ModelID model) const;
+
+    /**
+     * @return the number of requests not yet collected
+     */
+    size_t getPendingCount() const;
+
+    /**
+     * @brief collect Takes completed requests
+     * @param byteBudget Stop collecting once this many bytes are taken; at
+     * least one result is always returned if available
+     * @param wait Block until all outstanding requests have completed
+     */
+    std::vector<Result> collect(size_t byteBudget, bool wait = false);
+
+private:
+    void work();
+
+    FileIndex& index_;
+    const TextureLoader& textureLoader_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable queued_;
+    std::condition_variable completed_;
+    bool stopping_ = false;
+
+    std::array<std::deque<Request>, 3> queues_;
+    std::deque<Result> results_;
+    /// Models that are queued, in flight or completed but not collected
+    std::unordered_set<ModelID> pending_;
+
+    std::vector<std::thread> workers_;
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include "engine/ResidencyManager.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "data/ModelData.hpp"
+
+constexpr uint32_t ResidencyManager::kMinIdleFrames;
+constexpr uint32_t ResidencyManager::kEvictionInterval;
+
+void ResidencyManager::addModel(BaseModelInfo* info, const std::string& slot,
+                                size_t bytes) {
+    if (models_.find(info) != models_.end()) {
+        removeModel(info);
+    }
+
+    // Give the model a chance to be drawn before it can be evicted
+    info->markUsed(frame_);
+    models_[info] = {slot, bytes};
+    modelBytes_ += bytes;
+
+    auto it = slots_.find(slot);
+    if (it != slots_.end()) {
+        it->second.users++;
+    }
+}
+
+void ResidencyManager::addTextureSlot(const std::string& slot, size_t bytes) {
+    auto it = slots_.find(slot);
+    if (it != slots_.end()) {
+        textureBytes_ -= it->second.bytes;
+        slots_.erase(it);
+    }
+
+    SlotEntry entry{bytes};
+    entry.unusedSince = frame_;
+    for (const auto& model : models_) {
+        if (model.second.slot == slot) {
+            entry.users++;
+        }
+    }
+    slots_.emplace(slot, entry);
+    textureBytes_ += bytes;
+}
+
+bool ResidencyManager::isEvictable(const BaseModelInfo* info) const {
+    if (frame_ - info->getLastUsedFrame() < kMinIdleFrames) {
+        return false;
+    }
+
+    // Map instances set their model up again when it streams back in, other
+    // objects need it loaded for as long as they exist
+    return info->type() == ModelDataType::SimpleInfo ||
+           info->getReferenceCount() == 0;
+}
+
+void ResidencyManager::removeModel(BaseModelInfo* info) {
+    auto it = models_.find(info);
+    if (it == models_.end()) {
+        return;
+    }
+
+    modelBytes_ -= it->second.bytes;
+    auto slot = slots_.find(it->second.slot);
+    if (slot != slots_.end() && slot->second.users > 0) {
+        if (--slot->second.users == 0) {
+            slot->second.unusedSince = frame_;
+        }
+    }
+    models_.erase(it);
+}
+
+void ResidencyManager::evictUnusedSlots(Evictions& evictions) {
+    std::vector<std::pair<uint32_t, std::string>> unused;
+    for (const auto& slot : slots_) {
+        if (slot.second.users == 0) {
+            unused.emplace_back(slot.second.unusedSince, slot.first);
+        }
+    }
+    std::sort(unused.begin(), unused.end());
+
+    for (const auto& slot : unused) {
+        if (!overTextureBudget()) {
+            break;
+        }
+        textureBytes_ -= slots_[slot.second].bytes;
+        slots_.erase(slot.second);
+        evictions.textureSlots.push_back(slot.second);
+    }
+}
+
+ResidencyManager::Evictions ResidencyManager::evict() {
+    Evictions evictions;
+    if (!overModelBudget() && !overTextureBudget()) {
+        return evictions;
+    }
+    if (frame_ - lastEviction_ < kEvictionInterval) {
+        return evictions;
+    }
+    lastEviction_ = frame_;
+
+    std::vector<BaseModelInfo*> unloaded;
+    std::vector<BaseModelInfo*> candidates;
+    for (const auto& model : models_) {
+        if (!model.first->isLoaded()) {
+            unloaded.push_back(model.first);
+        } else if (isEvictable(model.first)) {
+            candidates.push_back(model.first);
+        }
+    }
+    for (auto info : unloaded) {
+        removeModel(info);
+    }
+
+    if (overTextureBudget()) {
+        evictUnusedSlots(evictions);
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const BaseModelInfo* a, const BaseModelInfo* b) {
+                  return a->getLastUsedFrame() < b->getLastUsedFrame();
+              });
+
+    for (auto info : candidates) {
+        if (!overModelBudget() && !overTextureBudget()) {
+            break;
+        }
+
+        auto slot = slots_.find(models_[info].slot);
+        bool freesSlot = slot != slots_.end() && slot->second.users == 1;
+        if (!overModelBudget() && !freesSlot) {
+            // Only models that free their texture slot help now
+            continue;
+        }
+
+        removeModel(info);
+        evictions.models.push_back(info);
+
+        if (freesSlot && overTextureBudget()) {
+            textureBytes_ -= slot->second.bytes;
+            evictions.textureSlots.push_back(slot->first);
+            slots_.erase(slot);
+        }
+    }
+
+    return evictions;
+}
+
+size_t ResidencyManager::estimateTextureBytes(const TextureArchive& textures) {
+    size_t bytes = 0;
+    for (const auto& texture : textures) {
+        if (!texture.second) {
+            continue;
+        }
+        bytes += texture.second->getMemorySize();
+    }
+    return bytes;
+}
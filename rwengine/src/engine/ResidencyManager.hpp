@@ -0,0 +1,150 @@
+#ifndef _RWENGINE_RESIDENCYMANAGER_HPP_
+#define _RWENGINE_RESIDENCYMANAGER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gl/TextureData.hpp>
+
+class BaseModelInfo;
+
+/**
+ * @brief Tracks the memory used by streamed models and texture slots, and
+ * picks which to unload when over budget.
+ *
+ * Models are evicted least recently used first, using the frame they were
+ * last drawn in. Models that objects such as peds and vehicles hold a
+ * reference to are kept, as are models used in the last few frames. A
+ * texture slot can only be evicted once no resident model uses it. Models
+ * and slots that were never added, like those loaded at startup, are never
+ * evicted.
+ *
+ * Only the bookkeeping is done here, the caller unloads what evict()
+ * returns and streams it back in when it is wanted again.
+ */
+class ResidencyManager {
+public:
+    /// Models used in this many frames are never evicted
+    static constexpr uint32_t kMinIdleFrames = 60;
+    /// Frames between looking for models to evict while over budget
+    static constexpr uint32_t kEvictionInterval = 30;
+
+    /**
+     * Limits in bytes, zero for no limit
+     */
+    struct Budget {
+        /// Vertex and index data of model geometry
+        size_t modelBytes = 0;
+        /// Estimated size of textures
+        size_t textureBytes = 0;
+    };
+
+    struct Evictions {
+        std::vector<BaseModelInfo*> models;
+        std::vector<std::string> textureSlots;
+    };
+
+    void setBudget(const Budget& budget) {
+        budget_ = budget;
+    }
+
+    const Budget& getBudget() const {
+        return budget_;
+    }
+
+    /**
+     * @brief addModel Starts tracking a loaded model
+     * @param slot The texture slot the model uses
+     * @param bytes Size of the model's geometry
+     */
+    void addModel(BaseModelInfo* info, const std::string& slot, size_t bytes);
+
+    /**
+     * @brief addTextureSlot Starts tracking a texture slot loaded for a model
+     */
+    void addTextureSlot(const std::string& slot, size_t bytes);
+
+    /**
+     * @brief nextFrame Advances the frame that models are marked used in
+     */
+    void nextFrame() {
+        frame_++;
+    }
+
+    uint32_t getFrame() const {
+        return frame_;
+    }
+
+    /**
+     * @brief evict Chooses models and texture slots to unload to get back
+     * under budget, and stops tracking them
+     *
+     * Models that have been unloaded by other means are dropped as well.
+     */
+    Evictions evict();
+
+    size_t getModelBytes() const {
+        return modelBytes_;
+    }
+
+    size_t getTextureBytes() const {
+        return textureBytes_;
+    }
+
+    size_t getModelCount() const {
+        return models_.size();
+    }
+
+    size_t getTextureSlotCount() const {
+        return slots_.size();
+    }
+
+    /**
+     * @brief estimateTextureBytes Sums the video memory used by textures
+     */
+    static size_t estimateTextureBytes(const TextureArchive& textures);
+
+private:
+    struct ModelEntry {
+        std::string slot;
+        size_t bytes;
+    };
+
+    struct SlotEntry {
+        size_t bytes;
+        /// Resident models using the slot
+        size_t users = 0;
+        /// When the last user was evicted
+        uint32_t unusedSince = 0;
+    };
+
+    bool overModelBudget() const {
+        return budget_.modelBytes != 0 && modelBytes_ > budget_.modelBytes;
+    }
+
+    bool overTextureBudget() const {
+        return budget_.textureBytes != 0 &&
+               textureBytes_ > budget_.textureBytes;
+    }
+
+    bool isEvictable(const BaseModelInfo* info) const;
+
+    void removeModel(BaseModelInfo* info);
+
+    void evictUnusedSlots(Evictions& evictions);
+
+    Budget budget_;
+    uint32_t frame_ = kMinIdleFrames;
+    uint32_t lastEviction_ = 0;
+
+    size_t modelBytes_ = 0;
+    size_t textureBytes_ = 0;
+
+    std::unordered_map<BaseModelInfo*, ModelEntry> models_;
+    std::unordered_map<std::string, SlotEntry> slots_;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "engine/SpatialHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <rw/debug.hpp>
+
+#include "objects/GameObject.hpp"
+
+namespace {
+int32_t cellCoordinate(float position, float cellSize) {
+    return static_cast<int32_t>(std::floor(position / cellSize));
+}
+
+uint64_t makeKey(int32_t x, int32_t y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+}
+
+void removeFromCell(std::vector<GameObject*>& cell, GameObject* object) {
+    auto it = std::find(cell.begin(), cell.end(), object);
+    RW_CHECK(it != cell.end(), "Object missing from its cell");
+    if (it != cell.end()) {
+        *it = cell.back();
+        cell.pop_back();
+    }
+}
+}  // namespace
+
+SpatialHash::SpatialHash(float cellSize) : cellSize_(cellSize) {
+}
+
+SpatialHash::CellKey SpatialHash::cellAt(const glm::vec3& position) const {
+    return makeKey(cellCoordinate(position.x, cellSize_),
+                   cellCoordinate(position.y, cellSize_));
+}
+
+void SpatialHash::insert(GameObject* object) {
+    auto key = cellAt(object->getPosition());
+    if (!objectCells_.emplace(object, key).second) {
+        update(object);
+        return;
+    }
+    cells_[key].push_back(object);
+}
+
+void SpatialHash::remove(GameObject* object) {
+    auto it = objectCells_.find(object);
+    if (it == objectCells_.end()) {
+        return;
+    }
+
+    auto cell = cells_.find(it->second);
+    if (cell != cells_.end()) {
+        removeFromCell(cell->second, object);
+        if (cell->second.empty()) {
+            cells_.erase(cell);
+        }
+    }
+    objectCells_.erase(it);
+}
+
+void SpatialHash::update(GameObject* object) {
+    auto it = objectCells_.find(object);
+    if (it == objectCells_.end()) {
+        return;
+    }
+
+    auto key = cellAt(object->getPosition());
+    if (key == it->second) {
+        return;
+    }
+
+    auto cell = cells_.find(it->second);
+    if (cell != cells_.end()) {
+        removeFromCell(cell->second, object);
+        if (cell->second.empty()) {
+            cells_.erase(cell);
+        }
+    }
+    cells_[key].push_back(object);
+    it->second = key;
+}
+
+template <class Visitor>
+void SpatialHash::visitCells(const glm::vec3& min, const glm::vec3& max,
+                             Visitor&& visit) const {
+    auto minX = cellCoordinate(min.x, cellSize_);
+    auto maxX = cellCoordinate(max.x, cellSize_);
+    auto minY = cellCoordinate(min.y, cellSize_);
+    auto maxY = cellCoordinate(max.y, cellSize_);
+
+    for (auto x = minX; x <= maxX; ++x) {
+        for (auto y = minY; y <= maxY; ++y) {
+            auto cell = cells_.find(makeKey(x, y));
+            if (cell == cells_.end()) {
+                continue;
+            }
+            for (auto object : cell->second) {
+                visit(object);
+            }
+        }
+    }
+}
+
+void SpatialHash::queryRadius(const glm::vec3& center, float radius,
+                              std::vector<GameObject*>& result) const {
+    auto radius2 = radius * radius;
+    visitCells(center - glm::vec3(radius), center + glm::vec3(radius),
+               [&](GameObject* object) {
+                   auto offset = object->getPosition() - center;
+                   if (glm::dot(offset, offset) <= radius2) {
+                       result.push_back(object);
+                   }
+               });
+}
+
+void SpatialHash::queryBox(const glm::vec3& min, const glm::vec3& max,
+                           std::vector<GameObject*>& result) const {
+    visitCells(min, max, [&](GameObject* object) {
+        const auto& position = object->getPosition();
+        if (glm::all(glm::greaterThanEqual(position, min)) &&
+            glm::all(glm::lessThanEqual(position, max))) {
+            result.push_back(object);
+        }
+    });
+}
+
+void SpatialHash::queryCone(const glm::vec3& apex, const glm::vec3& direction,
+                            float length, float angle,
+                            std::vector<GameObject*>& result) const {
+    auto length2 = length * length;
+    auto cosAngle = std::cos(angle);
+    visitCells(apex - glm::vec3(length), apex + glm::vec3(length),
+               [&](GameObject* object) {
+                   auto offset = object->getPosition() - apex;
+                   auto distance2 = glm::dot(offset, offset);
+                   if (distance2 > length2) {
+                       return;
+                   }
+                   // Compare cosines without normalizing the offset
+                   auto along = glm::dot(offset, direction);
+                   if (along >= 0.f &&
+                       along * along >= cosAngle * cosAngle * distance2) {
+                       result.push_back(object);
+                   }
+               });
+}
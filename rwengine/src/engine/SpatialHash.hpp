@@ -0,0 +1,90 @@
+#ifndef _RWENGINE_SPATIALHASH_HPP_
+#define _RWENGINE_SPATIALHASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class GameObject;
+
+/**
+ * @brief Uniform grid of objects for finding the objects near a point.
+ *
+ * Objects are bucketed by their position on the ground plane into square
+ * cells, so a query only has to test the objects in the cells it overlaps.
+ * Objects must be updated whenever they move; this is done by
+ * GameObject::positionChanged for the objects in GameWorld::spatialIndex.
+ */
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize);
+
+    /**
+     * @brief insert Adds an object at its current position
+     */
+    void insert(GameObject* object);
+
+    /**
+     * @brief remove Removes an object, if it has been added
+     */
+    void remove(GameObject* object);
+
+    /**
+     * @brief update Moves an object to the cell for its current position,
+     * does nothing if the object hasn't been added
+     */
+    void update(GameObject* object);
+
+    size_t size() const {
+        return objectCells_.size();
+    }
+
+    /**
+     * @brief queryRadius Finds the objects within a sphere
+     * @param result Objects are appended to this
+     */
+    void queryRadius(const glm::vec3& center, float radius,
+                     std::vector<GameObject*>& result) const;
+
+    /**
+     * @brief queryBox Finds the objects within an axis aligned box
+     * @param result Objects are appended to this
+     */
+    void queryBox(const glm::vec3& min, const glm::vec3& max,
+                  std::vector<GameObject*>& result) const;
+
+    /**
+     * @brief queryCone Finds the objects within a cone
+     * @param apex The point of the cone
+     * @param direction Normalized direction the cone points in
+     * @param length Maximum distance from the apex
+     * @param angle Angle between the direction and the side, in radians, no
+     * more than half pi
+     * @param result Objects are appended to this
+     */
+    void queryCone(const glm::vec3& apex, const glm::vec3& direction,
+                   float length, float angle,
+                   std::vector<GameObject*>& result) const;
+
+private:
+    using CellKey = uint64_t;
+
+    CellKey cellAt(const glm::vec3& position) const;
+
+    /// Calls visit with each object in the cells overlapping min to max
+    template <class Visitor>
+    void visitCells(const glm::vec3& min, const glm::vec3& max,
+                    Visitor&& visit) const;
+
+    float cellSize_;
+
+    std::unordered_map<CellKey, std::vector<GameObject*>> cells_;
+
+    /// The cell each object was last placed in
+    std::unordered_map<GameObject*, CellKey> objectCells_;
+};
+
+#endif
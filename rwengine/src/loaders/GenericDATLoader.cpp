@@ -2,189 +2,173 @@
 
 #include <algorithm>
 #include <cctype>
-#include <fstream>
 #include <iterator>
-#include <sstream>
 
 #include <rw/debug.hpp>
 
 #include <data/ModelData.hpp>
 #include <data/WeaponData.hpp>
+#include <loaders/TextTokenizer.hpp>
 #include <objects/VehicleInfo.hpp>
 
 void GenericDATLoader::loadDynamicObjects(const std::string& name,
                                           DynamicObjectDataPtrs& data) {
-    std::ifstream dfile(name.c_str());
-
-    if (dfile.is_open()) {
-        std::string lineBuff;
-
-        while (std::getline(dfile, lineBuff)) {
-            if (lineBuff.at(0) == ';') continue;
-            if (lineBuff.at(0) == '*') continue;
-            std::stringstream ss(lineBuff);
-
-            auto dyndata = std::make_shared<DynamicObjectData>();
-
-            ss >> dyndata->modelName;
-            auto cpos = dyndata->modelName.find(',');
-            if (cpos != dyndata->modelName.npos) {
-                dyndata->modelName.erase(cpos);
-            }
-            ss >> dyndata->mass;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> dyndata->turnMass;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> dyndata->airRes;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> dyndata->elasticity;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> dyndata->buoyancy;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> dyndata->uprootForce;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> dyndata->collDamageMulti;
-            if (ss.peek() == ',') ss.ignore(1);
-            int tmp;
-            ss >> tmp;
-            dyndata->collDamageEffect = tmp;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> tmp;
-            dyndata->collResponseFlags = tmp;
-            if (ss.peek() == ',') ss.ignore(1);
-            ss >> dyndata->cameraAvoid;
-
-            RW_CHECK(ss.eof() || ss.good(), "Loading dynamicsObject data file " << name << " failed");
-
-            data.insert({dyndata->modelName, dyndata});
-        }
+    std::string text;
+    if (!TextTokenizer::readFile(name, text)) {
+        return;
+    }
+
+    TextTokenizer dfile(text);
+    while (dfile.nextLine()) {
+        auto line = dfile.line();
+        if (line.empty()) continue;
+        if (line[0] == ';') continue;
+        if (line[0] == '*') continue;
+
+        auto dyndata = std::make_shared<DynamicObjectData>();
+
+        dyndata->modelName = dfile.nextString();
+        dyndata->mass = dfile.nextFloat();
+        dyndata->turnMass = dfile.nextFloat();
+        dyndata->airRes = dfile.nextFloat();
+        dyndata->elasticity = dfile.nextFloat();
+        dyndata->buoyancy = dfile.nextFloat();
+        dyndata->uprootForce = dfile.nextFloat();
+        dyndata->collDamageMulti = dfile.nextFloat();
+        dyndata->collDamageEffect = dfile.nextInt();
+        dyndata->collResponseFlags = dfile.nextInt();
+        dyndata->cameraAvoid = dfile.nextInt() != 0;
+
+        RW_CHECK(!dfile.hasError(), "Loading dynamicsObject data file " << name << " failed");
+
+        data.insert({dyndata->modelName, dyndata});
     }
 }
 
 void GenericDATLoader::loadWeapons(const std::string& name,
                                    WeaponDataPtrs& weaponData) {
-    std::ifstream dfile(name.c_str());
-
-    if (dfile.is_open()) {
-        std::string linebuffer;
-        int slotNum = 0;
-
-        while (std::getline(dfile, linebuffer)) {
-            if (linebuffer[0] == '#') continue;
-            std::stringstream ss(linebuffer);
-
-            auto data = std::make_shared<WeaponData>();
-            ss >> data->name;
-            if (data->name == "ENDWEAPONDATA") continue;
-
-            // Skip lines with blank names (probably an empty line).
-            if (std::find_if(data->name.begin(), data->name.end(), ::isalnum) ==
-                std::end(data->name)) {
-                continue;
-            }
-
-            std::transform(data->name.begin(), data->name.end(),
-                           data->name.begin(), ::tolower);
-
-            std::string firetype;
-            ss >> firetype;
-            if (firetype == "MELEE") {
-                data->fireType = WeaponData::MELEE;
-            } else if (firetype == "INSTANT_HIT") {
-                data->fireType = WeaponData::INSTANT_HIT;
-            } else if (firetype == "PROJECTILE") {
-                data->fireType = WeaponData::PROJECTILE;
-            }
-
-            ss >> data->hitRange;
-            ss >> data->fireRate;
-            ss >> data->reloadMS;
-            ss >> data->clipSize;
-            ss >> data->damage;
-            ss >> data->speed;
-            ss >> data->meleeRadius;
-            ss >> data->lifeSpan;
-            ss >> data->spread;
-            ss >> data->fireOffset.x;
-            ss >> data->fireOffset.y;
-            ss >> data->fireOffset.z;
-            ss >> data->animation1;
-            std::transform(data->animation1.begin(), data->animation1.end(),
-                           data->animation1.begin(), ::tolower);
-            ss >> data->animation2;
-            std::transform(data->animation2.begin(), data->animation2.end(),
-                           data->animation2.begin(), ::tolower);
-            ss >> data->animLoopStart;
-            ss >> data->animLoopEnd;
-            ss >> data->animFirePoint;
-            ss >> data->animCrouchFirePoint;
-            ss >> data->modelID;
-            ss >> data->flags;
-
-            RW_CHECK(ss.eof() || ss.good(), "Loading weapon data file " << name << " failed");
-
-            data->inventorySlot = slotNum++;
-
-            weaponData.push_back(data);
+    std::string text;
+    if (!TextTokenizer::readFile(name, text)) {
+        return;
+    }
+
+    TextTokenizer dfile(text);
+    int slotNum = 0;
+
+    while (dfile.nextLine()) {
+        auto line = dfile.line();
+        if (!line.empty() && line[0] == '#') continue;
+
+        auto data = std::make_shared<WeaponData>();
+        data->name = dfile.nextString();
+        if (data->name == "ENDWEAPONDATA") continue;
+
+        // Skip lines with blank names (probably an empty line).
+        if (std::find_if(data->name.begin(), data->name.end(), ::isalnum) ==
+            std::end(data->name)) {
+            continue;
+        }
+
+        std::transform(data->name.begin(), data->name.end(),
+                       data->name.begin(), ::tolower);
+
+        auto firetype = dfile.nextField();
+        if (firetype == "MELEE") {
+            data->fireType = WeaponData::MELEE;
+        } else if (firetype == "INSTANT_HIT") {
+            data->fireType = WeaponData::INSTANT_HIT;
+        } else if (firetype == "PROJECTILE") {
+            data->fireType = WeaponData::PROJECTILE;
         }
+
+        data->hitRange = dfile.nextFloat();
+        data->fireRate = dfile.nextInt();
+        data->reloadMS = dfile.nextInt();
+        data->clipSize = dfile.nextInt();
+        data->damage = dfile.nextInt();
+        data->speed = dfile.nextFloat();
+        data->meleeRadius = dfile.nextFloat();
+        data->lifeSpan = dfile.nextFloat();
+        data->spread = dfile.nextFloat();
+        data->fireOffset.x = dfile.nextFloat();
+        data->fireOffset.y = dfile.nextFloat();
+        data->fireOffset.z = dfile.nextFloat();
+        data->animation1 = dfile.nextString();
+        std::transform(data->animation1.begin(), data->animation1.end(),
+                       data->animation1.begin(), ::tolower);
+        data->animation2 = dfile.nextString();
+        std::transform(data->animation2.begin(), data->animation2.end(),
+                       data->animation2.begin(), ::tolower);
+        data->animLoopStart = dfile.nextFloat();
+        data->animLoopEnd = dfile.nextFloat();
+        data->animFirePoint = dfile.nextFloat();
+        data->animCrouchFirePoint = dfile.nextFloat();
+        data->modelID = dfile.nextInt();
+        data->flags = dfile.nextUnsigned();
+
+        RW_CHECK(!dfile.hasError(), "Loading weapon data file " << name << " failed");
+
+        data->inventorySlot = slotNum++;
+
+        weaponData.push_back(data);
     }
 }
 
 void GenericDATLoader::loadHandling(const std::string& name,
                                     VehicleInfoPtrs& vehicleData) {
-    std::ifstream hndFile(name.c_str());
-
-    if (hndFile.is_open()) {
-        std::string lineBuff;
-
-        while (std::getline(hndFile, lineBuff)) {
-            if (lineBuff.at(0) == ';') continue;
-            std::stringstream ss(lineBuff);
-
-            VehicleHandlingInfo info;
-            ss >> info.ID;
-            ss >> info.mass;
-            ss >> info.dimensions.x;
-            ss >> info.dimensions.y;
-            ss >> info.dimensions.z;
-            ss >> info.centerOfMass.x;
-            ss >> info.centerOfMass.y;
-            ss >> info.centerOfMass.z;
-            ss >> info.percentSubmerged;
-            ss >> info.tractionMulti;
-            ss >> info.tractionLoss;
-            ss >> info.tractionBias;
-            ss >> info.numGears;
-            ss >> info.maxVelocity;
-            ss >> info.acceleration;
-            char dt, et;
-            ss >> dt;
-            ss >> et;
-            info.driveType = static_cast<VehicleHandlingInfo::DriveType>(dt);
-            info.engineType = static_cast<VehicleHandlingInfo::EngineType>(et);
-            ss >> info.brakeDeceleration;
-            ss >> info.brakeBias;
-            ss >> info.ABS;
-            ss >> info.steeringLock;
-            ss >> info.suspensionForce;
-            ss >> info.suspensionDamping;
-            ss >> info.seatOffset;
-            ss >> info.damageMulti;
-            ss >> info.value;
-            ss >> info.suspensionUpperLimit;
-            ss >> info.suspensionLowerLimit;
-            ss >> info.suspensionBias;
-            ss >> std::hex >> info.flags;
-
-            RW_CHECK(ss.eof() || ss.good(), "Loading handling data file " << name << " failed");
-
-            auto mit = vehicleData.find(info.ID);
-            if (mit == vehicleData.end()) {
-                vehicleData.insert({info.ID, std::make_shared<VehicleInfo>(VehicleInfo{
-                                                 info, {}, {}})});
-            } else {
-                mit->second->handling = info;
-            }
+    std::string text;
+    if (!TextTokenizer::readFile(name, text)) {
+        return;
+    }
+
+    TextTokenizer hndFile(text);
+    while (hndFile.nextLine()) {
+        auto line = hndFile.line();
+        if (line.empty()) continue;
+        if (line[0] == ';') continue;
+
+        VehicleHandlingInfo info;
+        info.ID = hndFile.nextString();
+        info.mass = hndFile.nextFloat();
+        info.dimensions.x = hndFile.nextFloat();
+        info.dimensions.y = hndFile.nextFloat();
+        info.dimensions.z = hndFile.nextFloat();
+        info.centerOfMass.x = hndFile.nextFloat();
+        info.centerOfMass.y = hndFile.nextFloat();
+        info.centerOfMass.z = hndFile.nextFloat();
+        info.percentSubmerged = hndFile.nextFloat();
+        info.tractionMulti = hndFile.nextFloat();
+        info.tractionLoss = hndFile.nextFloat();
+        info.tractionBias = hndFile.nextFloat();
+        info.numGears = hndFile.nextUnsigned();
+        info.maxVelocity = hndFile.nextFloat();
+        info.acceleration = hndFile.nextFloat();
+        info.driveType =
+            static_cast<VehicleHandlingInfo::DriveType>(hndFile.nextChar());
+        info.engineType =
+            static_cast<VehicleHandlingInfo::EngineType>(hndFile.nextChar());
+        info.brakeDeceleration = hndFile.nextFloat();
+        info.brakeBias = hndFile.nextFloat();
+        info.ABS = hndFile.nextInt() != 0;
+        info.steeringLock = hndFile.nextFloat();
+        info.suspensionForce = hndFile.nextFloat();
+        info.suspensionDamping = hndFile.nextFloat();
+        info.seatOffset = hndFile.nextFloat();
+        info.damageMulti = hndFile.nextFloat();
+        info.value = hndFile.nextUnsigned();
+        info.suspensionUpperLimit = hndFile.nextFloat();
+        info.suspensionLowerLimit = hndFile.nextFloat();
+        info.suspensionBias = hndFile.nextFloat();
+        info.flags = hndFile.nextUnsigned(16);
+
+        RW_CHECK(!hndFile.hasError(), "Loading handling data file " << name << " failed");
+
+        auto mit = vehicleData.find(info.ID);
+        if (mit == vehicleData.end()) {
+            vehicleData.insert({info.ID, std::make_shared<VehicleInfo>(VehicleInfo{
+                                             info, {}, {}})});
+        } else {
+            mit->second->handling = info;
         }
     }
 }
@@ -1,29 +1,28 @@
 #include "loaders/LoaderIDE.hpp"
 
 #include <algorithm>
-#include <cctype>
-#include <cstdlib>
-#include <fstream>
-#include <functional>
 #include <map>
-#include <sstream>
 #include <string>
 
 #include "data/PathData.hpp"
-
-#include <rw/casts.hpp>
+#include "loaders/TextTokenizer.hpp"
 
 bool LoaderIDE::load(const std::string &filename, const PedStatsList &stats) {
-    std::ifstream str(filename);
-    if (!str.is_open()) return false;
-    return load(str, stats);
+    std::string text;
+    if (!TextTokenizer::readFile(filename, text)) return false;
+    return load(TextTokenizer(text), stats);
+}
+
+bool LoaderIDE::load(std::istream &str, const PedStatsList &stats) {
+    auto text = TextTokenizer::readAll(str);
+    return load(TextTokenizer(text), stats);
 }
 
-bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
-    auto find_stat_id = [&](const std::string &name) {
+bool LoaderIDE::load(TextTokenizer &&text, const PedStatsList &stats) {
+    auto find_stat_id = [&](const StringRef &name) {
         auto it =
             std::find_if(stats.begin(), stats.end(),
-                         [&](const PedStats &a) { return a.name_ == name; });
+                         [&](const PedStats &a) { return name == a.name_.c_str(); });
         if (it == stats.end()) {
             return -1;
         }
@@ -31,13 +30,8 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
     };
 
     SectionTypes section = NONE;
-    while (!str.eof()) {
-        std::string line;
-        getline(str, line);
-        line.erase(std::find_if(line.rbegin(), line.rend(),
-                                [](auto c) { return !std::isspace(c); })
-                       .base(),
-                   line.end());
+    while (text.nextLine()) {
+        auto line = text.line();
 
         if (!line.empty() && line[0] == '#') continue;
 
@@ -60,13 +54,6 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
                 section = PATH;
             }
         } else {
-            // Remove ALL the whitespace!!
-            line.erase(remove_if(line.begin(), line.end(), isspace),
-                       line.end());
-
-            std::stringstream strstream(line);
-            std::string buff;
-
             switch (section) {
                 default:
                     break;
@@ -74,31 +61,25 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
                 case TOBJ: {  // Supports Type 1, 2 and 3
                     auto objs = std::make_unique<SimpleModelInfo>();
 
-                    getline(strstream, buff, ',');
-                    objs->setModelID(lexical_cast<int>(buff));
+                    objs->setModelID(text.nextInt());
 
-                    getline(strstream, objs->name, ',');
-                    getline(strstream, objs->textureslot, ',');
+                    objs->name = text.nextString();
+                    objs->textureslot = text.nextString();
 
-                    getline(strstream, buff, ',');
-                    objs->setNumAtomics(lexical_cast<int>(buff));
+                    objs->setNumAtomics(text.nextInt());
 
                     for (int i = 0; i < objs->getNumAtomics(); i++) {
-                        getline(strstream, buff, ',');
-                        objs->setLodDistance(i, lexical_cast<float>(buff));
+                        objs->setLodDistance(i, text.nextFloat());
                     }
 
                     objs->determineFurthest();
 
-                    getline(strstream, buff, ',');
-                    objs->flags = lexical_cast<int>(buff);
+                    objs->flags = text.nextInt();
 
                     // Keep reading TOBJ data
                     if (section == LoaderIDE::TOBJ) {
-                        getline(strstream, buff, ',');
-                        objs->timeOn = lexical_cast<int>(buff);
-                        getline(strstream, buff, ',');
-                        objs->timeOff = lexical_cast<int>(buff);
+                        objs->timeOn = text.nextInt();
+                        objs->timeOff = text.nextInt();
                     } else {
                         objs->timeOn = 0;
                         objs->timeOff = 24;
@@ -110,42 +91,33 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
                 case CARS: {
                     auto cars = std::make_unique<VehicleModelInfo>();
 
-                    getline(strstream, buff, ',');
-                    cars->setModelID(lexical_cast<int>(buff));
+                    cars->setModelID(text.nextInt());
 
-                    getline(strstream, cars->name, ',');
-                    getline(strstream, cars->textureslot, ',');
+                    cars->name = text.nextString();
+                    cars->textureslot = text.nextString();
 
-                    getline(strstream, buff, ',');
                     cars->vehicletype_ =
-                        VehicleModelInfo::findVehicleType(buff);
+                        VehicleModelInfo::findVehicleType(text.nextString());
 
-                    getline(strstream, cars->handling_, ',');
-                    getline(strstream, cars->vehiclename_, ',');
-                    getline(strstream, buff, ',');
+                    cars->handling_ = text.nextString();
+                    cars->vehiclename_ = text.nextString();
                     cars->vehicleclass_ =
-                        VehicleModelInfo::findVehicleClass(buff);
+                        VehicleModelInfo::findVehicleClass(text.nextString());
 
-                    getline(strstream, buff, ',');
-                    cars->frequency_ = lexical_cast<int>(buff);
+                    cars->frequency_ = text.nextInt();
 
-                    getline(strstream, buff, ',');
-                    cars->level_ = lexical_cast<int>(buff);
+                    cars->level_ = text.nextInt();
 
-                    getline(strstream, buff, ',');
-                    cars->componentrules_ = std::stoul(buff, nullptr, 16);
+                    cars->componentrules_ = text.nextUnsigned(16);
 
                     switch (cars->vehicletype_) {
                         case VehicleModelInfo::CAR:
-                            getline(strstream, buff, ',');
-                            cars->wheelmodel_ = lexical_cast<int>(buff);
-                            getline(strstream, buff, ',');
-                            cars->wheelscale_ = lexical_cast<float>(buff);
+                            cars->wheelmodel_ = text.nextInt();
+                            cars->wheelscale_ = text.nextFloat();
                             break;
                         case VehicleModelInfo::PLANE:
                             /// @todo load LOD
-                            getline(strstream, buff, ',');
-                            // cars->planeLOD_ = lexical_cast<int>(buff);
+                            // cars->planeLOD_ = text.nextInt();
                             break;
                         default:
                             break;
@@ -157,22 +129,17 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
                 case PEDS: {
                     auto peds = std::make_unique<PedModelInfo>();
 
-                    getline(strstream, buff, ',');
-                    peds->setModelID(lexical_cast<int>(buff));
+                    peds->setModelID(text.nextInt());
 
-                    getline(strstream, peds->name, ',');
-                    getline(strstream, peds->textureslot, ',');
+                    peds->name = text.nextString();
+                    peds->textureslot = text.nextString();
 
-                    getline(strstream, buff, ',');
-                    peds->pedtype_ = PedModelInfo::findPedType(buff);
+                    peds->pedtype_ = PedModelInfo::findPedType(text.nextString());
 
-                    std::string behaviour;
-                    getline(strstream, behaviour, ',');
-                    peds->statindex_ = find_stat_id(behaviour);
-                    getline(strstream, peds->animgroup_, ',');
+                    peds->statindex_ = find_stat_id(text.nextField());
+                    peds->animgroup_ = text.nextString();
 
-                    getline(strstream, buff, ',');
-                    peds->carsmask_ = lexical_cast<int>(buff, 16);
+                    peds->carsmask_ = text.nextInt(16);
 
                     objects.emplace(peds->id(), std::move(peds));
                     break;
@@ -180,29 +147,21 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
                 case PATH: {
                     PathData path;
 
-                    std::string type;
-                    getline(strstream, type, ',');
+                    auto type = text.nextField();
                     if (type == "ped") {
                         path.type = PathData::PATH_PED;
                     } else if (type == "car") {
                         path.type = PathData::PATH_CAR;
                     }
 
-                    std::string id;
-                    getline(strstream, id, ',');
-                    path.ID = lexical_cast<int>(id);
+                    path.ID = text.nextInt();
 
-                    getline(strstream, path.modelName);
+                    path.modelName = text.nextString();
 
-                    std::string linebuff, buff;
-                    for (size_t p = 0; p < 12; ++p) {
+                    for (size_t p = 0; p < 12 && text.nextLine(); ++p) {
                         PathNode node{};
 
-                        getline(str, linebuff);
-                        std::stringstream buffstream(linebuff);
-
-                        getline(buffstream, buff, ',');
-                        switch (lexical_cast<int>(buff)) {
+                        switch (text.nextInt()) {
                             case 0:
                                 node.type = PathNode::EMPTY;
                                 break;
@@ -218,28 +177,18 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
                             continue;
                         }
 
-                        getline(buffstream, buff, ',');
-                        node.next = lexical_cast<int>(buff);
-
-                        getline(buffstream, buff, ',');  // "Always 0"
-
-                        getline(buffstream, buff, ',');
-                        node.position.x = lexical_cast<float>(buff) / 16.f;
-
-                        getline(buffstream, buff, ',');
-                        node.position.y = lexical_cast<float>(buff) / 16.f;
+                        node.next = text.nextInt();
 
-                        getline(buffstream, buff, ',');
-                        node.position.z = lexical_cast<float>(buff) / 16.f;
+                        text.nextField();  // "Always 0"
 
-                        getline(buffstream, buff, ',');
-                        node.size = lexical_cast<float>(buff) / 16.f;
+                        node.position.x = text.nextFloat() / 16.f;
+                        node.position.y = text.nextFloat() / 16.f;
+                        node.position.z = text.nextFloat() / 16.f;
 
-                        getline(buffstream, buff, ',');
-                        node.leftLanes = lexical_cast<int>(buff);
+                        node.size = text.nextFloat() / 16.f;
 
-                        getline(buffstream, buff, ',');
-                        node.rightLanes = lexical_cast<int>(buff);
+                        node.leftLanes = text.nextInt();
+                        node.rightLanes = text.nextInt();
 
                         path.nodes.push_back(node);
                     }
@@ -253,11 +202,10 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
                 case HIER: {
                     auto hier = std::make_unique<ClumpModelInfo>();
 
-                    getline(strstream, buff, ',');
-                    hier->setModelID(lexical_cast<int>(buff));
+                    hier->setModelID(text.nextInt());
 
-                    getline(strstream, hier->name, ',');
-                    getline(strstream, hier->textureslot, ',');
+                    hier->name = text.nextString();
+                    hier->textureslot = text.nextString();
 
                     objects.emplace(hier->id(), std::move(hier));
                     break;
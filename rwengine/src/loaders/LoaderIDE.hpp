@@ -8,6 +8,8 @@
 #include <data/PedData.hpp>
 #include <data/ModelData.hpp>
 
+class TextTokenizer;
+
 class LoaderIDE {
 public:
     enum SectionTypes {
@@ -26,6 +28,8 @@ public:
 
     bool load(std::istream& data, const PedStatsList& stats);
 
+    bool load(TextTokenizer&& text, const PedStatsList& stats);
+
     /**
      * @brief objects loaded during the call to load()
      */
@@ -2,58 +2,75 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstddef>
 #include <memory>
 
-bool findKeyframes(float t, AnimationBone* bone, AnimationKeyframe& f1,
-                   AnimationKeyframe& f2, float& alpha) {
-    for (size_t f = 0; f < bone->frames.size(); ++f) {
-        if (t <= bone->frames[f].starttime) {
-            f2 = bone->frames[f];
-
-            if (f == 0) {
-                if (bone->frames.size() != 1) {
-                    f1 = bone->frames.back();
-                } else {
-                    f1 = f2;
-                }
-            } else {
-                f1 = bone->frames[f - 1];
-            }
-
-            float tdiff = (f2.starttime - f1.starttime);
-            if (tdiff == 0.f) {
-                alpha = 1.f;
-            } else {
-                alpha = glm::clamp((t - f1.starttime) / tdiff, 0.f, 1.f);
+namespace {
+/// Keyframes checked after the cursor before falling back to a search, time
+/// usually only moves on by a frame or two between samples
+constexpr size_t kCursorSteps = 4;
+}  // namespace
+
+size_t AnimationBone::findKeyframe(float time, size_t cursor) const {
+    const auto count = frames.size();
+    size_t first = 0;
+
+    // Moving forward from the cursor, so everything before it can be skipped
+    bool forward =
+        cursor < count && (cursor == 0 || frames[cursor - 1].starttime < time);
+    if (forward) {
+        const auto end = std::min(count, cursor + kCursorSteps);
+        for (auto f = cursor; f < end; ++f) {
+            if (time <= frames[f].starttime) {
+                return f;
             }
-
-            return true;
         }
+        first = end;
     }
-    return false;
+
+    auto begin = frames.begin() + static_cast<std::ptrdiff_t>(first);
+    auto it = std::lower_bound(
+        begin, frames.end(), time,
+        [](const AnimationKeyframe& frame, float t) {
+            return frame.starttime < t;
+        });
+    return static_cast<size_t>(it - frames.begin());
+}
+
+AnimationKeyframe AnimationBone::getInterpolatedKeyframe(float time) const {
+    size_t cursor = 0;
+    return getInterpolatedKeyframe(time, cursor);
 }
 
-AnimationKeyframe AnimationBone::getInterpolatedKeyframe(float time) {
-    AnimationKeyframe f1, f2;
-    float alpha;
+AnimationKeyframe AnimationBone::getInterpolatedKeyframe(
+    float time, size_t& cursor) const {
+    cursor = findKeyframe(time, cursor);
+    if (cursor >= frames.size()) {
+        return frames.back();
+    }
+
+    const auto& f2 = frames[cursor];
+    const auto& f1 = cursor > 0 ? frames[cursor - 1] : frames.back();
 
-    if (findKeyframes(time, this, f1, f2, alpha)) {
-        return {glm::normalize(glm::slerp(f1.rotation, f2.rotation, alpha)),
-                glm::mix(f1.position, f2.position, alpha),
-                glm::mix(f1.scale, f2.scale, alpha), time,
-                std::max(f1.id, f2.id)};
+    float alpha = 1.f;
+    float tdiff = (f2.starttime - f1.starttime);
+    if (tdiff != 0.f) {
+        alpha = glm::clamp((time - f1.starttime) / tdiff, 0.f, 1.f);
     }
 
-    return frames.back();
+    return {glm::normalize(glm::slerp(f1.rotation, f2.rotation, alpha)),
+            glm::mix(f1.position, f2.position, alpha),
+            glm::mix(f1.scale, f2.scale, alpha), time,
+            std::max(f1.id, f2.id)};
 }
 
-AnimationKeyframe AnimationBone::getKeyframe(float time) {
-    for (auto &frame : frames) {
-        if (time >= frame.starttime) {
-            return frame;
-        }
-    }
-    return frames.back();
+AnimationKeyframe AnimationBone::getKeyframe(float time) const {
+    auto it = std::upper_bound(
+        frames.begin(), frames.end(), time,
+        [](float t, const AnimationKeyframe& frame) {
+            return t < frame.starttime;
+        });
+    return it == frames.begin() ? frames.front() : *(it - 1);
 }
 
 bool LoaderIFP::loadFromMemory(char* data) {
@@ -72,6 +89,8 @@ bool LoaderIFP::loadFromMemory(char* data) {
         animation->duration = 0.f;
         animation->name = animname;
 
+        size_t memorySize = 0;
+
         size_t animstart = data_offs + 8;
         DGAN* animroot = read<DGAN>(data, dataI);
         std::string infoname = readString(data, dataI);
@@ -131,10 +150,14 @@ bool LoaderIFP::loadFromMemory(char* data) {
             std::transform(framename.begin(), framename.end(),
                            framename.begin(), ::tolower);
 
+            memorySize += sizeof(AnimationBone) +
+                          bonedata->frames.capacity() *
+                              sizeof(AnimationKeyframe);
             animation->bones.emplace(framename, std::move(bonedata));
         }
 
         data_offs = animstart + animroot->base.size;
+        animation->memory.resize(memorySize);
 
         std::transform(animname.begin(), animname.end(), animname.begin(),
                        ::tolower);
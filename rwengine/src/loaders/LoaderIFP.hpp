@@ -11,6 +11,7 @@
 #include <glm/gtc/quaternion.hpp>
 
 #include <rw/forward.hpp>
+#include <rw/memory.hpp>
 
 struct AnimationKeyframe {
     glm::quat rotation{1.0f,0.0f,0.0f,0.0f};
@@ -56,8 +57,28 @@ struct AnimationBone {
 
     ~AnimationBone() = default;
 
-    AnimationKeyframe getInterpolatedKeyframe(float time);
-    AnimationKeyframe getKeyframe(float time);
+    /**
+     * @brief findKeyframe Finds the first keyframe starting at or after time
+     * @param cursor The result of the last search, keyframes from there on
+     * are checked before searching all of them
+     * @return The keyframe's index, or the number of frames if time is past
+     * the last one
+     */
+    size_t findKeyframe(float time, size_t cursor = 0) const;
+
+    AnimationKeyframe getInterpolatedKeyframe(float time) const;
+
+    /**
+     * @brief getInterpolatedKeyframe Samples the bone, starting the search
+     * from cursor and leaving it at the keyframe found for next time
+     */
+    AnimationKeyframe getInterpolatedKeyframe(float time,
+                                              size_t& cursor) const;
+
+    /**
+     * @return The last keyframe starting at or before time
+     */
+    AnimationKeyframe getKeyframe(float time) const;
 };
 
 /**
@@ -72,6 +93,9 @@ struct Animation {
     ~Animation() = default;
 
     float duration;
+
+    /// Size of the bones and their keyframes
+    TrackedMemory memory{MemoryTag::Animation};
 };
 
 class LoaderIFP {
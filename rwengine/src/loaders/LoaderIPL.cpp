@@ -1,40 +1,34 @@
 #include <loaders/LoaderIPL.hpp>
 
-#include <algorithm>
-#include <cctype>
-#include <cstdlib>
-#include <fstream>
-#include <functional>
-#include <sstream>
 #include <string>
+#include <utility>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 #include "data/InstanceData.hpp"
 #include "data/ZoneData.hpp"
-#include "LoaderIPL.hpp"
+#include "loaders/TextTokenizer.hpp"
 
-
-#include <rw/casts.hpp>
+#include <rw/debug.hpp>
 
 enum SectionTypes { INST, PICK, CULL, ZONE, NONE };
 
 bool LoaderIPL::load(const std::string& filename) {
-    std::ifstream str(filename);
-    if (!str.is_open()) return false;
-    return load(str);
+    std::string text;
+    if (!TextTokenizer::readFile(filename, text)) return false;
+    return load(TextTokenizer(text));
 }
 
 bool LoaderIPL::load(std::istream &str) {
+    auto text = TextTokenizer::readAll(str);
+    return load(TextTokenizer(text));
+}
+
+bool LoaderIPL::load(TextTokenizer &&text) {
     SectionTypes section = NONE;
-    while (!str.eof()) {
-        std::string line;
-        getline(str, line);
-        line.erase(std::find_if(line.rbegin(), line.rend(),
-                                [](auto c) { return !std::isspace(c); })
-                       .base(),
-                   line.end());
+    while (text.nextLine()) {
+        auto line = text.line();
 
         if (!line.empty() && line[0] == '#') {
             // nothing, just a comment
@@ -58,69 +52,40 @@ bool LoaderIPL::load(std::istream &str) {
         } else  // regular entry
         {
             if (section == INST) {
-                std::string id;
-                std::string model;
-                std::string posX, posY, posZ;
-                std::string scaleX, scaleY, scaleZ;
-                std::string rotX, rotY, rotZ, rotW;
-
-                std::stringstream strstream(line);
-
-                // read all the contents of the line
-                getline(strstream, id, ',');
-                getline(strstream, model, ',');
-                getline(strstream, posX, ',');
-                getline(strstream, posY, ',');
-                getline(strstream, posZ, ',');
-                getline(strstream, scaleX, ',');
-                getline(strstream, scaleY, ',');
-                getline(strstream, scaleZ, ',');
-                getline(strstream, rotX, ',');
-                getline(strstream, rotY, ',');
-                getline(strstream, rotZ, ',');
-                getline(strstream, rotW, ',');
+                auto id = text.nextInt();
+                auto model = text.nextString();
+                auto posX = text.nextFloat();
+                auto posY = text.nextFloat();
+                auto posZ = text.nextFloat();
+                auto scaleX = text.nextFloat();
+                auto scaleY = text.nextFloat();
+                auto scaleZ = text.nextFloat();
+                auto rotX = text.nextFloat();
+                auto rotY = text.nextFloat();
+                auto rotZ = text.nextFloat();
+                auto rotW = text.nextFloat();
 
                 auto instance = std::make_shared<InstanceData>(
-                    lexical_cast<int>(id),  // ID
-                    model.substr(1, model.size() - 1),
-                    glm::vec3(lexical_cast<float>(posX), lexical_cast<float>(posY),
-                              lexical_cast<float>(posZ)),
-                    glm::vec3(lexical_cast<float>(scaleX), lexical_cast<float>(scaleY),
-                              lexical_cast<float>(scaleZ)),
-                    glm::normalize(
-                        glm::quat(-lexical_cast<float>(rotW), lexical_cast<float>(rotX),
-                                  lexical_cast<float>(rotY), lexical_cast<float>(rotZ))));
+                    id, std::move(model), glm::vec3(posX, posY, posZ),
+                    glm::vec3(scaleX, scaleY, scaleZ),
+                    glm::normalize(glm::quat(-rotW, rotX, rotY, rotZ)));
 
                 m_instances.push_back(instance);
             } else if (section == ZONE) {
                 ZoneData zone;
 
-                std::stringstream strstream(line);
-
-                std::string value;
+                zone.name = text.nextString();
+                zone.type = text.nextInt();
 
-                getline(strstream, value, ',');
-                zone.name = value;
+                zone.min.x = text.nextFloat();
+                zone.min.y = text.nextFloat();
+                zone.min.z = text.nextFloat();
 
-                getline(strstream, value, ',');
-                zone.type = lexical_cast<int>(value);
+                zone.max.x = text.nextFloat();
+                zone.max.y = text.nextFloat();
+                zone.max.z = text.nextFloat();
 
-                getline(strstream, value, ',');
-                zone.min.x = lexical_cast<float>(value);
-                getline(strstream, value, ',');
-                zone.min.y = lexical_cast<float>(value);
-                getline(strstream, value, ',');
-                zone.min.z = lexical_cast<float>(value);
-
-                getline(strstream, value, ',');
-                zone.max.x = lexical_cast<float>(value);
-                getline(strstream, value, ',');
-                zone.max.y = lexical_cast<float>(value);
-                getline(strstream, value, ',');
-                zone.max.z = lexical_cast<float>(value);
-
-                getline(strstream, value, ',');
-                zone.island = lexical_cast<int>(value);
+                zone.island = text.nextInt();
 
                 for (int i = 0; i < ZONE_GANG_COUNT; i++) {
                     zone.gangCarDensityDay[i] = zone.gangCarDensityNight[i] =
@@ -132,9 +97,9 @@ bool LoaderIPL::load(std::istream &str) {
 
                 zones.push_back(std::move(zone));
             }
+            RW_CHECK(!text.hasError(), "Invalid IPL entry " << line.str());
         }
     }
 
     return true;
 }
-
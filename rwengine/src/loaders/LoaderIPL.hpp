@@ -8,6 +8,7 @@
 #include <data/ZoneData.hpp>
 
 struct InstanceData;
+class TextTokenizer;
 
 /**
     \class LoaderIPL
@@ -21,6 +22,9 @@ public:
     /// Parse IPL data from the stream
     bool load(std::istream& stream);
 
+    /// Parse IPL data from a tokenizer over the file's text
+    bool load(TextTokenizer&& text);
+
     /// The list of instances from the IPL file
     std::vector<std::shared_ptr<InstanceData>> m_instances;
 
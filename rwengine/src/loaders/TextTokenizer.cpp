@@ -0,0 +1,226 @@
+#include "loaders/TextTokenizer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <iterator>
+
+namespace {
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+           c == '\f';
+}
+
+bool isSeparator(char c) {
+    return c == ',' || isSpace(c);
+}
+
+int digitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 99;
+}
+
+/// Powers of ten that can be represented exactly by a double
+constexpr double kExactPowers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                   1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                   1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int kMaxExactPower = 22;
+constexpr uint64_t kMaxExactMantissa = uint64_t{1} << 53;
+constexpr size_t kMaxFloatLength = 63;
+}  // namespace
+
+TextTokenizer::TextTokenizer(const char* text, size_t size)
+    : cursor_(text)
+    , end_(text + size)
+    , lineBegin_(text)
+    , lineEnd_(text)
+    , field_(text) {
+}
+
+bool TextTokenizer::nextLine() {
+    if (cursor_ >= end_) {
+        return false;
+    }
+
+    lineBegin_ = cursor_;
+    auto newline = static_cast<const char*>(
+        std::memchr(cursor_, '\n', static_cast<size_t>(end_ - cursor_)));
+    lineEnd_ = newline ? newline : end_;
+    cursor_ = newline ? newline + 1 : end_;
+
+    while (lineEnd_ > lineBegin_ && isSpace(lineEnd_[-1])) {
+        --lineEnd_;
+    }
+
+    field_ = lineBegin_;
+    error_ = false;
+    return true;
+}
+
+bool TextTokenizer::hasField() const {
+    auto it = field_;
+    while (it < lineEnd_ && isSpace(*it)) {
+        ++it;
+    }
+    return it < lineEnd_;
+}
+
+StringRef TextTokenizer::nextField() {
+    while (field_ < lineEnd_ && isSpace(*field_)) {
+        ++field_;
+    }
+    auto begin = field_;
+    while (field_ < lineEnd_ && !isSeparator(*field_)) {
+        ++field_;
+    }
+    auto end = field_;
+
+    // Consume the separator, which may be a comma surrounded by whitespace
+    while (field_ < lineEnd_ && isSpace(*field_)) {
+        ++field_;
+    }
+    if (field_ < lineEnd_ && *field_ == ',') {
+        ++field_;
+    }
+
+    return {begin, static_cast<size_t>(end - begin)};
+}
+
+char TextTokenizer::nextChar() {
+    auto field = nextField();
+    return field.empty() ? '\0' : field[0];
+}
+
+int TextTokenizer::nextInt(int base) {
+    long long value = 0;
+    if (!parseInt(nextField(), value, base)) {
+        error_ = true;
+    }
+    return static_cast<int>(value);
+}
+
+unsigned int TextTokenizer::nextUnsigned(int base) {
+    long long value = 0;
+    if (!parseInt(nextField(), value, base)) {
+        error_ = true;
+    }
+    return static_cast<unsigned int>(value);
+}
+
+float TextTokenizer::nextFloat() {
+    float value = 0.f;
+    if (!parseFloat(nextField(), value)) {
+        error_ = true;
+    }
+    return value;
+}
+
+bool TextTokenizer::parseInt(StringRef text, long long& value, int base) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        ++i;
+    }
+    if (base == 16 && i + 1 < text.size() && text[i] == '0' &&
+        (text[i + 1] == 'x' || text[i + 1] == 'X')) {
+        i += 2;
+    }
+
+    // Like strtol, anything after the number is ignored
+    uint64_t result = 0;
+    size_t first = i;
+    for (int digit; i < text.size() && (digit = digitValue(text[i])) < base;
+         ++i) {
+        result = result * static_cast<uint64_t>(base) +
+                 static_cast<uint64_t>(digit);
+    }
+
+    if (i == first) {
+        value = 0;
+        return false;
+    }
+
+    value = negative ? -static_cast<long long>(result)
+                     : static_cast<long long>(result);
+    return true;
+}
+
+bool TextTokenizer::parseFloat(StringRef text, float& value) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        ++i;
+    }
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    bool exact = true;
+
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+        exact = exact && mantissa < kMaxExactMantissa;
+        ++digits;
+    }
+    if (i < text.size() && text[i] == '.') {
+        for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+            exact = exact && mantissa < kMaxExactMantissa;
+            --exponent;
+            ++digits;
+        }
+    }
+    if (digits > 0 && i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        long long e = 0;
+        if (parseInt({text.data() + i + 1, text.size() - i - 1}, e)) {
+            exponent += static_cast<int>(e);
+        }
+    }
+
+    // Mantissas and powers of ten that doubles represent exactly give a
+    // correctly rounded result with a single multiply or divide.
+    if (digits > 0 && exact && exponent >= -kMaxExactPower &&
+        exponent <= kMaxExactPower) {
+        auto result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / kExactPowers[-exponent]
+                              : result * kExactPowers[exponent];
+        value = static_cast<float>(negative ? -result : result);
+        return true;
+    }
+
+    // Fall back to the C library for anything else, e.g. very long numbers
+    char buffer[kMaxFloatLength + 1];
+    auto length = std::min(text.size(), kMaxFloatLength);
+    std::memcpy(buffer, text.data(), length);
+    buffer[length] = '\0';
+
+    char* end = nullptr;
+    value = std::strtof(buffer, &end);
+    return end != buffer;
+}
+
+std::string TextTokenizer::readAll(std::istream& stream) {
+    return {std::istreambuf_iterator<char>(stream),
+            std::istreambuf_iterator<char>()};
+}
+
+bool TextTokenizer::readFile(const std::string& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    auto length = file.tellg();
+    file.seekg(0);
+    text.resize(static_cast<size_t>(length));
+    file.read(&text[0], length);
+    return true;
+}
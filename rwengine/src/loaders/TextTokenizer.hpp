@@ -0,0 +1,133 @@
+#ifndef _RWENGINE_TEXTTOKENIZER_HPP_
+#define _RWENGINE_TEXTTOKENIZER_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <iosfwd>
+#include <string>
+
+/**
+ * @brief A view of characters owned by something else, like string_view
+ */
+class StringRef {
+public:
+    StringRef() = default;
+
+    StringRef(const char* data, size_t size) : data_(data), size_(size) {
+    }
+
+    const char* data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    char operator[](size_t i) const {
+        return data_[i];
+    }
+
+    std::string str() const {
+        return {data_, size_};
+    }
+
+    bool operator==(const char* other) const {
+        return std::strncmp(data_, other, size_) == 0 && other[size_] == '\0';
+    }
+
+    bool operator!=(const char* other) const {
+        return !(*this == other);
+    }
+
+private:
+    const char* data_ = "";
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Splits the text of a data file into lines and fields
+ *
+ * Works over a buffer holding the whole file, so reading a field doesn't
+ * allocate. Fields are separated by a comma, whitespace, or both, which
+ * covers the IPL, IDE and DAT formats.
+ */
+class TextTokenizer {
+public:
+    /// The text must outlive the tokenizer
+    TextTokenizer(const char* text, size_t size);
+
+    explicit TextTokenizer(const std::string& text)
+        : TextTokenizer(text.data(), text.size()) {
+    }
+
+    /**
+     * @brief nextLine Moves to the next line, trailing whitespace is removed
+     * @return false once there are no more lines
+     */
+    bool nextLine();
+
+    StringRef line() const {
+        return {lineBegin_, static_cast<size_t>(lineEnd_ - lineBegin_)};
+    }
+
+    /// @return true if the current line has fields left to read
+    bool hasField() const;
+
+    /**
+     * @brief nextField Reads the next field of the current line
+     * @return The field with surrounding whitespace removed, or an empty field
+     * if there are none left
+     */
+    StringRef nextField();
+
+    std::string nextString() {
+        return nextField().str();
+    }
+
+    /// @return The first character of the next field, or '\0' if it's empty
+    char nextChar();
+
+    int nextInt(int base = 10);
+
+    unsigned int nextUnsigned(int base = 10);
+
+    float nextFloat();
+
+    /// @return true if a numeric field failed to parse on the current line
+    bool hasError() const {
+        return error_;
+    }
+
+    /**
+     * @brief parseInt Parses an integer from the start of text
+     * @return false if text doesn't start with a number
+     */
+    static bool parseInt(StringRef text, long long& value, int base = 10);
+
+    /**
+     * @brief parseFloat Parses a floating point number from the start of text
+     * @return false if text doesn't start with a number
+     */
+    static bool parseFloat(StringRef text, float& value);
+
+    /// Reads the rest of a stream into a string
+    static std::string readAll(std::istream& stream);
+
+    /// Reads a whole file into a string
+    static bool readFile(const std::string& path, std::string& text);
+
+private:
+    const char* cursor_;
+    const char* end_;
+    const char* lineBegin_;
+    const char* lineEnd_;
+    const char* field_;
+    bool error_ = false;
+};
+
+#endif
@@ -0,0 +1,505 @@
+#include "loaders/WorldCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <platform/MappedFile.hpp>
+#include <rw/debug.hpp>
+#include <rw/filesystem.hpp>
+
+#include "data/InstanceData.hpp"
+
+namespace {
+constexpr uint32_t kMagic = 0x43575752;  // "RWWC"
+/// Increase whenever the layout of the file or the cached types change
+constexpr uint32_t kVersion = 1;
+
+/// Appends values to a buffer in the host's byte order
+class Writer {
+public:
+    template <class T>
+    void pod(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable types can be written");
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void string(const std::string& value) {
+        pod(static_cast<uint32_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    template <class T>
+    void array(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable types can be written");
+        pod(static_cast<uint32_t>(values.size()));
+        buffer_.append(reinterpret_cast<const char*>(values.data()),
+                       values.size() * sizeof(T));
+    }
+
+    const std::string& buffer() const {
+        return buffer_;
+    }
+
+private:
+    std::string buffer_;
+};
+
+/// Reads values written by Writer, any read past the end fails the reader
+class Reader {
+public:
+    Reader(const char* data, size_t size) : data_(data), size_(size) {
+    }
+
+    template <class T>
+    T pod() {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable types can be read");
+        T value{};
+        if (take(sizeof(T))) {
+            std::memcpy(&value, data_ + offset_ - sizeof(T), sizeof(T));
+        }
+        return value;
+    }
+
+    std::string string() {
+        auto length = pod<uint32_t>();
+        if (!take(length)) {
+            return {};
+        }
+        return {data_ + offset_ - length, length};
+    }
+
+    template <class T>
+    std::vector<T> array() {
+        auto count = pod<uint32_t>();
+        if (count > remaining() / sizeof(T) || !take(count * sizeof(T))) {
+            failed_ = true;
+            return {};
+        }
+        std::vector<T> values(count);
+        if (count == 0) {
+            return values;
+        }
+        std::memcpy(values.data(), data_ + offset_ - count * sizeof(T),
+                    count * sizeof(T));
+        return values;
+    }
+
+    /// Reads the number of items that follow, each at least a byte long
+    uint32_t count() {
+        auto count = pod<uint32_t>();
+        if (count > remaining()) {
+            failed_ = true;
+            return 0;
+        }
+        return count;
+    }
+
+    size_t remaining() const {
+        return size_ - offset_;
+    }
+
+    bool failed() const {
+        return failed_;
+    }
+
+private:
+    bool take(size_t bytes) {
+        if (failed_ || bytes > remaining()) {
+            failed_ = true;
+            return false;
+        }
+        offset_ += bytes;
+        return true;
+    }
+
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+    bool failed_ = false;
+};
+
+void writeCollision(Writer& out, const CollisionModel& col) {
+    out.string(col.name);
+    out.pod(col.modelid);
+    out.pod(col.boundingSphere);
+    out.pod(col.boundingBox);
+    out.array(col.spheres);
+    out.array(col.boxes);
+    out.array(col.vertices);
+    out.array(col.faces);
+}
+
+std::unique_ptr<CollisionModel> readCollision(Reader& in) {
+    auto col = std::make_unique<CollisionModel>();
+    col->name = in.string();
+    col->modelid = in.pod<uint16_t>();
+    col->boundingSphere = in.pod<CollisionModel::Sphere>();
+    col->boundingBox = in.pod<CollisionModel::Box>();
+    col->spheres = in.array<CollisionModel::Sphere>();
+    col->boxes = in.array<CollisionModel::Box>();
+    col->vertices = in.array<glm::vec3>();
+    col->faces = in.array<CollisionModel::Triangle>();
+    return col;
+}
+
+void writeSimple(Writer& out, const SimpleModelInfo& info) {
+    out.pod<int32_t>(info.timeOn);
+    out.pod<int32_t>(info.timeOff);
+    out.pod<int32_t>(info.flags);
+    out.pod<int32_t>(info.getNumAtomics());
+    for (int i = 0; i < 3; ++i) {
+        out.pod(info.getLodDistance(i));
+    }
+    out.pod(static_cast<uint32_t>(info.paths.size()));
+    for (const auto& path : info.paths) {
+        out.pod<int32_t>(path.type);
+        out.pod(path.ID);
+        out.string(path.modelName);
+        out.array(path.nodes);
+    }
+}
+
+void readSimple(Reader& in, SimpleModelInfo& info) {
+    info.timeOn = in.pod<int32_t>();
+    info.timeOff = in.pod<int32_t>();
+    info.flags = in.pod<int32_t>();
+    info.setNumAtomics(std::min(in.pod<int32_t>(), 3));
+    for (int i = 0; i < 3; ++i) {
+        info.setLodDistance(i, in.pod<float>());
+    }
+    info.determineFurthest();
+    for (auto paths = in.count(); paths > 0 && !in.failed(); --paths) {
+        PathData path;
+        path.type = static_cast<PathData::PathType>(in.pod<int32_t>());
+        path.ID = in.pod<uint16_t>();
+        path.modelName = in.string();
+        path.nodes = in.array<PathNode>();
+        info.paths.push_back(std::move(path));
+    }
+}
+
+void writeVehicle(Writer& out, const VehicleModelInfo& info) {
+    out.pod<int32_t>(info.vehicletype_);
+    out.pod(info.wheelmodel_);
+    out.pod(info.wheelscale_);
+    out.pod<int32_t>(info.numdoors_);
+    out.string(info.handling_);
+    out.pod<int32_t>(info.vehicleclass_);
+    out.pod<int32_t>(info.frequency_);
+    out.pod<int32_t>(info.level_);
+    out.pod<uint64_t>(info.componentrules_);
+    out.string(info.vehiclename_);
+}
+
+void readVehicle(Reader& in, VehicleModelInfo& info) {
+    info.vehicletype_ =
+        static_cast<VehicleModelInfo::VehicleType>(in.pod<int32_t>());
+    info.wheelmodel_ = in.pod<ModelID>();
+    info.wheelscale_ = in.pod<float>();
+    info.numdoors_ = in.pod<int32_t>();
+    info.handling_ = in.string();
+    info.vehicleclass_ =
+        static_cast<VehicleModelInfo::VehicleClass>(in.pod<int32_t>());
+    info.frequency_ = in.pod<int32_t>();
+    info.level_ = in.pod<int32_t>();
+    info.componentrules_ = static_cast<unsigned long>(in.pod<uint64_t>());
+    info.vehiclename_ = in.string();
+}
+
+void writePed(Writer& out, const PedModelInfo& info) {
+    out.pod<int32_t>(info.pedtype_);
+    out.pod<int32_t>(info.statindex_);
+    out.string(info.animgroup_);
+    out.pod<int32_t>(info.carsmask_);
+}
+
+void readPed(Reader& in, PedModelInfo& info) {
+    info.pedtype_ = static_cast<PedModelInfo::PedType>(in.pod<int32_t>());
+    info.statindex_ = in.pod<int32_t>();
+    info.animgroup_ = in.string();
+    info.carsmask_ = in.pod<int32_t>();
+}
+
+/// @return false if the model's type can't be cached
+bool writeModel(Writer& out, const BaseModelInfo& info) {
+    out.pod(static_cast<uint8_t>(info.type()));
+    out.pod(info.id());
+    out.string(info.name);
+    out.string(info.textureslot);
+
+    switch (info.type()) {
+        case ModelDataType::SimpleInfo:
+            writeSimple(out, static_cast<const SimpleModelInfo&>(info));
+            break;
+        case ModelDataType::ClumpInfo:
+            break;
+        case ModelDataType::VehicleInfo:
+            writeVehicle(out, static_cast<const VehicleModelInfo&>(info));
+            break;
+        case ModelDataType::PedInfo:
+            writePed(out, static_cast<const PedModelInfo&>(info));
+            break;
+        default:
+            return false;
+    }
+
+    auto col = info.getCollision();
+    out.pod<uint8_t>(col != nullptr);
+    if (col) {
+        writeCollision(out, *col);
+    }
+    return true;
+}
+
+std::unique_ptr<BaseModelInfo> readModel(Reader& in) {
+    auto type = static_cast<ModelDataType>(in.pod<uint8_t>());
+    auto id = in.pod<ModelID>();
+    auto name = in.string();
+    auto textureslot = in.string();
+
+    std::unique_ptr<BaseModelInfo> info;
+    switch (type) {
+        case ModelDataType::SimpleInfo: {
+            auto simple = std::make_unique<SimpleModelInfo>();
+            readSimple(in, *simple);
+            info = std::move(simple);
+        } break;
+        case ModelDataType::ClumpInfo:
+            info = std::make_unique<ClumpModelInfo>();
+            break;
+        case ModelDataType::VehicleInfo: {
+            auto vehicle = std::make_unique<VehicleModelInfo>();
+            readVehicle(in, *vehicle);
+            info = std::move(vehicle);
+        } break;
+        case ModelDataType::PedInfo: {
+            auto ped = std::make_unique<PedModelInfo>();
+            readPed(in, *ped);
+            info = std::move(ped);
+        } break;
+        default:
+            return nullptr;
+    }
+
+    info->setModelID(id);
+    info->name = std::move(name);
+    info->textureslot = std::move(textureslot);
+
+    if (in.pod<uint8_t>()) {
+        auto col = readCollision(in);
+        info->setCollisionModel(col);
+    }
+    return info;
+}
+
+void writeZone(Writer& out, const ZoneData& zone) {
+    out.string(zone.name);
+    out.pod<int32_t>(zone.type);
+    out.pod(zone.min);
+    out.pod(zone.max);
+    out.pod<int32_t>(zone.island);
+    out.string(zone.text);
+    out.pod(zone.gangDensityDay);
+    out.pod(zone.gangDensityNight);
+    out.pod(zone.gangCarDensityDay);
+    out.pod(zone.gangCarDensityNight);
+    out.pod(zone.pedGroupDay);
+    out.pod(zone.pedGroupNight);
+}
+
+ZoneData readZone(Reader& in) {
+    ZoneData zone;
+    zone.name = in.string();
+    zone.type = in.pod<int32_t>();
+    zone.min = in.pod<glm::vec3>();
+    zone.max = in.pod<glm::vec3>();
+    zone.island = in.pod<int32_t>();
+    zone.text = in.string();
+    using GangDensities = unsigned int[ZONE_GANG_COUNT];
+    auto readDensities = [&](GangDensities& densities) {
+        for (auto& density : densities) {
+            density = in.pod<unsigned int>();
+        }
+    };
+    readDensities(zone.gangDensityDay);
+    readDensities(zone.gangDensityNight);
+    readDensities(zone.gangCarDensityDay);
+    readDensities(zone.gangCarDensityNight);
+    zone.pedGroupDay = in.pod<unsigned int>();
+    zone.pedGroupNight = in.pod<unsigned int>();
+    return zone;
+}
+
+void writeIPL(Writer& out, const LoaderIPL& ipl) {
+    out.pod(static_cast<uint32_t>(ipl.m_instances.size()));
+    for (const auto& instance : ipl.m_instances) {
+        out.pod<int32_t>(instance->id);
+        out.string(instance->model);
+        out.pod(instance->pos);
+        out.pod(instance->scale);
+        out.pod(instance->rot);
+    }
+    out.pod(static_cast<uint32_t>(ipl.zones.size()));
+    for (const auto& zone : ipl.zones) {
+        writeZone(out, zone);
+    }
+}
+
+void readIPL(Reader& in, LoaderIPL& ipl) {
+    auto instances = in.count();
+    ipl.m_instances.reserve(instances);
+    for (; instances > 0 && !in.failed(); --instances) {
+        auto id = in.pod<int32_t>();
+        auto model = in.string();
+        auto pos = in.pod<glm::vec3>();
+        auto scale = in.pod<glm::vec3>();
+        auto rot = in.pod<glm::quat>();
+        ipl.m_instances.push_back(std::make_shared<InstanceData>(
+            id, std::move(model), pos, scale, rot));
+    }
+    for (auto zones = in.count(); zones > 0 && !in.failed(); --zones) {
+        ipl.zones.push_back(readZone(in));
+    }
+}
+}  // namespace
+
+void WorldCache::addSource(const std::string& path) {
+    SourceFile source{path, 0, 0};
+    statSource(source);
+    sources_.push_back(std::move(source));
+}
+
+bool WorldCache::statSource(SourceFile& source) {
+    rwfs::error_code ec;
+    auto size = rwfs::file_size(source.path, ec);
+    if (ec) {
+        return false;
+    }
+    auto modified = rwfs::last_write_time(source.path, ec);
+    if (ec) {
+        return false;
+    }
+
+    source.size = static_cast<uint64_t>(size);
+#if RW_FS_LIBRARY == RW_FS_BOOST
+    source.modified = static_cast<int64_t>(modified);
+#else
+    source.modified =
+        static_cast<int64_t>(modified.time_since_epoch().count());
+#endif
+    return true;
+}
+
+bool WorldCache::write(const std::string& path, const ModelInfoTable& models,
+                       const std::map<std::string, LoaderIPL>& ipls) {
+    Writer out;
+    out.pod(kMagic);
+    out.pod(kVersion);
+
+    out.pod(static_cast<uint32_t>(sources_.size()));
+    for (const auto& source : sources_) {
+        out.string(source.path);
+        out.pod(source.size);
+        out.pod(source.modified);
+    }
+
+    out.pod(static_cast<uint32_t>(models.size()));
+    for (const auto& model : models) {
+        if (!writeModel(out, *model.second)) {
+            RW_ERROR("Can't cache model " << model.second->name);
+            return false;
+        }
+    }
+
+    out.pod(static_cast<uint32_t>(ipls.size()));
+    for (const auto& ipl : ipls) {
+        out.string(ipl.first);
+        writeIPL(out, ipl.second);
+    }
+
+    // Write to a temporary file first so that a partial cache is never read
+    auto tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(out.buffer().data(),
+                   static_cast<std::streamsize>(out.buffer().size()));
+        if (!file) {
+            return false;
+        }
+    }
+
+    rwfs::error_code ec;
+    rwfs::rename(tempPath, path, ec);
+    return !ec;
+}
+
+bool WorldCache::read(const std::string& path, ModelInfoTable& models,
+                      std::map<std::string, LoaderIPL>& ipls) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    Reader in(file.data(), file.size());
+    if (in.pod<uint32_t>() != kMagic || in.pod<uint32_t>() != kVersion) {
+        return false;
+    }
+
+    std::vector<SourceFile> sources;
+    for (auto count = in.count(); count > 0 && !in.failed(); --count) {
+        SourceFile cached;
+        cached.path = in.string();
+        cached.size = in.pod<uint64_t>();
+        cached.modified = in.pod<int64_t>();
+
+        SourceFile current{cached.path, 0, 0};
+        if (!statSource(current) || current.size != cached.size ||
+            current.modified != cached.modified) {
+            return false;
+        }
+        sources.push_back(std::move(cached));
+    }
+
+    // Read everything before handing any of it out, in case the file is bad
+    ModelInfoTable cachedModels;
+    for (auto count = in.count(); count > 0 && !in.failed(); --count) {
+        auto info = readModel(in);
+        if (!info) {
+            return false;
+        }
+        auto id = info->id();
+        cachedModels.emplace(id, std::move(info));
+    }
+
+    std::map<std::string, LoaderIPL> cachedIPLs;
+    for (auto count = in.count(); count > 0 && !in.failed(); --count) {
+        auto iplPath = in.string();
+        readIPL(in, cachedIPLs[iplPath]);
+    }
+
+    if (in.failed() || in.remaining() != 0) {
+        return false;
+    }
+
+    sources_ = std::move(sources);
+    std::move(cachedModels.begin(), cachedModels.end(),
+              std::inserter(models, models.end()));
+    for (auto& ipl : cachedIPLs) {
+        ipls[ipl.first] = std::move(ipl.second);
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef _RWENGINE_WORLDCACHE_HPP_
+#define _RWENGINE_WORLDCACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <data/ModelData.hpp>
+#include <loaders/LoaderIPL.hpp>
+
+/**
+ * @brief Binary cache of the world data parsed from the level files
+ *
+ * Stores the model information, with its collisions and paths, and the
+ * contents of the IPL files so that later runs can read them back without
+ * parsing any text. The cache records the size and modification time of each
+ * file the data came from, and is rejected if any of them have changed.
+ */
+class WorldCache {
+public:
+    /**
+     * @brief addSource Adds a file that the cached data is read from
+     */
+    void addSource(const std::string& path);
+
+    size_t getSourceCount() const {
+        return sources_.size();
+    }
+
+    /**
+     * @brief write Writes the data and its sources to a cache file
+     * @param ipls Parsed IPL files, by path
+     * @return false if the file couldn't be written
+     */
+    bool write(const std::string& path, const ModelInfoTable& models,
+               const std::map<std::string, LoaderIPL>& ipls);
+
+    /**
+     * @brief read Reads the data from a cache file
+     *
+     * Nothing is read if the file is missing or invalid, was written by a
+     * different version, or if any of its sources have changed.
+     * @return true if the data was read
+     */
+    bool read(const std::string& path, ModelInfoTable& models,
+              std::map<std::string, LoaderIPL>& ipls);
+
+private:
+    struct SourceFile {
+        std::string path;
+        uint64_t size;
+        int64_t modified;
+    };
+
+    /// Fills in the current size and modification time of a file
+    static bool statSource(SourceFile& source);
+
+    std::vector<SourceFile> sources_;
+};
+
+#endif
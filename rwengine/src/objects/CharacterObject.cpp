@@ -377,6 +377,7 @@ void CharacterObject::updateCharacter(float dt) {
         auto Pos =
             physCharacter->getGhostObject()->getWorldTransform().getOrigin();
         position = glm::vec3(Pos.x(), Pos.y(), Pos.z());
+        positionChanged();
         getClump()->getFrame()->setTranslation(position);
 
         // Handle above waist height water.
@@ -432,6 +433,7 @@ void CharacterObject::setPosition(const glm::vec3& pos) {
         physCharacter->warp(bpos);
     }
     position = realPos;
+    positionChanged();
     getClump()->getFrame()->setTranslation(pos);
 }
 
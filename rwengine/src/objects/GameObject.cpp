@@ -3,6 +3,7 @@
 #include <glm/gtc/constants.hpp>
 
 #include "engine/Animator.hpp"
+#include "engine/GameWorld.hpp"
 
 GameObject::~GameObject() {
     if (modelinfo_) {
@@ -12,6 +13,13 @@ GameObject::~GameObject() {
 
 void GameObject::setPosition(const glm::vec3& pos) {
     _lastPosition = position = pos;
+    positionChanged();
+}
+
+void GameObject::positionChanged() {
+    if (engine) {
+        engine->spatialIndex.update(this);
+    }
 }
 
 void GameObject::setRotation(const glm::quat& orientation) {
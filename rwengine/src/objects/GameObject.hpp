@@ -39,6 +39,12 @@ protected:
         modelinfo_ = next;
     }
 
+    /**
+     * Updates the world's spatial index, must be called whenever the
+     * position changes
+     */
+    void positionChanged();
+
 public:
     glm::vec3 position;
     glm::quat rotation;
@@ -246,6 +252,7 @@ public:
         _lastRotation = rotation;
         position = pos;
         rotation = rot;
+        positionChanged();
     }
 
 private:
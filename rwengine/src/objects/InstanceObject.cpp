@@ -145,28 +145,19 @@ void InstanceObject::changeModel(BaseModelInfo* incoming, int atomicNumber) {
     }
 
     if (incoming) {
-        if (!incoming->isLoaded()) {
-            engine->data->loadModel(incoming->id());
-        }
-
         changeModelInfo(incoming);
-        /// @todo this should only be temporary
-        setModel(getModelInfo<SimpleModelInfo>()->getModel());
-        auto collision = getModelInfo<SimpleModelInfo>()->getCollision();
-
-        RW_ASSERT(getModelInfo<SimpleModelInfo>()->getNumAtomics() >
-                  atomicNumber);
-        auto atomic = getModelInfo<SimpleModelInfo>()->getAtomic(atomicNumber);
-        if (atomic) {
-            auto previous = atomic_;
-            atomic_ = atomic->clone();
-            if (previous) {
-                atomic_->setFrame(previous->getFrame());
-            } else {
-                atomic_->setFrame(std::make_shared<ModelFrame>());
-            }
+        // A larger model or longer draw distance has to widen the cell, or
+        // the cell would be culled while the model is still visible
+        engine->instanceGrid.refresh(this);
+
+        if (incoming->isLoaded()) {
+            setupAtomic(atomicNumber);
+        } else {
+            engine->data->requestModel(incoming->id());
+            streamingAtomic = atomicNumber;
         }
 
+        auto collision = getModelInfo<SimpleModelInfo>()->getCollision();
         if (collision) {
             body = std::make_unique<CollisionInstance>();
             body->createPhysicsBody(this, collision, dynamics.get());
@@ -174,6 +165,50 @@ void InstanceObject::changeModel(BaseModelInfo* incoming, int atomicNumber) {
     }
 }
 
+void InstanceObject::modelStreamed() {
+    if (streamingAtomic == -1 || !getModelInfo<BaseModelInfo>()->isLoaded()) {
+        return;
+    }
+
+    setupAtomic(streamingAtomic);
+    if (atomic_) {
+        atomic_->getFrame()->setTranslation(getPosition());
+        atomic_->getFrame()->setRotation(glm::mat3_cast(getRotation()));
+    }
+}
+
+void InstanceObject::modelEvicted() {
+    if (!atomic_ || getModelInfo<BaseModelInfo>()->isLoaded()) {
+        return;
+    }
+
+    // Drop the geometry so its memory is freed, modelStreamed() restores
+    // the transform
+    atomic_.reset();
+    setModel(nullptr);
+    streamingAtomic = currentAtomic;
+}
+
+void InstanceObject::setupAtomic(int atomicNumber) {
+    streamingAtomic = -1;
+    currentAtomic = atomicNumber;
+
+    /// @todo this should only be temporary
+    setModel(getModelInfo<SimpleModelInfo>()->getModel());
+
+    RW_ASSERT(getModelInfo<SimpleModelInfo>()->getNumAtomics() > atomicNumber);
+    auto atomic = getModelInfo<SimpleModelInfo>()->getAtomic(atomicNumber);
+    if (atomic) {
+        auto previous = atomic_;
+        atomic_ = atomic->clone();
+        if (previous) {
+            atomic_->setFrame(previous->getFrame());
+        } else {
+            atomic_->setFrame(std::make_shared<ModelFrame>());
+        }
+    }
+}
+
 void InstanceObject::setPosition(const glm::vec3& pos) {
     if (body) {
         auto& wtr = body->getBulletBody()->getWorldTransform();
@@ -183,6 +218,9 @@ void InstanceObject::setPosition(const glm::vec3& pos) {
         atomic_->getFrame()->setTranslation(pos);
     }
     GameObject::setPosition(pos);
+    if (engine) {
+        engine->instanceGrid.update(this);
+    }
 }
 
 void InstanceObject::setRotation(const glm::quat& r) {
@@ -268,6 +306,12 @@ void InstanceObject::updateTransform(const glm::vec3& pos,
                                      const glm::quat& rot) {
     position = pos;
     rotation = rot;
-    getAtomic()->getFrame()->setRotation(glm::mat3_cast(rot));
-    getAtomic()->getFrame()->setTranslation(pos);
+    // The atomic doesn't exist until the model has streamed in
+    if (atomic_) {
+        atomic_->getFrame()->setRotation(glm::mat3_cast(rot));
+        atomic_->getFrame()->setTranslation(pos);
+    }
+    if (engine) {
+        engine->instanceGrid.update(this);
+    }
 }
@@ -23,6 +23,10 @@ class InstanceObject final : public GameObject {
     bool static_ = false;
     bool usePhysics = false;
     int changeAtomic = -1;
+    /// Atomic to use once the model has been streamed in, -1 if not waiting
+    int streamingAtomic = -1;
+    /// The model atomic that atomic_ was cloned from
+    int currentAtomic = 0;
 
     /**
      * The Atomic instance for this object
@@ -52,8 +56,27 @@ public:
 
     void tickPhysics(float dt);
 
+    /**
+     * Changes the model of this instance. If the model isn't loaded yet
+     * it is requested, and the atomic is set up by modelStreamed()
+     */
     void changeModel(BaseModelInfo* incoming, int atomicNumber = 0);
 
+    bool isWaitingForModel() const {
+        return streamingAtomic != -1;
+    }
+
+    /**
+     * Sets up the atomic after the model has finished streaming
+     */
+    void modelStreamed();
+
+    /**
+     * Releases the atomic if the model has been unloaded, and waits for it
+     * to be streamed back in
+     */
+    void modelEvicted();
+
     void setPosition(const glm::vec3& pos) override;
 
     void setRotation(const glm::quat& r) override;
@@ -89,6 +112,9 @@ public:
     }
 
     void updateTransform(const glm::vec3& pos, const glm::quat& rot) override;
+
+private:
+    void setupAtomic(int atomicNumber);
 };
 
 #endif
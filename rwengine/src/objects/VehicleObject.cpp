@@ -315,6 +315,7 @@ void VehicleObject::updateTransform(const glm::vec3& pos,
                                     const glm::quat& rot) {
     position = pos;
     rotation = rot;
+    positionChanged();
     getClump()->getFrame()->setRotation(glm::mat3_cast(rot));
     getClump()->getFrame()->setTranslation(pos);
 }
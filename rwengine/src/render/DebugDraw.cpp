@@ -1,5 +1,6 @@
 #include "render/DebugDraw.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 #include <glm/glm.hpp>
@@ -20,6 +21,11 @@
 
 #include "render/GameRenderer.hpp"
 
+namespace {
+/// Number of line vertices streamed for each draw
+constexpr size_t kLineBatchVertices = 32768;
+}  // namespace
+
 DebugDraw::DebugDraw() {
     dbuff->setFaceType(GL_LINES);
 
@@ -62,20 +68,25 @@ void DebugDraw::flush(GameRenderer *renderer) {
         return;
     }
 
-    renderer->getRenderer()->useProgram(shaderProgram);
-
-    lineBuff->uploadVertices(lines);
-    dbuff->addGeometry(lineBuff.get());
+    auto r = renderer->getRenderer();
+    r->useProgram(shaderProgram);
 
     Renderer::DrawParameters dp;
     dp.textures = {{texture}};
     dp.ambient = 1.f;
     dp.colour = glm::u8vec4(255, 255, 255, 255);
     dp.start = 0;
-    dp.count = lines.size();
     dp.diffuse = 1.f;
 
-    renderer->getRenderer()->drawArrays(glm::mat4(1.f), dbuff.get(), dp);
+    // Draw in batches that each fit in the renderer's stream buffer
+    for (size_t first = 0; first < lines.size(); first += kLineBatchVertices) {
+        auto count = std::min(lines.size() - first, kLineBatchVertices);
+        r->streamVertices(dbuff.get(), &lines[first],
+                          count * sizeof(GeometryVertex),
+                          GeometryVertex::vertex_attributes());
+        dp.count = count;
+        r->drawArrays(glm::mat4(1.f), dbuff.get(), dp);
+    }
 
     renderer->getRenderer()->invalidate();
 
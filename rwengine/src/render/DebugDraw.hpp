@@ -21,7 +21,6 @@
 class btVector3;
 class DrawBuffer;
 class GameRenderer;
-class GeometryBuffer;
 
 class DebugDraw final : public btIDebugDraw {
 public:
@@ -49,7 +48,6 @@ protected:
 
     std::vector<GeometryVertex> lines;
     size_t maxlines;
-    std::unique_ptr<GeometryBuffer> lineBuff = std::make_unique<GeometryBuffer>();
     std::unique_ptr<DrawBuffer> dbuff = std::make_unique<DrawBuffer>();
 
     //Ownership is handled by worldProg in renderer
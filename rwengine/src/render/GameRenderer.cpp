@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
+#include <iterator>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <glm/gtc/constants.hpp>
@@ -16,17 +18,29 @@
 
 #include "core/Logger.hpp"
 #include "core/Profiler.hpp"
+#include "core/WorkerPool.hpp"
 #include "engine/GameData.hpp"
 #include "engine/GameState.hpp"
 #include "engine/GameWorld.hpp"
 #include "loaders/WeatherLoader.hpp"
 #include "objects/GameObject.hpp"
 #include "render/ObjectRenderer.hpp"
+#include "render/RenderKey.hpp"
 #include "render/GameShaders.hpp"
 #include "render/VisualFX.hpp"
 
 constexpr size_t skydomeSegments = 8, skydomeRows = 10;
 
+/// Number of objects each render list job processes
+constexpr size_t kRenderListChunkSize = 256;
+
+namespace {
+unsigned int renderWorkerCount() {
+    auto threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 0;
+}
+}  // namespace
+
 /// @todo collapse all of these into "VertPNC" etc.
 struct ParticleVert {
     static const AttributeList vertex_attributes() {
@@ -48,6 +62,8 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
     , text(this) {
     logger->info("Renderer", renderer->getIDString());
 
+    workers = std::make_unique<WorkerPool>(renderWorkerCount());
+
     worldProg =
         renderer->createShader(GameShaders::WorldObject::VertexShader,
                                GameShaders::WorldObject::FragmentShader);
@@ -299,9 +315,14 @@ void GameRenderer::renderObjects(const GameWorld *world) {
     renderer->useProgram(worldProg.get());
     RenderList renderList = createObjectRenderList(world);
 
+    {
+        RW_PROFILE_SCOPE("sortRenderList");
+        sortRenderList(renderList, renderOrder);
+    }
+
     renderer->pushDebugGroup("Objects");
     renderer->pushDebugGroup("RenderList");
-    renderer->drawBatched(renderList);
+    renderer->drawBatched(renderList, renderOrder);
 
     renderer->popDebugGroup();
     profObjects = renderer->popDebugGroup();
@@ -309,21 +330,94 @@ void GameRenderer::renderObjects(const GameWorld *world) {
 
 RenderList GameRenderer::createObjectRenderList(const GameWorld *world) {
     RW_PROFILE_SCOPE(__func__);
-    // This is sequential at the moment, it should be easy to make it
-    // run in parallel with a good threading system.
-    RenderList renderList;
-    // Naive optimisation, assume 50% hitrate
-    renderList.reserve(static_cast<size_t>(world->allObjects.size() * 0.5f));
+    const auto& camera = cullOverride ? cullingCamera : _camera;
+
+    // Instances are culled a cell at a time, so only the cells near the
+    // camera have their objects looked at
+    visibleObjects.clear();
+    {
+        RW_PROFILE_SCOPE("cullInstanceGrid");
+        ObjectRenderer cellRenderer(_renderWorld, camera, _renderAlpha);
+        for (const auto& cell : world->instanceGrid.getCells()) {
+            if (cell.objects.empty()) {
+                continue;
+            }
+            if (!cellRenderer.isCellVisible(cell)) {
+                culled += cell.objects.size();
+                continue;
+            }
+            visibleObjects.insert(visibleObjects.end(), cell.objects.begin(),
+                                 cell.objects.end());
+        }
+    }
+    for (const auto pool :
+         {&world->pedestrianPool, &world->vehiclePool, &world->pickupPool,
+          &world->cutscenePool, &world->projectilePool}) {
+        for (const auto& entry : pool->objects) {
+            visibleObjects.push_back(entry.second.get());
+        }
+    }
+    const auto& objects = visibleObjects;
 
-    ObjectRenderer objectRenderer(_renderWorld,
-                                  (cullOverride ? cullingCamera : _camera),
-                                  _renderAlpha);
+    {
+        RW_PROFILE_SCOPE("prepareObjects");
+        for (auto object : objects) {
+            ObjectRenderer::prepareObject(object);
+        }
+    }
+
+    // Each chunk covers a fixed range of objects and is merged in order, so
+    // the result doesn't depend on which thread built which chunk
+    auto chunkCount =
+        (objects.size() + kRenderListChunkSize - 1) / kRenderListChunkSize;
+    if (renderListChunks.size() < chunkCount) {
+        renderListChunks.resize(chunkCount);
+    }
+
+    workers->run(chunkCount, [&](size_t index) {
+        auto& chunk = renderListChunks[index];
+        chunk.renderList.clear();
+
+        ObjectRenderer chunkRenderer(_renderWorld, camera, _renderAlpha);
+        auto begin = index * kRenderListChunkSize;
+        auto end = std::min(begin + kRenderListChunkSize, objects.size());
+        chunkRenderer.buildRenderList(objects.data() + begin, end - begin,
+                                      chunk.renderList);
+        chunk.culled = chunkRenderer.culled;
+        chunk.missingModels.swap(chunkRenderer.missingModels);
+    });
 
-    // World Objects
-    for (auto object : world->allObjects) {
-        objectRenderer.buildRenderList(object, renderList);
+    RenderList renderList;
+    size_t listSize = 0;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        listSize += renderListChunks[i].renderList.size();
+    }
+    renderList.reserve(listSize);
+    std::vector<ModelID> missingModels;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        auto& chunk = renderListChunks[i];
+        renderList.insert(renderList.end(),
+                          std::make_move_iterator(chunk.renderList.begin()),
+                          std::make_move_iterator(chunk.renderList.end()));
+        chunk.renderList.clear();
+        culled += chunk.culled;
+        missingModels.insert(missingModels.end(),
+                             chunk.missingModels.begin(),
+                             chunk.missingModels.end());
+        chunk.missingModels.clear();
+    }
+
+    // Stream back in models that were evicted but are in view again
+    std::sort(missingModels.begin(), missingModels.end());
+    missingModels.erase(
+        std::unique(missingModels.begin(), missingModels.end()),
+        missingModels.end());
+    for (auto model : missingModels) {
+        _renderWorld->data->requestModel(model);
     }
 
+    ObjectRenderer objectRenderer(_renderWorld, camera, _renderAlpha);
+
     // Area indicators
     auto sphereModel = getSpecialModel(ZoneCylinderA);
     for (auto &i : world->getAreaIndicators()) {
@@ -364,20 +458,6 @@ RenderList GameRenderer::createObjectRenderList(const GameWorld *world) {
     }
     culled += objectRenderer.culled;
 
-    RW_PROFILE_SCOPE("sortRenderList");
-    // Also parallelizable
-    // Earlier position in the array means earlier object's rendering
-    // Transparent objects should be sorted and rendered after opaque
-    sort(renderList.begin(), renderList.end(),
-         [](const Renderer::RenderInstruction &a,
-            const Renderer::RenderInstruction &b) {
-             if (a.drawInfo.blendMode == BlendMode::BLEND_NONE && b.drawInfo.blendMode != BlendMode::BLEND_NONE)
-                 return true;
-             if (a.drawInfo.blendMode != BlendMode::BLEND_NONE && b.drawInfo.blendMode == BlendMode::BLEND_NONE)
-                 return false;
-             return (a.sortKey > b.sortKey);
-         });
-
     return renderList;
 }
 
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -12,6 +13,8 @@
 
 #include <rw/forward.hpp>
 
+#include <data/ModelData.hpp>
+
 #include <render/OpenGLRenderer.hpp>
 #include <render/MapRenderer.hpp>
 #include <render/TextRenderer.hpp>
@@ -20,8 +23,10 @@
 
 class Logger;
 class GameData;
+class GameObject;
 class GameWorld;
 class TextureData;
+class WorkerPool;
 
 /**
  * @brief Implements high level drawing logic and low level draw commands
@@ -54,6 +59,22 @@ class GameRenderer {
     /** Number of culling events */
     size_t culled;
 
+    /** Threads used to build the object render list */
+    std::unique_ptr<WorkerPool> workers;
+
+    /** Objects in visible grid cells and every non-instance object */
+    std::vector<GameObject*> visibleObjects;
+
+    /** Render list for a range of visibleObjects */
+    struct RenderListChunk {
+        RenderList renderList;
+        size_t culled = 0;
+        std::vector<ModelID> missingModels;
+    };
+    /** Kept between frames to reuse the lists' storage */
+    std::vector<RenderListChunk> renderListChunks;
+    RenderOrder renderOrder;
+
     GLuint framebufferName;
     GLuint fbTextures[2];
     GLuint fbRenderBuffers[1];
@@ -152,6 +152,9 @@ out vec3 Normal;
 out vec2 TexCoords;
 out vec4 Colour;
 out vec4 WorldSpace;
+flat out vec4 ObjectColour;
+flat out float AmbientFactor;
+flat out float Visibility;
 
 layout(std140) uniform SceneData {
 	mat4 projection;
@@ -164,7 +167,7 @@ layout(std140) uniform SceneData {
 	float fogEnd;
 };
 
-layout(std140) uniform ObjectData {
+struct ObjectEntry {
 	mat4 model;
 	vec4 colour;
 	float diffusefac;
@@ -172,12 +175,21 @@ layout(std140) uniform ObjectData {
 	float visibility;
 };
 
+// One entry per instance, the size must match Renderer::kMaxInstances
+layout(std140) uniform ObjectData {
+	ObjectEntry objects[128];
+};
+
 void main()
 {
+	ObjectEntry object = objects[gl_InstanceID];
 	Normal = normal;
 	TexCoords = texCoords;
 	Colour = _colour;
-	vec4 worldspace = model * vec4(position, 1.0);
+	ObjectColour = object.colour;
+	AmbientFactor = object.ambientfac;
+	Visibility = object.visibility;
+	vec4 worldspace = object.model * vec4(position, 1.0);
 	vec4 viewspace = view * worldspace;
 	gl_Position = projection * viewspace;
 
@@ -191,6 +203,8 @@ in vec3 Normal;
 in vec2 TexCoords;
 in vec4 Colour;
 in vec4 WorldSpace;
+flat in vec4 ObjectColour;
+flat in float AmbientFactor;
 uniform sampler2D tex;
 out vec4 fragOut;
 
@@ -205,22 +219,14 @@ layout(std140) uniform SceneData {
 	float fogEnd;
 };
 
-layout(std140) uniform ObjectData {
-	mat4 model;
-	vec4 colour;
-	float diffusefac;
-	float ambientfac;
-	float visibility;
-};
-
 float alphaThreshold = (1.0/255.0);
 
 void main()
 {
 	// Only the visibility parameter invokes the screen door.
 	vec4 diffuse = Colour;
-	diffuse.rgb += ambient.rgb*ambientfac;
-	diffuse *= colour;
+	diffuse.rgb += ambient.rgb*AmbientFactor;
+	diffuse *= ObjectColour;
 	diffuse *= texture(tex, TexCoords);
 	if(diffuse.a <= alphaThreshold) discard;
 	float fog = 1.0 - clamp( (fogEnd-WorldSpace.w)/(fogEnd-fogStart), 0.0, 1.0 );
@@ -233,6 +239,8 @@ const char* Particle::FragmentShader = R"(
 in vec3 Normal;
 in vec2 TexCoords;
 in vec4 Colour;
+flat in vec4 ObjectColour;
+flat in float Visibility;
 uniform sampler2D tex;
 out vec4 outColour;
 
@@ -247,14 +255,6 @@ layout(std140) uniform SceneData {
 	float fogEnd;
 };
 
-layout(std140) uniform ObjectData {
-	mat4 model;
-	vec4 colour;
-	float diffusefac;
-	float ambientfac;
-	float visibility;
-};
-
 #define ALPHA_DISCARD_THRESHOLD 0.01
 
 void main()
@@ -264,7 +264,7 @@ void main()
 	if(c.a <= ALPHA_DISCARD_THRESHOLD) discard;
 	float fogZ = (gl_FragCoord.z / gl_FragCoord.w);
 	float fogfac = clamp( (fogStart-fogZ)/(fogEnd-fogStart), 0.0, 1.0 );
-	vec4 tint = vec4(colour.rgb, visibility);
+	vec4 tint = vec4(ObjectColour.rgb, Visibility);
 	outColour = c * tint;
 })";
 
@@ -1,7 +1,5 @@
 #include "render/ObjectRenderer.hpp"
 
-#include <cstdint>
-
 #include <BulletDynamics/Vehicle/btRaycastVehicle.h>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -12,6 +10,7 @@
 #include "engine/GameData.hpp"
 #include "engine/GameState.hpp"
 #include "engine/GameWorld.hpp"
+#include "render/RenderKey.hpp"
 #include "render/ViewCamera.hpp"
 
 // Objects that we know how to turn into renderlist entries
@@ -35,11 +34,6 @@ constexpr float kMagicLODDistance = 330.f;
 constexpr float kVehicleLODDistance = 70.f;
 constexpr float kVehicleDrawDistance = 280.f;
 
-RenderKey createKey(float normalizedDepth, Renderer::Textures& textures) {
-    return (uint32_t(0x7FFFFF * normalizedDepth) << 8 |
-            uint8_t(0xFF & (!textures.empty() ? textures[0] : 0)));
-}
-
 void ObjectRenderer::renderGeometry(Geometry* geom,
                                     const glm::mat4& modelMatrix,
                                     GameObject* object, RenderList& outList) {
@@ -51,6 +45,7 @@ void ObjectRenderer::renderGeometry(Geometry* geom,
         dp.colour = {255, 255, 255, 255};
         dp.count = subgeom.numIndices;
         dp.start = subgeom.start;
+        dp.baseVertex = subgeom.baseVertex;
         dp.textures = {{0}};
         dp.visibility = 1.f;
 
@@ -105,8 +100,9 @@ void ObjectRenderer::renderGeometry(Geometry* geom,
         float distance = glm::length(m_camera.position - position);
         float depth = (distance - m_camera.frustum.near) /
                       (m_camera.frustum.far - m_camera.frustum.near);
-        outList.emplace_back(createKey(depth * depth, dp.textures), modelMatrix,
-                             &geom->dbuff, dp);
+        auto key = makeRenderKey(dp.blendMode, depth,
+                                 geom->dbuff->getVAOName(), dp.textures[0]);
+        outList.emplace_back(key, modelMatrix, geom->dbuff, dp);
     }
 }
 
@@ -124,6 +120,15 @@ void ObjectRenderer::renderAtomic(Atomic* atomic,
     auto transform = worldtransform * frame->getWorldTransform();
 
     glm::vec3 boundpos = bounds.center + glm::vec3(transform[3]);
+    if (m_batching) {
+        m_pending[m_pendingBounds.count] = {geometry.get(), transform, object};
+        m_pendingBounds.push(boundpos, bounds.radius);
+        if (m_pendingBounds.full()) {
+            flushPendingAtomics(render);
+        }
+        return;
+    }
+
     if (!m_camera.frustum.intersects(boundpos, bounds.radius)) {
         culled++;
         return;
@@ -132,6 +137,20 @@ void ObjectRenderer::renderAtomic(Atomic* atomic,
     renderGeometry(geometry.get(), transform, object, render);
 }
 
+void ObjectRenderer::flushPendingAtomics(RenderList& outList) {
+    auto visible = m_camera.frustum.intersects(m_pendingBounds);
+    for (size_t i = 0; i < m_pendingBounds.count; ++i) {
+        if ((visible & (uint64_t(1) << i)) == 0) {
+            culled++;
+            continue;
+        }
+        const auto& pending = m_pending[i];
+        renderGeometry(pending.geometry, pending.transform, pending.object,
+                       outList);
+    }
+    m_pendingBounds.count = 0;
+}
+
 void ObjectRenderer::renderClump(Clump* model, const glm::mat4& worldtransform,
                                  GameObject* object, RenderList& render) {
     for (const auto& atomic : model->getAtomics()) {
@@ -146,11 +165,6 @@ void ObjectRenderer::renderClump(Clump* model, const glm::mat4& worldtransform,
 
 void ObjectRenderer::renderInstance(InstanceObject* instance,
                                     RenderList& outList) {
-    const auto& atomic = instance->getAtomic();
-    if (!atomic) {
-        return;
-    }
-
     // Only draw visible objects
     if (!instance->isVisible()) {
         return;
@@ -188,6 +202,18 @@ void ObjectRenderer::renderInstance(InstanceObject* instance,
         }
     }
 
+    // Evicted models are streamed back in once they are wanted again
+    modelinfo->markUsed(m_world->data->residency.getFrame());
+    if (!modelinfo->isLoaded()) {
+        missingModels.push_back(modelinfo->id());
+        return;
+    }
+
+    const auto& atomic = instance->getAtomic();
+    if (!atomic) {
+        return;
+    }
+
     Atomic* distanceatomic =
         modelinfo->getDistanceAtomic(mindist / kDrawDistanceFactor);
     if (!distanceatomic) {
@@ -202,28 +228,36 @@ void ObjectRenderer::renderInstance(InstanceObject* instance,
     renderAtomic(atomic.get(), glm::mat4(1.0f), instance, outList);
 }
 
-void ObjectRenderer::renderCharacter(CharacterObject* pedestrian,
-                                     RenderList& outList) {
-    const auto& clump = pedestrian->getClump();
+void ObjectRenderer::prepareObject(GameObject* object) {
+    const auto& clump = object->getClump();
+    if (!clump) {
+        return;
+    }
 
-    if (pedestrian->getCurrentVehicle()) {
+    if (object->type() == GameObject::Character) {
+        auto pedestrian = static_cast<CharacterObject*>(object);
         auto vehicle = pedestrian->getCurrentVehicle();
-        const auto& vehicleclump = vehicle->getClump();
-        auto seat = pedestrian->getCurrentSeat();
-        auto matrixModel = vehicleclump->getFrame()->getWorldTransform();
-        if (pedestrian->isEnteringOrExitingVehicle()) {
-            matrixModel = glm::translate(matrixModel,
-                                         vehicle->getSeatEntryPosition(seat));
-            clump->getFrame()->setTransform(matrixModel);
-        } else {
-            if (seat < vehicle->info->seats.size()) {
-                matrixModel = glm::translate(matrixModel,
-                                             vehicle->info->seats[seat].offset);
+        if (vehicle) {
+            const auto& vehicleclump = vehicle->getClump();
+            auto seat = pedestrian->getCurrentSeat();
+            auto matrixModel = vehicleclump->getFrame()->getWorldTransform();
+            if (pedestrian->isEnteringOrExitingVehicle()) {
+                matrixModel = glm::translate(
+                    matrixModel, vehicle->getSeatEntryPosition(seat));
+                clump->getFrame()->setTransform(matrixModel);
+            } else if (seat < vehicle->info->seats.size()) {
+                matrixModel = glm::translate(
+                    matrixModel, vehicle->info->seats[seat].offset);
                 clump->getFrame()->setTransform(matrixModel);
             }
         }
     }
 
+    clump->updateTransforms();
+}
+
+void ObjectRenderer::renderCharacter(CharacterObject* pedestrian,
+                                     RenderList& outList) {
     renderClump(pedestrian->getClump().get(), glm::mat4(1.0f), nullptr,
                 outList);
 
@@ -239,6 +273,9 @@ void ObjectRenderer::renderCharacter(CharacterObject* pedestrian,
         auto simple =
             m_world->data->findModelInfo<SimpleModelInfo>(weapon->modelID);
         RW_CHECK(simple, "Failed to read modelinfo using " << weapon->modelID);
+        if (!useModel(simple)) {
+            return;
+        }
         auto itematomic = simple->getAtomic(0);
         renderAtomic(itematomic, handFrame->getWorldTransform(), nullptr,
                      outList);
@@ -271,7 +308,7 @@ void ObjectRenderer::renderVehicle(VehicleObject* vehicle,
     auto modelinfo = vehicle->getVehicle();
     auto woi =
         m_world->data->findModelInfo<SimpleModelInfo>(modelinfo->wheelmodel_);
-    if (!woi || !woi->isLoaded() || !woi->getDistanceAtomic(mindist)) {
+    if (!woi || !useModel(woi) || !woi->getDistanceAtomic(mindist)) {
         return;
     }
 
@@ -316,6 +353,9 @@ void ObjectRenderer::renderPickup(PickupObject* pickup, RenderList& outList) {
     auto odata = pickup->getModelInfo<SimpleModelInfo>();
 
     RW_CHECK(odata, "Failed to read modelinfo for Pickup");
+    if (!useModel(odata)) {
+        return;
+    }
 
     auto atomic = odata->getAtomic(0);
 
@@ -350,12 +390,54 @@ void ObjectRenderer::renderProjectile(ProjectileObject* projectile,
         projectile->getProjectileInfo().weapon->modelID);
 
     RW_CHECK(odata, "Failed to read modelinfo");
+    if (!useModel(odata)) {
+        return;
+    }
 
     auto atomic = odata->getAtomic(0);
     renderAtomic(atomic, modelMatrix, nullptr, outList);
 }
 
+void ObjectRenderer::buildRenderList(GameObject* const* objects,
+                                     size_t count, RenderList& outList) {
+    m_batching = true;
+    for (size_t i = 0; i < count; ++i) {
+        buildRenderList(objects[i], outList);
+    }
+    flushPendingAtomics(outList);
+    m_batching = false;
+}
+
+bool ObjectRenderer::isCellVisible(const InstanceGrid::Cell& cell) const {
+    // Instances are drawn by the distance to their position, so the nearest
+    // position in the cell decides if any of them can be
+    auto nearest = glm::clamp(m_camera.position, cell.min, cell.max);
+    float mindist =
+        glm::length(nearest - m_camera.position) / kDrawDistanceFactor;
+    if (mindist > cell.drawDistance) {
+        return false;
+    }
+
+    return m_camera.frustum.intersects(cell.getCenter(),
+                                       cell.getBoundingRadius());
+}
+
+bool ObjectRenderer::useModel(BaseModelInfo* modelinfo) {
+    modelinfo->markUsed(m_world->data->residency.getFrame());
+    if (!modelinfo->isLoaded()) {
+        missingModels.push_back(modelinfo->id());
+        return false;
+    }
+    return true;
+}
+
 void ObjectRenderer::buildRenderList(GameObject* object, RenderList& outList) {
+    // Instances are marked once they are known to be in range
+    auto modelinfo = object->getModelInfo<BaseModelInfo>();
+    if (modelinfo && object->type() != GameObject::Instance) {
+        modelinfo->markUsed(m_world->data->residency.getFrame());
+    }
+
     // Right now specialized on each object type
     switch (object->type()) {
         case GameObject::Instance:
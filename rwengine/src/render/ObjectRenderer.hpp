@@ -1,7 +1,9 @@
 #ifndef _RWENGINE_OBJECTRENDERER_HPP_
 #define _RWENGINE_OBJECTRENDERER_HPP_
 
+#include <array>
 #include <cstddef>
+#include <vector>
 
 #include <gl/gl_core_3_3.h>
 
@@ -9,7 +11,10 @@
 //#include <gl/DrawBuffer.hpp>
 #include <glm/glm.hpp>
 //#include <objects/GameObject.hpp>
+#include <data/ModelData.hpp>
+#include <engine/InstanceGrid.hpp>
 #include <render/OpenGLRenderer.hpp>
+#include <render/ViewFrustum.hpp>
 //#include <render/ViewCamera.hpp>
 //#include <rw/types.hpp>
 
@@ -47,8 +52,35 @@ public:
      * Exports rendering instructions for an object
      */
     size_t culled = 0;
+
+    /// Models that would have been drawn but aren't loaded, for the caller
+    /// to request from the main thread
+    std::vector<ModelID> missingModels;
+
     void buildRenderList(GameObject* object, RenderList& outList);
 
+    /**
+     * @brief prepareObject Settles an object's frames before render lists
+     * are built from several threads, must be called on the main thread
+     *
+     * Reading an out of date frame updates it, so every frame the workers
+     * could read is brought up to date here instead.
+     */
+    static void prepareObject(GameObject* object);
+
+    /**
+     * @brief buildRenderList Exports rendering instructions for a range of
+     * objects, testing their atomics against the frustum in batches
+     */
+    void buildRenderList(GameObject* const* objects, size_t count,
+                         RenderList& outList);
+
+    /**
+     * @brief isCellVisible Tests if any object in an instance grid cell could
+     * be drawn, from the camera and draw distance
+     */
+    bool isCellVisible(const InstanceGrid::Cell& cell) const;
+
     void renderGeometry(Geometry* geom, const glm::mat4& modelMatrix,
                         GameObject* object, RenderList& outList);
 
@@ -73,6 +105,25 @@ private:
     const ViewCamera& m_camera;
     float m_renderAlpha;
 
+    /// An atomic waiting for the rest of its batch to be frustum tested
+    struct PendingAtomic {
+        Geometry* geometry;
+        glm::mat4 transform;
+        GameObject* object;
+    };
+
+    /// Set while building a range of objects, renderAtomic then queues
+    /// atomics instead of testing them one at a time
+    bool m_batching = false;
+    ViewFrustum::SphereBatch m_pendingBounds;
+    std::array<PendingAtomic, ViewFrustum::SphereBatch::kSize> m_pending;
+
+    void flushPendingAtomics(RenderList& outList);
+
+    /// Marks a model as used, returns false and records it as missing if it
+    /// isn't loaded
+    bool useModel(BaseModelInfo* modelinfo);
+
     void renderInstance(InstanceObject* instance, RenderList& outList);
     void renderCharacter(CharacterObject* pedestrian, RenderList& outList);
     void renderVehicle(VehicleObject* vehicle, RenderList& outList);
@@ -1,5 +1,7 @@
 #include "render/OpenGLRenderer.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <sstream>
 
@@ -8,13 +10,37 @@
 
 #include <core/Profiler.hpp>
 #include <gl/DrawBuffer.hpp>
+#include <render/RenderKey.hpp>
 #include <rw/debug.hpp>
 
 namespace {
 constexpr GLuint kUBOIndexScene = 1;
 constexpr GLuint kUBOIndexDraw = 2;
+
+/// Size of each region of the stream buffer, enough for a frame's transient
+/// uploads in most scenes
+constexpr GLsizeiptr kStreamRegionSize = 4 * 1024 * 1024;
+constexpr GLsizeiptr kStreamVertexAlignment = 16;
+
+/// Size of the ObjectData block, ranges bound to it must be at least this big
+constexpr GLsizeiptr kObjectBlockSize =
+    Renderer::kMaxInstances * sizeof(Renderer::ObjectUniformData);
+
+GLsizeiptr alignTo(GLsizeiptr offset, GLsizeiptr alignment) {
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+Renderer::ObjectUniformData makeObjectData(const glm::mat4& model,
+                                           const Renderer::DrawParameters& p) {
+    return {model,
+            glm::vec4(p.colour.r / 255.f, p.colour.g / 255.f,
+                      p.colour.b / 255.f, p.colour.a / 255.f),
+            1.f, 1.f, p.visibility, 0.f};
+}
 }
 
+constexpr size_t Renderer::kMaxInstances;
+
 GLuint compileShader(GLenum type, const char* source) {
     GLuint shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, nullptr);
@@ -101,6 +127,8 @@ void Renderer::swap() {
     drawCounter = 0;
     textureCounter = 0;
     bufferCounter = 0;
+    streamedBytesCounter = 0;
+    streamAllocationCounter = 0;
 }
 
 int Renderer::getDrawCount() {
@@ -115,6 +143,14 @@ int Renderer::getTextureCount() {
     return textureCounter;
 }
 
+size_t Renderer::getStreamedBytes() {
+    return streamedBytesCounter;
+}
+
+int Renderer::getStreamAllocationCount() {
+    return streamAllocationCounter;
+}
+
 const Renderer::SceneUniformData& Renderer::getSceneData() const {
     return lastSceneData;
 }
@@ -162,13 +198,19 @@ OpenGLRenderer::OpenGLRenderer() {
 
     glGenQueries(1, &debugQuery);
 
-    createUBO(UBOScene, sizeof(SceneUniformData), sizeof(SceneUniformData));
+    createUBO(UBOScene, sizeof(SceneUniformData));
     glBindBufferBase(GL_UNIFORM_BUFFER, kUBOIndexScene, UBOScene.name);
 
-    GLint MaxUBOSize;
-    glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &MaxUBOSize);
+    // Object data is streamed, each draw binds its own aligned entry
+    GLint alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    RW_ASSERT(alignment > 0);
+    uboAlignment = alignment;
 
-    createUBO(UBOObject, MaxUBOSize, sizeof(ObjectUniformData));
+    // Draws bind a whole ObjectData block even when they only use the first
+    // entry, so leave room for that after the last allocation
+    streamBuffer =
+        std::make_unique<StreamBuffer>(kStreamRegionSize, kObjectBlockSize);
 
     swap();
 }
@@ -268,8 +310,41 @@ void OpenGLRenderer::setSceneParameters(
     lastSceneData = data;
 }
 
+void OpenGLRenderer::swap() {
+    Renderer::swap();
+    streamBuffer->nextFrame();
+}
+
+void OpenGLRenderer::streamVertices(DrawBuffer* draw, const void* data,
+                                    size_t size,
+                                    const AttributeList& attributes) {
+    if (size == 0) {
+        return;
+    }
+
+    const auto offset = streamBuffer->upload(
+        data, static_cast<GLsizeiptr>(size), kStreamVertexAlignment);
+    countStreamed(size);
+
+    // Bind through the cache so it knows which VAO is current
+    useDrawBuffer(draw);
+    draw->addGeometry(streamBuffer->getName(), offset, attributes);
+}
+
 void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw,
                                   const Renderer::DrawParameters& p) {
+    const auto objectData = makeObjectData(model, p);
+    const auto offset =
+        streamBuffer->upload(&objectData, sizeof(objectData), uboAlignment);
+    countStreamed(sizeof(objectData));
+    glBindBufferRange(GL_UNIFORM_BUFFER, kUBOIndexDraw, streamBuffer->getName(),
+                      offset, kObjectBlockSize);
+
+    setPipelineState(draw, p);
+}
+
+void OpenGLRenderer::setPipelineState(DrawBuffer* draw,
+                                      const Renderer::DrawParameters& p) {
     useDrawBuffer(draw);
 
     for (GLuint u = 0; u < p.textures.size(); ++u) {
@@ -280,12 +355,6 @@ void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw,
     setDepthWrite(p.depthWrite);
     setDepthMode(p.depthMode);
 
-    ObjectUniformData objectData{model,
-                             glm::vec4(p.colour.r / 255.f, p.colour.g / 255.f,
-                                       p.colour.b / 255.f, p.colour.a / 255.f),
-                             1.f, 1.f, p.visibility};
-    uploadUBO(UBOObject, objectData);
-
     drawCounter++;
 #ifdef RW_GRAPHICS_STATS
     if (currentDebugDepth > 0) {
@@ -299,9 +368,11 @@ void OpenGLRenderer::draw(const glm::mat4& model, DrawBuffer* draw,
                           const Renderer::DrawParameters& p) {
     setDrawState(model, draw, p);
 
-    glDrawElements(draw->getFaceType(), static_cast<GLsizei>(p.count),
-                   GL_UNSIGNED_INT,
-                   reinterpret_cast<void*>(sizeof(RenderIndex) * p.start));
+    glDrawElementsBaseVertex(
+        draw->getFaceType(), static_cast<GLsizei>(p.count),
+        draw->getIndexType(),
+        reinterpret_cast<void*>(draw->getIndexSize() * p.start),
+        p.baseVertex);
 }
 
 void OpenGLRenderer::drawArrays(const glm::mat4& model, DrawBuffer* draw,
@@ -311,55 +382,86 @@ void OpenGLRenderer::drawArrays(const glm::mat4& model, DrawBuffer* draw,
     glDrawArrays(draw->getFaceType(), static_cast<GLint>(p.start), static_cast<GLsizei>(p.count));
 }
 
-void OpenGLRenderer::drawBatched(const RenderList& list) {
+void OpenGLRenderer::drawBatched(const RenderList& list,
+                                 const RenderOrder& order) {
     RW_PROFILE_SCOPE(__func__);
-#if 0  // Needs shader changes
-	// Determine how many batches we need to process the entire list
-	auto entries = list.size();
-	glBindBuffer(GL_UNIFORM_BUFFER, UBOObject);
-	for (int b = 0; b < entries; b += maxObjectEntries)
-	{
-		auto toConsume = std::min((GLuint)entries, b + maxObjectEntries) - b;
-		std::vector<ObjectUniformData> uploadBuffer;
-		uploadBuffer.resize(toConsume);
-		for (int d = 0; d < toConsume; ++d)
-		{
-			auto& draw = list[b+d];
-			uploadBuffer[d] = {
-				draw.model,
-				glm::vec4(draw.drawInfo.colour.r/255.f,
-				draw.drawInfo.colour.g/255.f,
-				draw.drawInfo.colour.b/255.f, 1.f),
-				1.f,
-				1.f,
-				draw.drawInfo.colour.a/255.f
-			};
-		}
-		glBufferData(GL_UNIFORM_BUFFER,
-					 toConsume * sizeof(ObjectUniformData),
-					 uploadBuffer.data(),
-					 GL_STREAM_DRAW);
-
-		// Dispatch individual draws
-		for (int d = 0; d < toConsume; ++d)
-		{
-			auto& draw = list[b+d];
-			useDrawBuffer(draw.dbuff);
-
-			for( GLuint u = 0; u < draw.drawInfo.textures.size(); ++u )
-			{
-				useTexture(u, draw.drawInfo.textures[u]);
-			}
-
-			glDrawElements(draw.dbuff->getFaceType(), draw.drawInfo.count, GL_UNSIGNED_INT,
-                           reinterpret_cast<void*>(sizeof(RenderIndex) * draw.drawInfo.start));
-		}
-	}
-#else
-    for (auto& ri : list) {
-        draw(ri.model, ri.dbuff, ri.drawInfo);
+    constexpr auto entrySize = sizeof(ObjectUniformData);
+
+    // Sorting puts instructions with the same state next to each other, each
+    // run of them becomes one instanced draw
+    instanceRuns.clear();
+    for (size_t i = 0; i < order.size();) {
+        const auto count = countInstanceRun(list, order, i);
+        instanceRuns.push_back({i, count, 0});
+        i += count;
     }
+
+    const auto regionSize = streamBuffer->getRegionSize();
+    for (size_t r = 0; r < instanceRuns.size();) {
+        // Write the object data for as many runs as fit in one mapping, each
+        // run starts at an aligned offset so it can be bound as a block
+        auto end = r;
+        GLsizeiptr batchSize = 0;
+        while (end < instanceRuns.size()) {
+            auto runSize = alignTo(
+                static_cast<GLsizeiptr>(instanceRuns[end].count * entrySize),
+                uboAlignment);
+            if (batchSize + runSize > regionSize) {
+                break;
+            }
+            batchSize += runSize;
+            end++;
+        }
+
+        GLintptr base;
+        auto dst = static_cast<uint8_t*>(
+            streamBuffer->map(batchSize, uboAlignment, base));
+        GLintptr runOffset = 0;
+        for (auto k = r; k < end; ++k) {
+            auto& run = instanceRuns[k];
+            run.offset = base + runOffset;
+            for (size_t d = 0; d < run.count; ++d) {
+                const auto& ri = list[order[run.first + d]];
+                const auto objectData = makeObjectData(ri.model, ri.drawInfo);
+                memcpy(dst + runOffset + d * entrySize, &objectData,
+                       entrySize);
+            }
+            runOffset += alignTo(static_cast<GLsizeiptr>(run.count * entrySize),
+                                 uboAlignment);
+        }
+        streamBuffer->unmap();
+        countStreamed(static_cast<size_t>(batchSize));
+#ifdef RW_GRAPHICS_STATS
+        if (currentDebugDepth > 0) {
+            profileInfo[currentDebugDepth - 1].uploads++;
+        }
 #endif
+
+        for (auto k = r; k < end; ++k) {
+            const auto& run = instanceRuns[k];
+            const auto& ri = list[order[run.first]];
+            setPipelineState(ri.dbuff, ri.drawInfo);
+            glBindBufferRange(GL_UNIFORM_BUFFER, kUBOIndexDraw,
+                              streamBuffer->getName(), run.offset,
+                              kObjectBlockSize);
+
+            const auto count = static_cast<GLsizei>(ri.drawInfo.count);
+            const auto indices = reinterpret_cast<void*>(
+                ri.dbuff->getIndexSize() * ri.drawInfo.start);
+            const auto indexType = ri.dbuff->getIndexType();
+            const auto baseVertex = ri.drawInfo.baseVertex;
+            if (run.count == 1) {
+                glDrawElementsBaseVertex(ri.dbuff->getFaceType(), count,
+                                         indexType, indices, baseVertex);
+            } else {
+                glDrawElementsInstancedBaseVertex(
+                    ri.dbuff->getFaceType(), count, indexType, indices,
+                    static_cast<GLsizei>(run.count), baseVertex);
+            }
+        }
+
+        r = end;
+    }
 }
 
 void OpenGLRenderer::invalidate() {
@@ -371,51 +473,27 @@ void OpenGLRenderer::invalidate() {
     setDepthMode(DepthMode::OFF);
 }
 
-bool OpenGLRenderer::createUBO(Buffer &out, GLsizei size, GLsizei entrySize)
+bool OpenGLRenderer::createUBO(Buffer &out, GLsizei size)
 {
     glGenBuffers(1, &out.name);
     glBindBuffer(GL_UNIFORM_BUFFER, out.name);
     glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_STREAM_DRAW);
 
-    if (entrySize != size) {
-        GLint UBOAlignment;
-        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UBOAlignment);
-        RW_ASSERT(UBOAlignment > 0);
-        entrySize = ((entrySize + (UBOAlignment-1))/UBOAlignment) * UBOAlignment;
-    }
-
     out.bufferSize = size;
-    out.entrySize = entrySize;
-    out.entryCount = size / entrySize;
 
     return true;
 }
 
 void OpenGLRenderer::uploadUBOEntry(Buffer &buffer, const void *data, size_t size)
 {
+    RW_ASSERT(size <= static_cast<size_t>(buffer.bufferSize));
     attachUBO(buffer.name);
-    if (buffer.entryCount > 1) {
-        RW_ASSERT(size <= buffer.entrySize);
-        if (buffer.currentEntry >= buffer.entryCount) {
-            // Orphan the buffer, we don't want it anymore
-            glBufferData(GL_UNIFORM_BUFFER, buffer.bufferSize, nullptr,
-                         GL_STREAM_DRAW);
-            buffer.currentEntry = 0;
-        }
-        const auto offset = buffer.currentEntry * buffer.entrySize;
-        const auto flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT
-                           | GL_MAP_UNSYNCHRONIZED_BIT;
-        void* dst = glMapBufferRange(GL_UNIFORM_BUFFER, offset,
-                                     buffer.entrySize, flags);
-        RW_ASSERT(dst != nullptr);
-        memcpy(dst, data, size);
-        glUnmapBuffer(GL_UNIFORM_BUFFER);
-        glBindBufferRange(GL_UNIFORM_BUFFER, kUBOIndexDraw, buffer.name, offset, size);
-        buffer.currentEntry++;
-    }
-    else {
-        glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
-    }
+    glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+}
+
+void OpenGLRenderer::countStreamed(size_t bytes) {
+    streamedBytesCounter += bytes;
+    streamAllocationCounter++;
 }
 
 void OpenGLRenderer::pushDebugGroup(const std::string& title) {
@@ -14,6 +14,8 @@
 #include <gl/gl_core_3_3.h>
 #include <gl/GeometryBuffer.hpp>
 
+#include <render/StreamBuffer.hpp>
+
 class DrawBuffer;
 
 typedef uint64_t RenderKey;
@@ -21,8 +23,6 @@ typedef uint64_t RenderKey;
 // Maximum depth of debug group stack
 #define MAX_DEBUG_DEPTH 5
 
-typedef std::uint32_t RenderIndex;
-
 struct VertexP2 {
     glm::vec2 position{};
 
@@ -86,6 +86,8 @@ public:
         size_t count{};
         /// Start index.
         size_t start{};
+        /// Added to each index
+        GLint baseVertex{};
         /// Textures to use
         Textures textures{};
         /// Blending mode
@@ -127,6 +129,12 @@ public:
         }
     };
     typedef std::vector<RenderInstruction> RenderList;
+    /// Indices into a RenderList, in the order to draw them
+    typedef std::vector<std::uint32_t> RenderOrder;
+
+    /// Maximum number of instances in one draw, this is the size of the
+    /// ObjectData array in the WorldObject shader
+    static constexpr size_t kMaxInstances = 128;
 
     struct ObjectUniformData {
         glm::mat4 model{1.0f};
@@ -134,6 +142,8 @@ public:
         float diffuse{};
         float ambient{};
         float visibility{};
+        /// Pads the struct to its std140 array stride
+        float padding{};
     };
 
     struct SceneUniformData {
@@ -189,7 +199,29 @@ public:
     virtual void drawArrays(const glm::mat4& model, DrawBuffer* draw,
                             const DrawParameters& p) = 0;
 
-    virtual void drawBatched(const RenderList& list) = 0;
+    /**
+     * @brief drawBatched Draws the instructions in list in the given order
+     */
+    virtual void drawBatched(const RenderList& list,
+                             const RenderOrder& order) = 0;
+
+    /**
+     * @brief streamVertices Copies vertex data that is only drawn this frame
+     * into the stream buffer, and points draw's attributes at it
+     */
+    virtual void streamVertices(DrawBuffer* draw, const void* data,
+                                size_t size,
+                                const AttributeList& attributes) = 0;
+
+    /**
+     * Streams the vertices in an STL vector, T::vertex_attributes() is
+     * assumed to exist as it is for GeometryBuffer::uploadVertices.
+     */
+    template <class T>
+    void streamVertices(DrawBuffer* draw, const std::vector<T>& data) {
+        streamVertices(draw, data.data(), data.size() * sizeof(T),
+                       T::vertex_attributes());
+    }
 
     void setViewport(const glm::ivec2& vp);
     const glm::ivec2& getViewport() const {
@@ -205,7 +237,7 @@ public:
     /**
      * Resets all per-frame counters.
      */
-    void swap();
+    virtual void swap();
 
     /**
      * Returns the number of draw calls issued for the current frame.
@@ -213,6 +245,12 @@ public:
     int getDrawCount();
     int getTextureCount();
     int getBufferCount();
+    /**
+     * Returns the number of bytes streamed to the GPU for the current frame,
+     * and the number of allocations they were streamed in.
+     */
+    size_t getStreamedBytes();
+    int getStreamAllocationCount();
 
     const SceneUniformData& getSceneData() const;
 
@@ -250,6 +288,8 @@ protected:
     int drawCounter{};
     int textureCounter{};
     int bufferCounter{};
+    size_t streamedBytesCounter{};
+    int streamAllocationCounter{};
     SceneUniformData lastSceneData{};
 };
 
@@ -316,12 +356,22 @@ public:
     void setDrawState(const glm::mat4& model, DrawBuffer* draw,
                       const DrawParameters& p);
 
+    /// Binds the buffers, textures and blend/depth state for a draw
+    void setPipelineState(DrawBuffer* draw, const DrawParameters& p);
+
     void draw(const glm::mat4& model, DrawBuffer* draw,
               const DrawParameters& p) override;
     void drawArrays(const glm::mat4& model, DrawBuffer* draw,
                     const DrawParameters& p) override;
 
-    void drawBatched(const RenderList& list) override;
+    void drawBatched(const RenderList& list,
+                     const RenderOrder& order) override;
+
+    using Renderer::streamVertices;
+    void streamVertices(DrawBuffer* draw, const void* data, size_t size,
+                        const AttributeList& attributes) override;
+
+    void swap() override;
 
     void invalidate() override;
 
@@ -332,10 +382,6 @@ public:
 private:
     struct Buffer {
         GLuint name{};
-        GLuint currentEntry{};
-
-        GLuint entryCount{};
-        GLuint entrySize{};
         GLsizei bufferSize{};
     };
 
@@ -343,9 +389,21 @@ private:
 
     void useTexture(GLuint unit, GLuint tex);
 
-    Buffer UBOObject {};
     Buffer UBOScene {};
 
+    /// Ring for per-object uniforms and other data only used for a frame
+    std::unique_ptr<StreamBuffer> streamBuffer;
+    GLsizeiptr uboAlignment = 1;
+
+    /// Instructions drawn with one call, a range of a RenderOrder
+    struct InstanceRun {
+        size_t first;
+        size_t count;
+        /// Offset of the run's object data in the stream buffer
+        GLintptr offset;
+    };
+    std::vector<InstanceRun> instanceRuns;
+
     // State Cache
     DrawBuffer* currentDbuff = nullptr;
     OpenGLShaderProgram* currentProgram = nullptr;
@@ -411,7 +469,7 @@ private:
     }
 
     // Buffer Helpers
-    bool createUBO(Buffer& out, GLsizei size, GLsizei entrySize);
+    bool createUBO(Buffer& out, GLsizei size);
 
     void attachUBO(GLuint buffer) {
         if (currentUBO != buffer) {
@@ -422,6 +480,8 @@ private:
 
     void uploadUBOEntry(Buffer& buffer, const void *data, size_t size);
 
+    void countStreamed(size_t bytes);
+
     // Debug group profiling timers
     ProfileInfo profileInfo[MAX_DEBUG_DEPTH];
     GLuint debugQuery;
@@ -435,5 +495,6 @@ GLuint compileShader(GLenum type, const char* source);
 GLuint compileProgram(const char* vertex, const char* fragment);
 
 typedef Renderer::RenderList RenderList;
+typedef Renderer::RenderOrder RenderOrder;
 
 #endif
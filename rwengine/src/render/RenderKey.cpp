@@ -0,0 +1,122 @@
+#include "render/RenderKey.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include <rw/debug.hpp>
+
+namespace {
+constexpr unsigned int kTextureBits = 24;
+constexpr unsigned int kVAOBits = 23;
+constexpr unsigned int kDepthBits = 16;
+
+constexpr unsigned int kVAOShift = kTextureBits;
+constexpr unsigned int kDepthShift = kVAOShift + kVAOBits;
+constexpr unsigned int kPassShift = kDepthShift + kDepthBits;
+
+constexpr uint64_t kMaxDepth = (1ull << kDepthBits) - 1;
+/// Opaque draws only keep the high bits of their depth
+constexpr uint64_t kOpaqueDepthMask = 0xFC00;
+
+constexpr uint64_t mask(unsigned int bits) {
+    return (1ull << bits) - 1;
+}
+
+/// Radix sort digit size
+constexpr unsigned int kDigitBits = 8;
+constexpr size_t kDigitCount = 64 / kDigitBits;
+constexpr size_t kBucketCount = 1u << kDigitBits;
+
+using KeyIndex = std::pair<RenderKey, uint32_t>;
+}  // namespace
+
+RenderKey makeRenderKey(BlendMode blendMode, float normalizedDepth,
+                        GLuint vao, GLuint texture) {
+    auto depth = static_cast<uint64_t>(
+        std::min(std::max(normalizedDepth, 0.f), 1.f) * kMaxDepth);
+
+    uint64_t pass = 0;
+    if (blendMode == BlendMode::BLEND_NONE) {
+        depth &= kOpaqueDepthMask;
+    } else {
+        pass = 1;
+        depth = kMaxDepth - depth;
+    }
+
+    return (pass << kPassShift) | (depth << kDepthShift) |
+           ((vao & mask(kVAOBits)) << kVAOShift) |
+           (texture & mask(kTextureBits));
+}
+
+void sortRenderList(const RenderList& list, RenderOrder& order) {
+    RW_ASSERT(list.size() <= UINT32_MAX);
+    const auto count = list.size();
+
+    std::vector<KeyIndex> keys(count);
+    std::array<std::array<size_t, kBucketCount>, kDigitCount> histograms{};
+    for (size_t i = 0; i < count; ++i) {
+        auto key = list[i].sortKey;
+        keys[i] = {key, static_cast<uint32_t>(i)};
+        for (size_t d = 0; d < kDigitCount; ++d) {
+            histograms[d][(key >> (d * kDigitBits)) & (kBucketCount - 1)]++;
+        }
+    }
+
+    // Least significant digit first, each pass is stable
+    std::vector<KeyIndex> scratch(count);
+    for (size_t d = 0; d < kDigitCount; ++d) {
+        auto& histogram = histograms[d];
+        auto shift = d * kDigitBits;
+
+        // Every key has the same digit, so this pass wouldn't move anything
+        if (count == 0 ||
+            histogram[(keys[0].first >> shift) & (kBucketCount - 1)] ==
+                count) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto& bucket : histogram) {
+            auto bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+
+        for (const auto& key : keys) {
+            scratch[histogram[(key.first >> shift) & (kBucketCount - 1)]++] =
+                key;
+        }
+        std::swap(keys, scratch);
+    }
+
+    order.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = keys[i].second;
+    }
+}
+
+bool canInstance(const Renderer::RenderInstruction& a,
+                 const Renderer::RenderInstruction& b) {
+    return a.dbuff == b.dbuff && a.drawInfo.start == b.drawInfo.start &&
+           a.drawInfo.count == b.drawInfo.count &&
+           a.drawInfo.baseVertex == b.drawInfo.baseVertex &&
+           a.drawInfo.textures == b.drawInfo.textures &&
+           a.drawInfo.blendMode == b.drawInfo.blendMode &&
+           a.drawInfo.depthMode == b.drawInfo.depthMode &&
+           a.drawInfo.depthWrite == b.drawInfo.depthWrite;
+}
+
+size_t countInstanceRun(const RenderList& list, const RenderOrder& order,
+                        size_t first) {
+    RW_ASSERT(first < order.size());
+    const auto& instruction = list[order[first]];
+    size_t count = 1;
+    while (first + count < order.size() &&
+           count < Renderer::kMaxInstances &&
+           canInstance(instruction, list[order[first + count]])) {
+        count++;
+    }
+    return count;
+}
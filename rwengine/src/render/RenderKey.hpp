@@ -0,0 +1,45 @@
+#ifndef _RWENGINE_RENDERKEY_HPP_
+#define _RWENGINE_RENDERKEY_HPP_
+
+#include <render/OpenGLRenderer.hpp>
+
+/**
+ * @brief makeRenderKey Packs the state that decides draw order into a key
+ *
+ * From the most significant bit the key holds: the translucent pass flag,
+ * 16 bits of depth, 23 bits of VAO name and 24 bits of texture name.
+ * Opaque draws are ordered front to back and translucent ones back to front.
+ * Opaque depth is bucketed coarsely, so that draws sharing a VAO and texture
+ * end up next to each other.
+ *
+ * @param normalizedDepth Distance from the camera, 0 at the near plane and 1
+ * at the far plane
+ */
+RenderKey makeRenderKey(BlendMode blendMode, float normalizedDepth,
+                        GLuint vao, GLuint texture);
+
+/**
+ * @brief sortRenderList Finds the order to draw a list in
+ *
+ * The instructions are left in place; order is filled with their indices
+ * sorted by ascending key. Instructions with equal keys keep their order.
+ */
+void sortRenderList(const RenderList& list, RenderOrder& order);
+
+/**
+ * @brief canInstance Whether two instructions only differ by their object
+ * data, so they can be drawn with one instanced draw
+ */
+bool canInstance(const Renderer::RenderInstruction& a,
+                 const Renderer::RenderInstruction& b);
+
+/**
+ * @brief countInstanceRun Counts the instructions from first in order that
+ * can be drawn together with it
+ *
+ * @return At least 1, at most Renderer::kMaxInstances
+ */
+size_t countInstanceRun(const RenderList& list, const RenderOrder& order,
+                        size_t first);
+
+#endif
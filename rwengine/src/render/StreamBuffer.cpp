@@ -0,0 +1,115 @@
+#include "render/StreamBuffer.hpp"
+
+#include <cstring>
+
+#include <rw/debug.hpp>
+
+namespace {
+/// How long to wait on a fence before checking it again, in nanoseconds
+constexpr GLuint64 kFenceWaitTimeout = 1000000;
+
+GLsizeiptr alignTo(GLsizeiptr offset, GLsizeiptr alignment) {
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+}  // namespace
+
+StreamBuffer::StreamBuffer(GLsizeiptr regionSize, GLsizeiptr padding)
+    : regionSize(regionSize) {
+    const auto size = regionSize * kRegionCount + padding;
+
+    // Use the copy target so that the renderer's array and uniform buffer
+    // bindings aren't disturbed
+    glGenBuffers(1, &name);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, name);
+    if (ogl_ext_ARB_buffer_storage) {
+        const GLbitfield flags =
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+        persistent = static_cast<GLubyte*>(
+            glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+        RW_CHECK(persistent != nullptr, "Failed to map stream buffer");
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (auto fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if (persistent) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, name);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    glDeleteBuffers(1, &name);
+}
+
+void* StreamBuffer::map(GLsizeiptr size, GLsizeiptr alignment,
+                        GLintptr& offset) {
+    RW_ASSERT(size <= regionSize);
+
+    auto start = alignTo(head, alignment);
+    if (start + size > regionSize) {
+        // The region is full, carry on in the next one
+        nextFrame();
+        start = 0;
+    }
+    head = start + size;
+    offset = region * regionSize + start;
+
+    if (persistent) {
+        return persistent + offset;
+    }
+
+    // The fences already keep this range from being in use
+    glBindBuffer(GL_COPY_WRITE_BUFFER, name);
+    void* dst = glMapBufferRange(
+        GL_COPY_WRITE_BUFFER, offset, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+            GL_MAP_UNSYNCHRONIZED_BIT);
+    RW_ASSERT(dst != nullptr);
+    return dst;
+}
+
+void StreamBuffer::unmap() {
+    if (!persistent) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, name);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+}
+
+GLintptr StreamBuffer::upload(const void* data, GLsizeiptr size,
+                              GLsizeiptr alignment) {
+    GLintptr offset;
+    auto dst = map(size, alignment, offset);
+    memcpy(dst, data, static_cast<size_t>(size));
+    unmap();
+    return offset;
+}
+
+void StreamBuffer::nextFrame() {
+    if (head == 0) {
+        // Nothing was written to this region
+        return;
+    }
+
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    enterRegion((region + 1) % kRegionCount);
+}
+
+void StreamBuffer::enterRegion(unsigned int index) {
+    region = index;
+    head = 0;
+
+    auto& fence = fences[region];
+    if (!fence) {
+        return;
+    }
+    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                            kFenceWaitTimeout) == GL_TIMEOUT_EXPIRED) {
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
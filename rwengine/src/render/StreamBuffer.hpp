@@ -0,0 +1,81 @@
+#ifndef _RWENGINE_STREAMBUFFER_HPP_
+#define _RWENGINE_STREAMBUFFER_HPP_
+
+#include <array>
+
+#include <gl/gl_core_3_3.h>
+
+/**
+ * @brief Ring of buffer memory for data that is only drawn once.
+ *
+ * The buffer is split into regions that are filled one after another. When a
+ * region is finished a fence is placed after the commands that read it, and
+ * the region isn't written again until the fence has passed, so writes never
+ * have to wait on the driver. With ARB_buffer_storage the buffer stays
+ * mapped, otherwise each allocation maps its own range without
+ * synchronisation.
+ */
+class StreamBuffer {
+public:
+    static constexpr unsigned int kRegionCount = 3;
+
+    /**
+     * @param regionSize The size of each region, allocations can't be larger
+     * than this
+     * @param padding Extra space after the last region, so that ranges
+     * bound past the end of an allocation stay inside the buffer
+     */
+    explicit StreamBuffer(GLsizeiptr regionSize, GLsizeiptr padding = 0);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    GLuint getName() const {
+        return name;
+    }
+
+    GLsizeiptr getRegionSize() const {
+        return regionSize;
+    }
+
+    /**
+     * @brief map Allocates size bytes for writing
+     *
+     * unmap() must be called once the data has been written, before the
+     * buffer is used by a draw.
+     *
+     * @param alignment The offset of the allocation is a multiple of this
+     * @param offset Set to the offset of the allocation in the buffer
+     * @return Pointer to write the data through
+     */
+    void* map(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset);
+    void unmap();
+
+    /**
+     * @brief upload Copies data into a new allocation
+     * @return The offset of the data in the buffer
+     */
+    GLintptr upload(const void* data, GLsizeiptr size, GLsizeiptr alignment);
+
+    /**
+     * @brief nextFrame Moves on to the next region, called once per frame
+     */
+    void nextFrame();
+
+private:
+    void enterRegion(unsigned int index);
+
+    GLuint name = 0;
+    GLsizeiptr regionSize;
+
+    /// The buffer's memory when it is persistently mapped
+    GLubyte* persistent = nullptr;
+
+    std::array<GLsync, kRegionCount> fences{};
+    unsigned int region = 0;
+    /// Offset of the next allocation within the current region
+    GLsizeiptr head = 0;
+};
+
+#endif
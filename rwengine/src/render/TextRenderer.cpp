@@ -341,14 +341,13 @@ void TextRenderer::renderText(const TextRenderer::TextInfo& ti,
     renderer->getRenderer()->setUniformTexture(textShader.get(), "fontTexture", 0);
     renderer->getRenderer()->setUniform(textShader.get(), "alignment", alignment);
 
-    gb.uploadVertices(geo);
-    db.addGeometry(&gb);
+    renderer->getRenderer()->streamVertices(&db, geo);
     db.setFaceType(GL_TRIANGLES);
 
     Renderer::DrawParameters dp;
     dp.start = 0;
     dp.blendMode = BlendMode::BLEND_ALPHA;
-    dp.count = gb.getCount();
+    dp.count = geo.size();
     auto ftexture = renderer->getData()->findSlotTexture("fonts", fontMetaData.textureName);
     dp.textures = {{ftexture->getName()}};
     dp.depthMode = DepthMode::OFF;
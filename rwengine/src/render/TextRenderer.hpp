@@ -92,7 +92,6 @@ private:
     GameRenderer* renderer;
     std::unique_ptr<Renderer::ShaderProgram> textShader;
 
-    GeometryBuffer gb;
     DrawBuffer db;
 };
 #endif
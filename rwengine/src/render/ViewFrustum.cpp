@@ -0,0 +1,99 @@
+#include "render/ViewFrustum.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RW_FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+uint64_t countMask(size_t count) {
+    return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+}
+}  // namespace
+
+#if defined(__AVX__)
+
+uint64_t ViewFrustum::intersects(const SphereBatch& batch) const {
+    __m256 nx[6], ny[6], nz[6], nd[6];
+    for (auto p = 0u; p < 6; ++p) {
+        nx[p] = _mm256_set1_ps(planes[p].normal.x);
+        ny[p] = _mm256_set1_ps(planes[p].normal.y);
+        nz[p] = _mm256_set1_ps(planes[p].normal.z);
+        nd[p] = _mm256_set1_ps(planes[p].distance);
+    }
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < batch.count; i += 8) {
+        const auto x = _mm256_loadu_ps(batch.x + i);
+        const auto y = _mm256_loadu_ps(batch.y + i);
+        const auto z = _mm256_loadu_ps(batch.z + i);
+        const auto r = _mm256_sub_ps(_mm256_setzero_ps(),
+                                     _mm256_loadu_ps(batch.radius + i));
+
+        auto outside = _mm256_setzero_ps();
+        for (auto p = 0u; p < 6; ++p) {
+            auto d = _mm256_add_ps(_mm256_mul_ps(nx[p], x),
+                                   _mm256_mul_ps(ny[p], y));
+            d = _mm256_add_ps(d, _mm256_mul_ps(nz[p], z));
+            d = _mm256_add_ps(d, nd[p]);
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, r, _CMP_LT_OQ));
+        }
+
+        auto visible = ~static_cast<unsigned>(_mm256_movemask_ps(outside));
+        mask |= static_cast<uint64_t>(visible & 0xFFu) << i;
+    }
+
+    return mask & countMask(batch.count);
+}
+
+#elif defined(RW_FRUSTUM_SSE)
+
+uint64_t ViewFrustum::intersects(const SphereBatch& batch) const {
+    __m128 nx[6], ny[6], nz[6], nd[6];
+    for (auto p = 0u; p < 6; ++p) {
+        nx[p] = _mm_set1_ps(planes[p].normal.x);
+        ny[p] = _mm_set1_ps(planes[p].normal.y);
+        nz[p] = _mm_set1_ps(planes[p].normal.z);
+        nd[p] = _mm_set1_ps(planes[p].distance);
+    }
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < batch.count; i += 4) {
+        const auto x = _mm_loadu_ps(batch.x + i);
+        const auto y = _mm_loadu_ps(batch.y + i);
+        const auto z = _mm_loadu_ps(batch.z + i);
+        const auto r =
+            _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(batch.radius + i));
+
+        auto outside = _mm_setzero_ps();
+        for (auto p = 0u; p < 6; ++p) {
+            auto d = _mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y));
+            d = _mm_add_ps(d, _mm_mul_ps(nz[p], z));
+            d = _mm_add_ps(d, nd[p]);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(d, r));
+        }
+
+        auto visible = ~static_cast<unsigned>(_mm_movemask_ps(outside));
+        mask |= static_cast<uint64_t>(visible & 0xFu) << i;
+    }
+
+    return mask & countMask(batch.count);
+}
+
+#else
+
+uint64_t ViewFrustum::intersects(const SphereBatch& batch) const {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < batch.count; ++i) {
+        glm::vec3 center(batch.x[i], batch.y[i], batch.z[i]);
+        if (intersects(center, batch.radius[i])) {
+            mask |= uint64_t(1) << i;
+        }
+    }
+    return mask;
+}
+
+#endif
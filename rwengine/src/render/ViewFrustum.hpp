@@ -1,6 +1,9 @@
 #ifndef _RWENGINE_VIEWFRUSTUM_HPP_
 #define _RWENGINE_VIEWFRUSTUM_HPP_
 
+#include <cstddef>
+#include <cstdint>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -16,6 +19,36 @@ public:
         float distance{};
     };
 
+    /**
+     * @brief Bounding spheres in structure of arrays layout, so that
+     * several can be tested against the planes at once
+     *
+     * The arrays are aligned for speed, but batches may also live where
+     * the alignment isn't honoured (e.g. std::vector before C++17), so
+     * they are never loaded with aligned loads.
+     */
+    struct SphereBatch {
+        static constexpr size_t kSize = 64;
+
+        alignas(32) float x[kSize]{};
+        alignas(32) float y[kSize]{};
+        alignas(32) float z[kSize]{};
+        alignas(32) float radius[kSize]{};
+        size_t count = 0;
+
+        bool full() const {
+            return count == kSize;
+        }
+
+        void push(const glm::vec3& center, float r) {
+            x[count] = center.x;
+            y[count] = center.y;
+            z[count] = center.z;
+            radius[count] = r;
+            ++count;
+        }
+    };
+
     float near{};
     float far{};
     float fov{};
@@ -57,6 +90,13 @@ public:
 
         return result;
     }
+
+    /**
+     * @brief intersects Tests every sphere in a batch, giving the same
+     * results as testing them one at a time
+     * @return Mask with bit i set if sphere i is visible
+     */
+    uint64_t intersects(const SphereBatch& batch) const;
 };
 
 #endif
@@ -10886,6 +10886,9 @@ void opcode_03b6(const ScriptArguments& args, ScriptVec3 coord, const ScriptFloa
 
     auto newobjectid = args.getWorld()->data->findModelObject(newmodel);
     auto nobj = args.getWorld()->data->findModelInfo<SimpleModelInfo>(newobjectid);
+    if (nobj) {
+        args.getWorld()->data->requestModel(newobjectid, StreamingPriority::High);
+    }
 
     for(auto& p : args.getWorld()->instancePool.objects) {
         auto o = p.second.get();
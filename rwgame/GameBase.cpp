@@ -42,7 +42,12 @@ GameBase::GameBase(Logger &inlog, int argc, char *argv[]) :
     po::options_description desc_devel("Developer options");
     desc_devel.add_options()(
         "test,t", "Starts a new game in a test location")(
-        "benchmark,b", po::value<std::string>()->value_name("PATH"), "Run benchmark from file");
+        "benchmark,b", po::value<std::string>()->value_name("PATH"), "Run benchmark from file")(
+        "world-cache", po::value<rwfs::path>()->value_name("PATH"), "Cache parsed world data in file to speed up later starts")(
+        "compact-vertices", "Store model vertices in a packed format to save video memory")(
+        "cpu-mipmaps", "Build texture mipmaps on the loading threads instead of in the driver")(
+        "model-memory", po::value<size_t>()->value_name("MB"), "Unload streamed models that haven't been drawn recently above this much geometry")(
+        "texture-memory", po::value<size_t>()->value_name("MB"), "Unload streamed texture dictionaries that are no longer used above this much texture memory");
     po::options_description desc("Generic options");
     desc.add_options()(
         "config,c", po::value<rwfs::path>()->value_name("PATH"), "Path of configuration file")(
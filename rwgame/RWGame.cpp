@@ -63,6 +63,28 @@ RWGame::RWGame(Logger& log, int argc, char* argv[])
                                  config.getGameDataPath().string());
     }
 
+    if (options.count("world-cache")) {
+        data.worldCachePath = options["world-cache"].as<rwfs::path>();
+    }
+
+    if (options.count("compact-vertices")) {
+        data.dffLoader.setCompactVertices(true);
+    }
+
+    if (options.count("cpu-mipmaps")) {
+        data.textureLoader.setBuildMipmaps(true);
+    }
+
+    ResidencyManager::Budget budget;
+    if (options.count("model-memory")) {
+        budget.modelBytes = options["model-memory"].as<size_t>() * 1024 * 1024;
+    }
+    if (options.count("texture-memory")) {
+        budget.textureBytes =
+            options["texture-memory"].as<size_t>() * 1024 * 1024;
+    }
+    data.residency.setBudget(budget);
+
     data.load();
 
     for (const auto& p : kSpecialModels) {
@@ -390,6 +412,9 @@ int RWGame::run() {
             accumulatedTime = tickWorld(deltaTime, accumulatedTime);
         }
 
+        world->updateStreaming();
+        world->updateMemoryUsage();
+
         render(1, frameTime);
 
         getWindow().swap();
@@ -587,6 +612,9 @@ void RWGame::render(float alpha, float time) {
     RW_PROFILE_SCOPEC(__func__, MP_CORNFLOWERBLUE);
 
     lastDraws = getRenderer().getRenderer()->getDrawCount();
+    lastStreamedBytes = getRenderer().getRenderer()->getStreamedBytes();
+    lastStreamAllocations =
+        getRenderer().getRenderer()->getStreamAllocationCount();
 
     getRenderer().getRenderer()->swap();
 
@@ -674,6 +702,8 @@ void RWGame::renderDebugStats(float time) {
        << renderer.getCulledCount() << "/"
        << renderer.getRenderer()->getTextureCount() << "/"
        << renderer.getRenderer()->getBufferCount() << "\n"
+       << "Streamed: " << (lastStreamedBytes / 1024) << "KiB in "
+       << lastStreamAllocations << " allocations\n"
        << "Timescale: " << world->state->basic.timeScale;
 
     TextRenderer::TextInfo ti;
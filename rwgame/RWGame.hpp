@@ -51,6 +51,8 @@ class RWGame final : public GameBase {
 
     DebugViewMode debugview_ = DebugViewMode::Disabled;
     int lastDraws{0};  /// Number of draws issued for the last frame.
+    size_t lastStreamedBytes{0};  /// Bytes streamed to the GPU last frame.
+    int lastStreamAllocations{0};
 
     std::string cheatInputWindow = std::string(32, ' ');
 
@@ -1,6 +1,7 @@
 #include "DebugState.hpp"
 #include <ai/PlayerController.hpp>
 #include <data/WeaponData.hpp>
+#include <engine/GameData.hpp>
 #include <engine/GameState.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/string_cast.hpp>
@@ -8,6 +9,7 @@
 #include <objects/CharacterObject.hpp>
 #include <objects/InstanceObject.hpp>
 #include <objects/VehicleObject.hpp>
+#include <rw/memory.hpp>
 #include <script/SCMFile.hpp>
 #include <sstream>
 #include "RWGame.hpp"
@@ -59,7 +61,8 @@ std::shared_ptr<Menu> DebugState::createDebugMenu() {
          {"Full Health", [=] { player->getCurrentState().health = 100.f; }},
          {"Full Armour", [=] { player->getCurrentState().armour = 100.f; }},
          {"Cull Here",
-          [=] { game->getRenderer().setCullOverride(true, _debugCam); }}},
+          [=] { game->getRenderer().setCullOverride(true, _debugCam); }},
+         {"Dump Memory Usage", [=] { printMemoryUsage(); }}},
         kDebugFont, kDebugEntryHeight);
 
     menu->offset = kDebugMenuOffset;
@@ -473,6 +476,35 @@ void DebugState::printCameraDetails() {
               << " " << _debugCam.rotation.w << std::endl;
 }
 
+void DebugState::printMemoryUsage() {
+    auto world = game->getWorld();
+    world->updateMemoryUsage();
+
+    constexpr size_t kKiB = 1024;
+    std::cout << "Memory usage (KiB):" << std::endl;
+    for (size_t t = 0; t < MemoryUsage::kTagCount; ++t) {
+        auto tag = static_cast<MemoryTag>(t);
+        std::cout << "  " << MemoryUsage::getName(tag) << ": "
+                  << MemoryUsage::get(tag) / kKiB << std::endl;
+    }
+    std::cout << "  total: " << MemoryUsage::total() / kKiB << std::endl;
+
+    const auto& residency = world->data->residency;
+    const auto& budget = residency.getBudget();
+    std::cout << "Streamed models: " << residency.getModelCount() << ", "
+              << residency.getModelBytes() / kKiB;
+    if (budget.modelBytes != 0) {
+        std::cout << " of " << budget.modelBytes / kKiB;
+    }
+    std::cout << std::endl;
+    std::cout << "Streamed texture slots: " << residency.getTextureSlotCount()
+              << ", " << residency.getTextureBytes() / kKiB;
+    if (budget.textureBytes != 0) {
+        std::cout << " of " << budget.textureBytes / kKiB;
+    }
+    std::cout << std::endl;
+}
+
 void DebugState::spawnVehicle(unsigned int id) {
     auto ch = game->getWorld()->getPlayer()->getCharacter();
     if (!ch) return;
@@ -35,6 +35,8 @@ public:
 
     void printCameraDetails();
 
+    void printMemoryUsage();
+
     void spawnVehicle(unsigned int id);
     void spawnFollower(unsigned int id);
     void giveItem(int slot);
@@ -0,0 +1,92 @@
+#include <render/ViewFrustum.hpp>
+
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Compares testing bounding spheres against the view frustum one at a time
+// with testing them in batches.
+
+namespace {
+constexpr size_t kSphereCount = 1 << 16;
+constexpr int kRepeats = 200;
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Sphere {
+    glm::vec3 center;
+    float radius;
+};
+
+double nanosecondsPerSphere(Clock::duration elapsed) {
+    auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    return ns / (static_cast<double>(kSphereCount) * kRepeats);
+}
+}  // namespace
+
+int main() {
+    ViewFrustum frustum(0.1f, 1000.f, glm::half_pi<float>(), 16.f / 9.f);
+    frustum.update(frustum.projection());
+
+    // Spread the spheres all around the camera, like a city seen from street
+    // level
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+    std::uniform_real_distribution<float> height(-50.f, 100.f);
+    std::uniform_real_distribution<float> radius(1.f, 30.f);
+    std::vector<Sphere> spheres(kSphereCount);
+    for (auto& sphere : spheres) {
+        sphere.center = {coordinate(random), height(random),
+                         coordinate(random)};
+        sphere.radius = radius(random);
+    }
+
+    std::vector<ViewFrustum::SphereBatch> batches(
+        kSphereCount / ViewFrustum::SphereBatch::kSize);
+    for (size_t i = 0; i < kSphereCount; ++i) {
+        auto& batch = batches[i / ViewFrustum::SphereBatch::kSize];
+        batch.push(spheres[i].center, spheres[i].radius);
+    }
+
+    size_t singleVisible = 0;
+    auto start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r) {
+        for (const auto& sphere : spheres) {
+            singleVisible += frustum.intersects(sphere.center, sphere.radius);
+        }
+    }
+    auto single = Clock::now() - start;
+
+    size_t batchVisible = 0;
+    start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r) {
+        for (const auto& batch : batches) {
+            auto mask = frustum.intersects(batch);
+            for (; mask != 0; mask &= mask - 1) {
+                ++batchVisible;
+            }
+        }
+    }
+    auto batched = Clock::now() - start;
+
+    if (singleVisible != batchVisible) {
+        std::cerr << "Results differ: " << singleVisible / kRepeats
+                  << " visible one at a time, " << batchVisible / kRepeats
+                  << " in batches\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << kSphereCount << " spheres, "
+              << singleVisible / kRepeats << " visible\n"
+              << "single:  " << nanosecondsPerSphere(single)
+              << " ns/sphere\n"
+              << "batched: " << nanosecondsPerSphere(batched)
+              << " ns/sphere\n";
+    return EXIT_SUCCESS;
+}
@@ -11,6 +11,7 @@
 #include <objects/VehicleObject.hpp>
 #include <render/GameRenderer.hpp>
 #include <render/ObjectRenderer.hpp>
+#include <render/RenderKey.hpp>
 #include <render/TextRenderer.hpp>
 
 #include <QFileDialog>
@@ -85,7 +86,9 @@ void ViewerWidget::drawModel(GameRenderer& r, ClumpPtr& model) {
     ObjectRenderer _renderer(world(), vc, 1.f);
     RenderList renders;
     _renderer.renderClump(model.get(), glm::mat4(1.0f), nullptr, renders);
-    r.getRenderer()->drawBatched(renders);
+    RenderOrder order;
+    sortRenderList(renders, order);
+    r.getRenderer()->drawBatched(renders, order);
 
     drawFrameWidget(model->getFrame().get());
     r.renderPostProcess();
@@ -105,13 +108,11 @@ void ViewerWidget::drawObject(GameRenderer &r, GameObject *object) {
 
     ObjectRenderer objectRenderer(world(), vc, 1.f);
     RenderList renders;
+    ObjectRenderer::prepareObject(object);
     objectRenderer.buildRenderList(object, renders);
-    std::sort(renders.begin(), renders.end(),
-              [](const Renderer::RenderInstruction& a,
-                 const Renderer::RenderInstruction& b) {
-                  return a.sortKey < b.sortKey;
-              });
-    r.getRenderer()->drawBatched(renders);
+    RenderOrder order;
+    sortRenderList(renders, order);
+    r.getRenderer()->drawBatched(renders, order);
     r.renderPostProcess();
 }
 
@@ -37,22 +37,14 @@ void ModelViewer::showObject(uint16_t object) {
         return;
     }
 
-    auto modelName = def->name + ".dff";
-    auto textureName = def->name + ".txd";
-    auto textures = world()->data->loadTextureArchive(textureName);
-
-    LoaderDFF dffLoader;
-    dffLoader.setTextureLookupCallback(
-        [&](const std::string& texture, const std::string&) {
-            return textures.at(texture);
-        });
-
-    auto file = world()->data->index.openFile(modelName);
-    if (!file.data) {
-        RW_ERROR("Couldn't load " << modelName);
+    // Load through the world's loader, so the model shares its geometry arena
+    auto data = world()->data;
+    data->loadTXD(def->name + ".txd");
+    auto model = data->loadClump(def->name + ".dff", def->name);
+    if (!model) {
         return;
     }
-    showModel(dffLoader.loadFromMemory(file));
+    showModel(model);
 }
 
 
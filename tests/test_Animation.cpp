@@ -2,6 +2,7 @@
 #include <data/Clump.hpp>
 #include <engine/Animator.hpp>
 #include <loaders/LoaderIFP.hpp>
+#include <glm/gtc/constants.hpp>
 #include <glm/gtx/string_cast.hpp>
 #include "test_Globals.hpp"
 
@@ -46,4 +47,115 @@ BOOST_AUTO_TEST_CASE(test_matrix) {
 }
 #endif
 
+BOOST_AUTO_TEST_CASE(test_keyframe_cursor) {
+    std::vector<AnimationKeyframe> frames;
+    for (int i = 0; i < 10; ++i) {
+        frames.emplace_back(glm::quat{1.0f, 0.0f, 0.0f, 0.0f},
+                            glm::vec3(static_cast<float>(i), 0.f, 0.f),
+                            glm::vec3(1.f), static_cast<float>(i), i);
+    }
+    AnimationBone bone("bone", 0, 0, 9.f, AnimationBone::RT0, frames);
+
+    // The cursor gives the same result as searching from the start
+    size_t cursor = 0;
+    for (float t = 0.f; t <= 9.f; t += 0.25f) {
+        BOOST_CHECK_EQUAL(bone.findKeyframe(t, cursor), bone.findKeyframe(t));
+        auto kf = bone.getInterpolatedKeyframe(t, cursor);
+        BOOST_CHECK_CLOSE(kf.position.x, t, 0.001f);
+    }
+
+    // Going back or jumping ahead still finds the right keyframe
+    BOOST_CHECK_EQUAL(bone.findKeyframe(1.5f, 8), 2);
+    BOOST_CHECK_EQUAL(bone.findKeyframe(8.5f, 1), 9);
+    BOOST_CHECK_EQUAL(bone.findKeyframe(3.f, 3), 3);
+    BOOST_CHECK_EQUAL(bone.findKeyframe(20.f, 9), frames.size());
+    BOOST_CHECK_EQUAL(bone.findKeyframe(1.f, frames.size()), 1);
+
+    BOOST_CHECK_EQUAL(bone.getKeyframe(4.5f).id, 4);
+    BOOST_CHECK_EQUAL(bone.getKeyframe(-1.f).id, 0);
+    BOOST_CHECK_EQUAL(bone.getKeyframe(20.f).id, 9);
+}
+
+BOOST_AUTO_TEST_CASE(test_pose_blend) {
+    // Enough frames to cover both the vector loop and the remainder
+    const size_t count = 7;
+    AnimationPose a, b;
+    a.resize(count);
+    b.resize(count);
+    std::vector<float> weights(count);
+
+    const auto turn = glm::angleAxis(glm::half_pi<float>(),
+                                     glm::vec3(0.f, 0.f, 1.f));
+    for (size_t f = 0; f < count; ++f) {
+        // Odd frames use the negated quaternion for the same rotation
+        b.set(f, f % 2 ? -turn : turn, glm::vec3(static_cast<float>(f)));
+        weights[f] = static_cast<float>(f) / (count - 1);
+    }
+
+    a.blend(b, weights.data());
+
+    const auto half = glm::angleAxis(glm::quarter_pi<float>(),
+                                     glm::vec3(0.f, 0.f, 1.f));
+    for (size_t f = 0; f < count; ++f) {
+        const auto w = weights[f];
+        auto translation = a.getTranslation(f);
+        BOOST_CHECK_CLOSE(translation.x + 1.f, w * f + 1.f, 0.001f);
+
+        auto rotation = a.getRotation(f);
+        BOOST_CHECK_CLOSE(glm::length(glm::vec4(rotation.x, rotation.y,
+                                                rotation.z, rotation.w)),
+                          1.f, 0.001f);
+        if (f == count - 1) {
+            BOOST_CHECK_CLOSE(std::abs(glm::dot(rotation, turn)), 1.f, 0.001f);
+        }
+        if (f == (count - 1) / 2) {
+            BOOST_CHECK_CLOSE(std::abs(glm::dot(rotation, half)), 1.f, 0.001f);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_animator_weights) {
+    auto root = std::make_shared<ModelFrame>(0);
+    root->setName("root");
+    auto bone = std::make_shared<ModelFrame>(1);
+    bone->setName("bone");
+    root->addChild(bone);
+    auto clump = std::make_shared<Clump>();
+    clump->setFrame(root);
+
+    auto makeAnimation = [](const glm::vec3& position) {
+        auto animation = std::make_shared<Animation>();
+        animation->duration = 1.f;
+        animation->bones.emplace(
+            "bone", std::make_unique<AnimationBone>(
+                        "bone", 0, 0, 1.f, AnimationBone::RT0,
+                        std::vector<AnimationKeyframe>{
+                            {glm::quat{1.0f, 0.0f, 0.0f, 0.0f}, position,
+                             glm::vec3(1.f), 0.f, 0}}));
+        return animation;
+    };
+
+    Animator animator(clump);
+    animator.playAnimation(0, makeAnimation(glm::vec3(2.f, 0.f, 0.f)), 1.f,
+                           true);
+    animator.playAnimation(1, makeAnimation(glm::vec3(0.f, 4.f, 0.f)), 1.f,
+                           true);
+
+    // Later slots replace earlier ones by default
+    animator.tick(0.f);
+    BOOST_CHECK(glm::vec3(bone->getWorldTransform()[3]) ==
+                glm::vec3(0.f, 4.f, 0.f));
+
+    animator.setAnimationWeight(1, 0.5f);
+    animator.tick(0.f);
+    BOOST_CHECK(glm::vec3(bone->getWorldTransform()[3]) ==
+                glm::vec3(1.f, 2.f, 0.f));
+    BOOST_CHECK(!bone->isDirty());
+
+    animator.setAnimationWeight(1, 0.f);
+    animator.tick(0.f);
+    BOOST_CHECK(glm::vec3(bone->getWorldTransform()[3]) ==
+                glm::vec3(2.f, 0.f, 0.f));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
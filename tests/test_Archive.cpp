@@ -1,5 +1,6 @@
 #include <boost/test/unit_test.hpp>
 #include <loaders/LoaderIMG.hpp>
+#include <cstring>
 #include "test_Globals.hpp"
 
 BOOST_AUTO_TEST_SUITE(ArchiveTests)
@@ -27,6 +28,30 @@ BOOST_AUTO_TEST_CASE(test_open_archive) {
     BOOST_CHECK_EQUAL(f2.name, f.name);
     BOOST_CHECK_EQUAL(f2.offset, f.offset);
     BOOST_CHECK_EQUAL(f2.size, f.size);
+
+    size_t index;
+    BOOST_REQUIRE(archive.findAssetIndex("RADAR00.TXD", index));
+    BOOST_CHECK_EQUAL(index, 0);
+    BOOST_CHECK(archive.loadToMemory(index) != nullptr);
+    BOOST_CHECK(!archive.findAssetIndex("radar00.txd.missing", index));
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_archive) {
+    LoaderIMG archive;
+
+    BOOST_REQUIRE(archive.load(Global::getGamePath() + "/models/gta3"));
+
+    auto copied = archive.loadAsset("radar00.txd");
+    BOOST_REQUIRE(copied.data != nullptr);
+
+    BOOST_REQUIRE(archive.mapArchive());
+    BOOST_CHECK(archive.isMapped());
+
+    auto view = archive.loadAsset("radar00.txd");
+    BOOST_REQUIRE(view.data != nullptr);
+    BOOST_CHECK_EQUAL(view.length, copied.length);
+    BOOST_CHECK(std::memcmp(view.data.get(), copied.data.get(),
+                            view.length) == 0);
 }
 #endif
 
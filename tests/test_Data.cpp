@@ -5,6 +5,8 @@
 #include <objects/InstanceObject.hpp>
 #include "test_Globals.hpp"
 
+#include <algorithm>
+
 // Tests against loading various data files
 // These tests are bad but so are the interfaces so it cancels out.
 
@@ -114,11 +116,20 @@ BOOST_AUTO_TEST_CASE(test_model_archive_loaded) {
     {
         auto info = d->findModelInfo<SimpleModelInfo>(2202);
         auto inst = e->createInstance(2202, {});
+        e->updateStreaming(true);
 
         BOOST_REQUIRE(info->type() == ModelDataType::SimpleInfo);
         BOOST_CHECK_NE(info->getAtomic(0), nullptr);
-
+        BOOST_CHECK(!inst->isWaitingForModel());
+        BOOST_CHECK(inst->getAtomic() != nullptr);
+
+        // Destroyed instances are no longer told about their model
+        auto& instances = e->instancesByModel[2202];
+        auto count = instances.size();
+        BOOST_CHECK(std::find(instances.begin(), instances.end(), inst) !=
+                    instances.end());
         e->destroyObject(inst);
+        BOOST_CHECK_EQUAL(instances.size(), count - 1);
     }
 }
 #endif
@@ -4,8 +4,76 @@
 #include <objects/InstanceObject.hpp>
 #include "test_Globals.hpp"
 
+namespace {
+class PoolTestObject : public GameObject {
+public:
+    explicit PoolTestObject(GameObjectID id = 0)
+        : GameObject(nullptr, glm::vec3(), glm::quat(), nullptr) {
+        setGameObjectID(id);
+    }
+
+    void tick(float) override {
+    }
+};
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(GameWorldTests)
 
+BOOST_AUTO_TEST_CASE(test_object_pool) {
+    GameWorld::ObjectPool pool;
+
+    auto object1 = new PoolTestObject;
+    auto object2 = new PoolTestObject;
+    auto object3 = new PoolTestObject;
+    pool.insert(std::unique_ptr<GameObject>(object1));
+    pool.insert(std::unique_ptr<GameObject>(object2));
+    pool.insert(std::unique_ptr<GameObject>(object3));
+    BOOST_CHECK_EQUAL(object1->getGameObjectID(), 1);
+    BOOST_CHECK_EQUAL(object2->getGameObjectID(), 2);
+    BOOST_CHECK_EQUAL(object3->getGameObjectID(), 3);
+    BOOST_CHECK_EQUAL(pool.objects.size(), 3);
+
+    pool.remove(object1);
+    BOOST_CHECK_EQUAL(pool.objects.size(), 2);
+    BOOST_CHECK(pool.find(1) == nullptr);
+    BOOST_CHECK(pool.find(2) == object2);
+    BOOST_CHECK(pool.find(3) == object3);
+
+    // The lowest free ID is reused
+    auto object4 = new PoolTestObject;
+    pool.insert(std::unique_ptr<GameObject>(object4));
+    BOOST_CHECK_EQUAL(object4->getGameObjectID(), 1);
+    BOOST_CHECK(pool.find(1) == object4);
+
+    pool.clear();
+    BOOST_CHECK(pool.objects.empty());
+    BOOST_CHECK(pool.find(2) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_object_pool_explicit_id) {
+    GameWorld::ObjectPool pool;
+
+    auto object1 = new PoolTestObject(5);
+    pool.insert(std::unique_ptr<GameObject>(object1));
+    BOOST_CHECK(pool.find(5) == object1);
+
+    // IDs skipped by an explicit ID are used first
+    auto object2 = new PoolTestObject(2);
+    pool.insert(std::unique_ptr<GameObject>(object2));
+    auto object3 = new PoolTestObject;
+    pool.insert(std::unique_ptr<GameObject>(object3));
+    BOOST_CHECK_EQUAL(object3->getGameObjectID(), 1);
+    auto object4 = new PoolTestObject;
+    pool.insert(std::unique_ptr<GameObject>(object4));
+    BOOST_CHECK_EQUAL(object4->getGameObjectID(), 3);
+
+    pool.remove(object2);
+    BOOST_CHECK(pool.find(2) == nullptr);
+    for (const auto& entry : pool.objects) {
+        BOOST_CHECK(pool.find(entry.first) == entry.second.get());
+    }
+}
+
 #if RW_TEST_WITH_DATA
 BOOST_AUTO_TEST_CASE(test_gameobject_id) {
     auto& gw = *Global::get().e;
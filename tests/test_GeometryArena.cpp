@@ -0,0 +1,37 @@
+#include <boost/test/unit_test.hpp>
+#include <gl/GeometryArena.hpp>
+
+BOOST_AUTO_TEST_SUITE(GeometryArenaTests)
+
+BOOST_AUTO_TEST_CASE(test_range_allocate) {
+    RangeAllocator ranges(100);
+    BOOST_CHECK_EQUAL(ranges.allocate(30), 0);
+    BOOST_CHECK_EQUAL(ranges.allocate(30), 30);
+    BOOST_CHECK_EQUAL(ranges.allocate(30), 60);
+    BOOST_CHECK_EQUAL(ranges.getFreeSize(), 10);
+    BOOST_CHECK_EQUAL(ranges.allocate(20), RangeAllocator::kNoSpace);
+    BOOST_CHECK_EQUAL(ranges.allocate(10), 90);
+    BOOST_CHECK_EQUAL(ranges.getFreeSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_range_reuse) {
+    RangeAllocator ranges(100);
+    auto a = ranges.allocate(20);
+    auto b = ranges.allocate(20);
+    auto c = ranges.allocate(20);
+    ranges.allocate(40);
+
+    // Freed ranges are reused, first fit
+    ranges.free(a, 20);
+    BOOST_CHECK_EQUAL(ranges.allocate(10), 0);
+    BOOST_CHECK_EQUAL(ranges.allocate(10), 10);
+
+    // Neighbouring free ranges are merged
+    ranges.free(c, 20);
+    ranges.free(b, 20);
+    BOOST_CHECK_EQUAL(ranges.getFreeSize(), 40);
+    BOOST_CHECK_EQUAL(ranges.allocate(40), 20);
+    BOOST_CHECK_EQUAL(ranges.allocate(1), RangeAllocator::kNoSpace);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
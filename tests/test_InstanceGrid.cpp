@@ -0,0 +1,105 @@
+#include <boost/test/unit_test.hpp>
+#include <data/ModelData.hpp>
+#include <engine/InstanceGrid.hpp>
+#include <objects/GameObject.hpp>
+
+#include <algorithm>
+
+namespace {
+class GridTestObject : public GameObject {
+public:
+    explicit GridTestObject(const glm::vec3& pos,
+                            BaseModelInfo* modelinfo = nullptr)
+        : GameObject(nullptr, pos, glm::quat(), modelinfo) {
+    }
+
+    using GameObject::changeModelInfo;
+
+    void tick(float) override {
+    }
+};
+
+bool contains(const InstanceGrid::Cell& cell, GameObject* object) {
+    return std::find(cell.objects.begin(), cell.objects.end(), object) !=
+           cell.objects.end();
+}
+
+size_t countObjects(const InstanceGrid& grid) {
+    size_t count = 0;
+    for (const auto& cell : grid.getCells()) {
+        count += cell.objects.size();
+    }
+    return count;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(InstanceGridTests)
+
+BOOST_AUTO_TEST_CASE(test_cell_bounds) {
+    InstanceGrid grid(100.f);
+    GridTestObject a(glm::vec3(10.f, 20.f, 0.f));
+    GridTestObject b(glm::vec3(60.f, 90.f, 15.f));
+    GridTestObject far(glm::vec3(-250.f, 20.f, 0.f));
+    grid.insert(&a);
+    grid.insert(&b);
+    grid.insert(&far);
+    BOOST_CHECK_EQUAL(grid.size(), 3);
+    BOOST_REQUIRE_EQUAL(grid.getCells().size(), 2);
+
+    const auto& cell = grid.getCells()[0];
+    BOOST_CHECK(contains(cell, &a));
+    BOOST_CHECK(contains(cell, &b));
+    BOOST_CHECK_EQUAL(cell.min.x, 10.f);
+    BOOST_CHECK_EQUAL(cell.max.y, 90.f);
+    BOOST_CHECK_EQUAL(cell.max.z, 15.f);
+    BOOST_CHECK_GT(cell.getBoundingRadius(), glm::length(cell.max - cell.min));
+    BOOST_CHECK(contains(grid.getCells()[1], &far));
+}
+
+BOOST_AUTO_TEST_CASE(test_update_and_remove) {
+    InstanceGrid grid(100.f);
+    GridTestObject object(glm::vec3(0.f));
+    grid.insert(&object);
+
+    object.setPosition(glm::vec3(500.f, -500.f, 0.f));
+    grid.update(&object);
+    BOOST_REQUIRE_EQUAL(grid.getCells().size(), 2);
+    BOOST_CHECK(grid.getCells()[0].objects.empty());
+    BOOST_CHECK(contains(grid.getCells()[1], &object));
+
+    // Inserting again only moves the object
+    grid.insert(&object);
+    BOOST_CHECK_EQUAL(countObjects(grid), 1);
+
+    grid.remove(&object);
+    BOOST_CHECK_EQUAL(grid.size(), 0);
+    BOOST_CHECK_EQUAL(countObjects(grid), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_refresh_model) {
+    SimpleModelInfo small;
+    small.setNumAtomics(1);
+    small.setLodDistance(0, 50.f);
+    SimpleModelInfo large;
+    large.setNumAtomics(1);
+    large.setLodDistance(0, 300.f);
+
+    InstanceGrid grid(100.f);
+    GridTestObject object(glm::vec3(0.f), &small);
+    grid.insert(&object);
+    BOOST_REQUIRE_EQUAL(grid.getCells().size(), 1);
+    BOOST_CHECK_EQUAL(grid.getCells()[0].drawDistance, 50.f);
+
+    // Swapping in a model drawn further away extends the cell
+    object.changeModelInfo(&large);
+    grid.refresh(&object);
+    BOOST_CHECK_EQUAL(grid.getCells()[0].drawDistance, 300.f);
+
+    // Objects that haven't been added are ignored
+    GridTestObject other(glm::vec3(500.f), &large);
+    grid.refresh(&other);
+    BOOST_CHECK_EQUAL(grid.getCells().size(), 1);
+    BOOST_CHECK_EQUAL(grid.size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,10 +1,138 @@
 #include <boost/test/unit_test.hpp>
 #include <data/Clump.hpp>
+#include <loaders/LoaderDFF.hpp>
 #include <platform/FileHandle.hpp>
 #include "test_Globals.hpp"
 
+#include <glm/gtc/packing.hpp>
+
+#include <cstring>
+
+namespace {
+template <class T>
+std::string raw(const T& value) {
+    return std::string(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+std::string chunk(uint32_t id, const std::string& body) {
+    return raw(id) + raw(static_cast<uint32_t>(body.size())) +
+           raw(uint32_t{0x1803FFFF}) + body;
+}
+
+/// A clump with two frames and a single triangle attached to the second
+FileContentsInfo makeTriangleClump() {
+    std::string frames = raw(uint32_t{2});
+    for (int32_t parent : {-1, 0}) {
+        frames += raw(glm::mat3{1.f}) + raw(glm::vec3{0.f, 0.f, 1.f}) +
+                  raw(parent) + raw(uint32_t{0});
+    }
+    std::string framelist = chunk(0x1, frames);
+    for (const std::string name : {"Root", "Wheel"}) {
+        framelist += chunk(0x3, chunk(0x0253F2FE, name));
+    }
+
+    std::string geometry = raw(uint16_t{0}) + raw(uint8_t{0}) +
+                           raw(uint8_t{0}) + raw(uint32_t{1}) +
+                           raw(uint32_t{3}) + raw(uint32_t{1});
+    geometry += raw(RW::BSGeometryTriangle{0, 1, 0, 2});
+    geometry += raw(RW::BSGeometryBounds{glm::vec3{}, -1.f, 1, 0});
+    geometry += raw(glm::vec3{0.f, 0.f, 0.f}) + raw(glm::vec3{1.f, 0.f, 0.f}) +
+                raw(glm::vec3{0.f, 1.f, 0.f});
+
+    std::string material = chunk(0x1, std::string(28, '\0'));
+    material += chunk(0x6, chunk(0x1, raw(uint32_t{0})) +
+                               chunk(0x2, std::string("Tex\0", 4)) +
+                               chunk(0x2, std::string(1, '\0')));
+    std::string materiallist =
+        chunk(0x1, raw(uint32_t{1})) + chunk(0x7, material);
+
+    std::string binmesh = raw(uint32_t{0}) + raw(uint32_t{1}) +
+                          raw(uint32_t{1}) + raw(uint32_t{3}) +
+                          raw(uint32_t{0}) + raw(uint32_t{0}) +
+                          raw(uint32_t{1}) + raw(uint32_t{2});
+
+    std::string geometrychunk = chunk(0x1, geometry) +
+                                chunk(0x8, materiallist) +
+                                chunk(0x3, chunk(0x50E, binmesh));
+    std::string geometrylist =
+        chunk(0x1, raw(uint32_t{1})) + chunk(0xF, geometrychunk);
+
+    std::string atomic =
+        chunk(0x1, raw(uint32_t{1}) + raw(uint32_t{0}) + raw(uint32_t{4}) +
+                       raw(uint32_t{0}));
+
+    std::string clump = chunk(
+        0x10, chunk(0x1, raw(uint32_t{1})) + chunk(0xE, framelist) +
+                  chunk(0x1A, geometrylist) + chunk(0x14, atomic));
+
+    auto data = std::make_unique<char[]>(clump.size());
+    std::memcpy(data.get(), clump.data(), clump.size());
+    return {std::move(data), clump.size()};
+}
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(LoaderDFFTests)
 
+BOOST_AUTO_TEST_CASE(test_parse_dff) {
+    auto file = makeTriangleClump();
+
+    // Parsing doesn't need a GL context
+    auto clump = LoaderDFF::parse(file);
+
+    BOOST_REQUIRE_EQUAL(clump.frames.size(), 2);
+    BOOST_CHECK_EQUAL(clump.frames[0].parent, -1);
+    BOOST_CHECK_EQUAL(clump.frames[1].parent, 0);
+    BOOST_CHECK_EQUAL(clump.frames[0].name, "root");
+    BOOST_CHECK_EQUAL(clump.frames[1].name, "wheel");
+
+    BOOST_REQUIRE_EQUAL(clump.geometries.size(), 1);
+    const auto& geometry = clump.geometries[0];
+    BOOST_CHECK_EQUAL(geometry.vertices.size(), 3);
+    BOOST_CHECK_EQUAL(geometry.bounds.radius, 1.f);
+    BOOST_CHECK_EQUAL(geometry.facetype, Geometry::Triangles);
+
+    BOOST_REQUIRE_EQUAL(geometry.subgeom.size(), 1);
+    BOOST_CHECK_EQUAL(geometry.subgeom[0].numIndices, 3);
+    BOOST_CHECK_EQUAL(geometry.subgeom[0].indices[2], 2);
+
+    BOOST_REQUIRE_EQUAL(geometry.materials.size(), 1);
+    BOOST_REQUIRE_EQUAL(geometry.materials[0].textures.size(), 1);
+    BOOST_CHECK_EQUAL(geometry.materials[0].textures[0].name, "tex");
+    BOOST_CHECK(!geometry.materials[0].textures[0].texture);
+
+    BOOST_REQUIRE_EQUAL(clump.atomics.size(), 1);
+    BOOST_CHECK_EQUAL(clump.atomics[0].frame, 1);
+    BOOST_CHECK_EQUAL(clump.atomics[0].geometry, 0);
+    BOOST_CHECK_EQUAL(clump.atomics[0].flags, 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_invalid_dff) {
+    auto data = std::make_unique<char[]>(12);
+    std::memset(data.get(), 0, 12);
+    FileContentsInfo file{std::move(data), 12};
+
+    BOOST_CHECK_THROW(LoaderDFF::parse(file), DFFLoaderException);
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_vertex) {
+    GeometryVertex vertex({1.f, 2.f, 3.f}, {0.f, -0.6f, 0.8f}, {0.25f, 3.5f},
+                          {10, 20, 30, 255});
+    CompactGeometryVertex compact(vertex);
+    BOOST_CHECK_EQUAL(sizeof(CompactGeometryVertex), 24);
+
+    BOOST_CHECK_EQUAL(compact.position.z, 3.f);
+    BOOST_CHECK_EQUAL(compact.colour.b, 30);
+
+    auto normal = glm::unpackSnorm3x10_1x2(compact.normal);
+    BOOST_CHECK_SMALL(normal.x, 0.01f);
+    BOOST_CHECK_CLOSE(normal.y, -0.6f, 0.5f);
+    BOOST_CHECK_CLOSE(normal.z, 0.8f, 0.5f);
+
+    auto texcoord = glm::unpackHalf2x16(compact.texcoord);
+    BOOST_CHECK_EQUAL(texcoord.x, 0.25f);
+    BOOST_CHECK_EQUAL(texcoord.y, 3.5f);
+}
+
 #if RW_TEST_WITH_DATA
 BOOST_AUTO_TEST_CASE(test_load_dff) {
     {
@@ -65,7 +193,75 @@ BOOST_AUTO_TEST_CASE(test_clump_clone) {
         BOOST_CHECK_EQUAL(newclump->getAtomics().size(), 1);
 
         BOOST_CHECK_EQUAL(frame1->getName(), newclump->getFrame()->getName());
+
+        const auto& newatomic = newclump->getAtomics()[0];
+        BOOST_CHECK_EQUAL(newatomic->getFrame(),
+                          newclump->getFrame()->getChildren()[0]);
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_clump_frame_order) {
+    auto root = std::make_shared<ModelFrame>(0);
+    root->setName("root");
+    auto a = std::make_shared<ModelFrame>(1);
+    a->setName("part");
+    auto b = std::make_shared<ModelFrame>(2);
+    b->setName("part");
+    auto c = std::make_shared<ModelFrame>(3);
+    c->setName("child");
+    root->addChild(a);
+    root->addChild(b);
+    a->addChild(c);
+
+    auto clump = std::make_shared<Clump>();
+    clump->setFrame(root);
+
+    const auto& frames = clump->getFrames();
+    BOOST_REQUIRE_EQUAL(frames.size(), 4);
+    BOOST_CHECK_EQUAL(frames[0], root);
+    BOOST_CHECK_EQUAL(frames[1], a);
+    BOOST_CHECK_EQUAL(frames[2], c);
+    BOOST_CHECK_EQUAL(frames[3], b);
+
+    // Depth first, like ModelFrame::findDescendant
+    BOOST_CHECK_EQUAL(clump->findFrame("root"), root.get());
+    BOOST_CHECK_EQUAL(clump->findFrame("part"), a.get());
+    BOOST_CHECK_EQUAL(clump->findFrame("part"), root->findDescendant("part"));
+    BOOST_CHECK_EQUAL(clump->findFrame("child"), c.get());
+    BOOST_CHECK(clump->findFrame("missing") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_world_transform) {
+    auto root = std::make_shared<ModelFrame>(0);
+    auto child = std::make_shared<ModelFrame>(1, glm::mat3{1.0f},
+                                              glm::vec3(1.f, 0.f, 0.f));
+    auto leaf = std::make_shared<ModelFrame>(2, glm::mat3{1.0f},
+                                             glm::vec3(0.f, 1.f, 0.f));
+    root->addChild(child);
+    child->addChild(leaf);
+
+    auto clump = std::make_shared<Clump>();
+    clump->setFrame(root);
+    clump->updateTransforms();
+    BOOST_CHECK(!leaf->isDirty());
+
+    // Roots are updated straight away, their descendants when next read
+    root->setTranslation(glm::vec3(0.f, 0.f, 2.f));
+    BOOST_CHECK(!root->isDirty());
+    BOOST_CHECK(child->isDirty());
+    BOOST_CHECK(leaf->isDirty());
+    BOOST_CHECK(glm::vec3(leaf->getWorldTransform()[3]) ==
+                glm::vec3(1.f, 1.f, 2.f));
+    BOOST_CHECK(!child->isDirty());
+
+    child->setTranslation(glm::vec3(3.f, 0.f, 0.f));
+    BOOST_CHECK(!root->isDirty());
+    BOOST_CHECK(leaf->isDirty());
+    clump->updateTransforms();
+    BOOST_CHECK(!child->isDirty());
+    BOOST_CHECK(!leaf->isDirty());
+    BOOST_CHECK(glm::vec3(leaf->getWorldTransform()[3]) ==
+                glm::vec3(3.f, 1.f, 2.f));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
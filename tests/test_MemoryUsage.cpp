@@ -0,0 +1,53 @@
+#include <boost/test/unit_test.hpp>
+#include <rw/memory.hpp>
+
+#include <utility>
+
+BOOST_AUTO_TEST_SUITE(MemoryUsageTests)
+
+BOOST_AUTO_TEST_CASE(test_tracked_lifetime) {
+    const auto base = MemoryUsage::get(MemoryTag::Audio);
+    {
+        TrackedMemory memory(MemoryTag::Audio, 100);
+        BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Audio), base + 100);
+
+        memory.resize(40);
+        BOOST_CHECK_EQUAL(memory.size(), 40);
+        BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Audio), base + 40);
+    }
+    BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Audio), base);
+}
+
+BOOST_AUTO_TEST_CASE(test_tracked_move) {
+    const auto base = MemoryUsage::get(MemoryTag::Animation);
+    {
+        TrackedMemory a(MemoryTag::Animation, 64);
+        TrackedMemory b(std::move(a));
+        BOOST_CHECK_EQUAL(a.size(), 0);
+        BOOST_CHECK_EQUAL(b.size(), 64);
+        BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Animation), base + 64);
+
+        TrackedMemory c(MemoryTag::Animation, 16);
+        c = std::move(b);
+        BOOST_CHECK_EQUAL(c.size(), 64);
+        BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Animation), base + 64);
+    }
+    BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Animation), base);
+}
+
+BOOST_AUTO_TEST_CASE(test_tags_are_separate) {
+    const auto textures = MemoryUsage::get(MemoryTag::Textures);
+    const auto total = MemoryUsage::total();
+    TrackedMemory memory(MemoryTag::Geometry, 32);
+    BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Textures), textures);
+    BOOST_CHECK_EQUAL(MemoryUsage::total(), total + 32);
+}
+
+BOOST_AUTO_TEST_CASE(test_set) {
+    const auto objects = MemoryUsage::get(MemoryTag::Objects);
+    MemoryUsage::set(MemoryTag::Objects, 12345);
+    BOOST_CHECK_EQUAL(MemoryUsage::get(MemoryTag::Objects), 12345);
+    MemoryUsage::set(MemoryTag::Objects, objects);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,10 @@
 #include <boost/test/unit_test.hpp>
+#include <gl/DrawBuffer.hpp>
 #include <render/GameRenderer.hpp>
+#include <render/RenderKey.hpp>
+
+#include <algorithm>
+#include <random>
 
 BOOST_AUTO_TEST_SUITE(RendererTests)
 
@@ -23,4 +28,124 @@ BOOST_AUTO_TEST_CASE(frustum_test_visible) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(frustum_test_batch) {
+    ViewFrustum f(0.1f, 100.f, glm::half_pi<float>(), 1.f);
+    f.update(f.projection());
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(-60.f, 60.f);
+    std::uniform_real_distribution<float> radius(0.f, 10.f);
+
+    for (size_t count : {0u, 1u, 7u, 63u, 64u}) {
+        ViewFrustum::SphereBatch batch;
+        for (size_t i = 0; i < count; ++i) {
+            batch.push({coordinate(random), coordinate(random),
+                        coordinate(random)},
+                       radius(random));
+        }
+
+        uint64_t expected = 0;
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 center(batch.x[i], batch.y[i], batch.z[i]);
+            if (f.intersects(center, batch.radius[i])) {
+                expected |= uint64_t(1) << i;
+            }
+        }
+        BOOST_CHECK_EQUAL(f.intersects(batch), expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_render_key_order) {
+    auto opaqueNear = makeRenderKey(BlendMode::BLEND_NONE, 0.1f, 5, 9);
+    auto opaqueFar = makeRenderKey(BlendMode::BLEND_NONE, 0.9f, 1, 1);
+    auto blendNear = makeRenderKey(BlendMode::BLEND_ALPHA, 0.1f, 1, 1);
+    auto blendFar = makeRenderKey(BlendMode::BLEND_ALPHA, 0.9f, 5, 9);
+
+    BOOST_CHECK_LT(opaqueNear, opaqueFar);
+    BOOST_CHECK_LT(opaqueFar, blendFar);
+    BOOST_CHECK_LT(blendFar, blendNear);
+
+    // Opaque draws at similar depths are grouped by state
+    BOOST_CHECK_LT(makeRenderKey(BlendMode::BLEND_NONE, 0.525f, 1, 2),
+                   makeRenderKey(BlendMode::BLEND_NONE, 0.52f, 2, 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_sort_render_list) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<RenderKey> keys(0, 64);
+
+    RenderList list;
+    for (int i = 0; i < 1000; ++i) {
+        // Spread the few distinct keys over all the digits
+        auto key = keys(random) * 0x0101010101010101ull;
+        list.emplace_back(key, glm::mat4(1.f), nullptr,
+                          Renderer::DrawParameters());
+    }
+
+    RenderOrder expected(list.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        expected[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [&](uint32_t a, uint32_t b) {
+                         return list[a].sortKey < list[b].sortKey;
+                     });
+
+    RenderOrder order;
+    sortRenderList(list, order);
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(),
+                                  expected.end());
+
+    sortRenderList(RenderList(), order);
+    BOOST_CHECK(order.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_instance_runs) {
+    DrawBuffer tree;
+    DrawBuffer lamp;
+
+    Renderer::DrawParameters dp;
+    dp.count = 36;
+    Renderer::DrawParameters blended = dp;
+    blended.blendMode = BlendMode::BLEND_ALPHA;
+
+    RenderList list;
+    list.emplace_back(0, glm::mat4(1.f), &tree, dp);
+    list.emplace_back(0, glm::mat4(2.f), &tree, dp);
+    list.emplace_back(0, glm::mat4(1.f), &tree, blended);
+    list.emplace_back(0, glm::mat4(1.f), &lamp, dp);
+    list.emplace_back(0, glm::mat4(3.f), &lamp, dp);
+    RenderOrder order{0, 1, 2, 3, 4};
+
+    // Only the object data may differ within a run
+    BOOST_CHECK(canInstance(list[0], list[1]));
+    BOOST_CHECK(!canInstance(list[1], list[2]));
+    BOOST_CHECK(!canInstance(list[2], list[3]));
+    BOOST_CHECK_EQUAL(countInstanceRun(list, order, 0), 2u);
+    BOOST_CHECK_EQUAL(countInstanceRun(list, order, 2), 1u);
+    BOOST_CHECK_EQUAL(countInstanceRun(list, order, 3), 2u);
+    BOOST_CHECK_EQUAL(countInstanceRun(list, order, 4), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_instance_run_limit) {
+    DrawBuffer tree;
+    RenderList list(Renderer::kMaxInstances * 2 + 3,
+                    {0, glm::mat4(1.f), &tree, Renderer::DrawParameters()});
+    RenderOrder order(list.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    // Runs are split so the object data fits in one uniform block
+    std::vector<size_t> runs;
+    for (size_t i = 0; i < order.size();) {
+        runs.push_back(countInstanceRun(list, order, i));
+        i += runs.back();
+    }
+    std::vector<size_t> expected{Renderer::kMaxInstances,
+                                 Renderer::kMaxInstances, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(runs.begin(), runs.end(), expected.begin(),
+                                  expected.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+#include <data/ModelData.hpp>
+#include <engine/ResidencyManager.hpp>
+
+#include <algorithm>
+
+namespace {
+void loadModel(SimpleModelInfo& info) {
+    info.setAtomic(std::make_shared<Clump>(), 0, nullptr);
+}
+
+void advance(ResidencyManager& residency, uint32_t frames) {
+    for (uint32_t i = 0; i < frames; ++i) {
+        residency.nextFrame();
+    }
+}
+
+bool contains(const std::vector<BaseModelInfo*>& models, BaseModelInfo* info) {
+    return std::find(models.begin(), models.end(), info) != models.end();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(ResidencyManagerTests)
+
+BOOST_AUTO_TEST_CASE(test_under_budget) {
+    ResidencyManager residency;
+    residency.setBudget({1000, 0});
+    SimpleModelInfo a;
+    loadModel(a);
+    residency.addModel(&a, "a", 600);
+    BOOST_CHECK_EQUAL(residency.getModelBytes(), 600);
+
+    advance(residency, ResidencyManager::kMinIdleFrames);
+    auto evictions = residency.evict();
+    BOOST_CHECK(evictions.models.empty());
+    BOOST_CHECK_EQUAL(residency.getModelCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_evict_least_recently_used) {
+    ResidencyManager residency;
+    residency.setBudget({1000, 0});
+    SimpleModelInfo a, b, c;
+    for (auto info : {&a, &b, &c}) {
+        loadModel(*info);
+    }
+    residency.addModel(&a, "a", 400);
+    residency.addModel(&b, "b", 400);
+    residency.addModel(&c, "c", 400);
+
+    // b was drawn most recently, then a
+    advance(residency, 10);
+    a.markUsed(residency.getFrame());
+    advance(residency, 10);
+    b.markUsed(residency.getFrame());
+    advance(residency, ResidencyManager::kMinIdleFrames);
+
+    auto evictions = residency.evict();
+    BOOST_REQUIRE_EQUAL(evictions.models.size(), 1);
+    BOOST_CHECK_EQUAL(evictions.models[0], &c);
+    BOOST_CHECK_EQUAL(residency.getModelBytes(), 800);
+}
+
+BOOST_AUTO_TEST_CASE(test_recently_used_kept) {
+    ResidencyManager residency;
+    residency.setBudget({100, 0});
+    SimpleModelInfo a;
+    loadModel(a);
+    residency.addModel(&a, "a", 400);
+
+    // Newly loaded models count as used
+    BOOST_CHECK(residency.evict().models.empty());
+
+    advance(residency, ResidencyManager::kMinIdleFrames);
+    auto evictions = residency.evict();
+    BOOST_CHECK(contains(evictions.models, &a));
+}
+
+BOOST_AUTO_TEST_CASE(test_referenced_clump_kept) {
+    ResidencyManager residency;
+    residency.setBudget({100, 0});
+    ClumpModelInfo vehicle;
+    vehicle.setModel(std::make_shared<Clump>());
+    vehicle.addReference();
+    residency.addModel(&vehicle, "vehicle", 400);
+
+    advance(residency, ResidencyManager::kMinIdleFrames);
+    BOOST_CHECK(residency.evict().models.empty());
+
+    vehicle.removeReference();
+    advance(residency, ResidencyManager::kEvictionInterval);
+    BOOST_CHECK(contains(residency.evict().models, &vehicle));
+}
+
+BOOST_AUTO_TEST_CASE(test_texture_slot_freed) {
+    ResidencyManager residency;
+    residency.setBudget({0, 1000});
+    SimpleModelInfo a, b, c;
+    for (auto info : {&a, &b, &c}) {
+        loadModel(*info);
+    }
+    residency.addTextureSlot("shared", 800);
+    residency.addTextureSlot("single", 800);
+    residency.addModel(&a, "shared", 10);
+    residency.addModel(&b, "shared", 10);
+    residency.addModel(&c, "single", 10);
+    advance(residency, 5);
+    a.markUsed(residency.getFrame());
+    b.markUsed(residency.getFrame());
+    advance(residency, ResidencyManager::kMinIdleFrames);
+
+    // Only evicting c frees a slot, even though a and b are older
+    auto evictions = residency.evict();
+    BOOST_REQUIRE_EQUAL(evictions.models.size(), 1);
+    BOOST_CHECK_EQUAL(evictions.models[0], &c);
+    BOOST_REQUIRE_EQUAL(evictions.textureSlots.size(), 1);
+    BOOST_CHECK_EQUAL(evictions.textureSlots[0], "single");
+    BOOST_CHECK_EQUAL(residency.getTextureBytes(), 800);
+}
+
+BOOST_AUTO_TEST_CASE(test_unloaded_model_dropped) {
+    ResidencyManager residency;
+    residency.setBudget({100, 0});
+    SimpleModelInfo a;
+    loadModel(a);
+    residency.addModel(&a, "a", 400);
+    a.unload();
+    BOOST_CHECK(a.getAtomic(0) == nullptr);
+
+    auto evictions = residency.evict();
+    BOOST_CHECK(evictions.models.empty());
+    BOOST_CHECK_EQUAL(residency.getModelCount(), 0);
+    BOOST_CHECK_EQUAL(residency.getModelBytes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+#include <boost/test/unit_test.hpp>
+#include <engine/SpatialHash.hpp>
+#include <objects/GameObject.hpp>
+
+#include <algorithm>
+
+namespace {
+class SpatialTestObject : public GameObject {
+public:
+    explicit SpatialTestObject(const glm::vec3& pos)
+        : GameObject(nullptr, pos, glm::quat(), nullptr) {
+    }
+
+    void tick(float) override {
+    }
+};
+
+bool contains(const std::vector<GameObject*>& objects, GameObject* object) {
+    return std::find(objects.begin(), objects.end(), object) != objects.end();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(SpatialHashTests)
+
+BOOST_AUTO_TEST_CASE(test_radius_query) {
+    SpatialHash index(10.f);
+    SpatialTestObject near(glm::vec3(1.f, 1.f, 0.f));
+    SpatialTestObject neighbour(glm::vec3(-4.f, 2.f, 0.f));
+    SpatialTestObject far(glm::vec3(50.f, 0.f, 0.f));
+    SpatialTestObject above(glm::vec3(0.f, 0.f, 30.f));
+    index.insert(&near);
+    index.insert(&neighbour);
+    index.insert(&far);
+    index.insert(&above);
+    BOOST_CHECK_EQUAL(index.size(), 4);
+
+    std::vector<GameObject*> result;
+    index.queryRadius(glm::vec3(0.f), 5.f, result);
+    BOOST_CHECK_EQUAL(result.size(), 2);
+    BOOST_CHECK(contains(result, &near));
+    BOOST_CHECK(contains(result, &neighbour));
+}
+
+BOOST_AUTO_TEST_CASE(test_update_and_remove) {
+    SpatialHash index(10.f);
+    SpatialTestObject object(glm::vec3(0.f));
+    index.insert(&object);
+
+    object.setPosition(glm::vec3(100.f, -100.f, 0.f));
+    index.update(&object);
+
+    std::vector<GameObject*> result;
+    index.queryRadius(glm::vec3(0.f), 5.f, result);
+    BOOST_CHECK(result.empty());
+    index.queryRadius(glm::vec3(100.f, -100.f, 0.f), 5.f, result);
+    BOOST_CHECK_EQUAL(result.size(), 1);
+
+    index.remove(&object);
+    BOOST_CHECK_EQUAL(index.size(), 0);
+    result.clear();
+    index.queryRadius(glm::vec3(100.f, -100.f, 0.f), 5.f, result);
+    BOOST_CHECK(result.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_box_and_cone_queries) {
+    SpatialHash index(10.f);
+    SpatialTestObject ahead(glm::vec3(0.f, 20.f, 0.f));
+    SpatialTestObject behind(glm::vec3(0.f, -20.f, 0.f));
+    SpatialTestObject side(glm::vec3(20.f, 1.f, 0.f));
+    index.insert(&ahead);
+    index.insert(&behind);
+    index.insert(&side);
+
+    std::vector<GameObject*> result;
+    index.queryBox(glm::vec3(-5.f, 0.f, -5.f), glm::vec3(25.f, 25.f, 5.f),
+                   result);
+    BOOST_CHECK_EQUAL(result.size(), 2);
+    BOOST_CHECK(contains(result, &ahead));
+    BOOST_CHECK(contains(result, &side));
+
+    result.clear();
+    index.queryCone(glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f), 30.f, 0.5f,
+                    result);
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK(contains(result, &ahead));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
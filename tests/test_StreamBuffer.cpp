@@ -0,0 +1,77 @@
+#include <boost/test/unit_test.hpp>
+#include <render/StreamBuffer.hpp>
+#include "test_Globals.hpp"
+
+#include <array>
+#include <cstdint>
+
+BOOST_AUTO_TEST_SUITE(StreamBufferTests)
+
+BOOST_AUTO_TEST_CASE(test_aligned_offsets) {
+    Global::get();
+    StreamBuffer buffer(1024);
+
+    std::array<uint8_t, 100> data{};
+    for (GLsizeiptr alignment : {1, 16, 64, 256}) {
+        auto offset = buffer.upload(data.data(), 10, alignment);
+        BOOST_CHECK_EQUAL(offset % alignment, 0);
+        offset = buffer.upload(data.data(), 100, alignment);
+        BOOST_CHECK_EQUAL(offset % alignment, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_wraparound) {
+    Global::get();
+    constexpr GLsizeiptr kRegionSize = 1024;
+    constexpr GLsizeiptr kBufferSize =
+        kRegionSize * StreamBuffer::kRegionCount;
+    StreamBuffer buffer(kRegionSize);
+
+    std::array<uint8_t, 600> data{};
+    for (unsigned int frame = 0; frame < StreamBuffer::kRegionCount * 3;
+         ++frame) {
+        // Each frame starts at the beginning of the next region, once the
+        // GPU is done with what was last written there
+        const auto region = frame % StreamBuffer::kRegionCount;
+        auto offset = buffer.upload(data.data(), 100, 16);
+        BOOST_CHECK_EQUAL(offset, region * kRegionSize);
+        offset = buffer.upload(data.data(), 100, 16);
+        BOOST_CHECK_EQUAL(offset, region * kRegionSize + 112);
+        buffer.nextFrame();
+    }
+
+    // Allocations that don't fit move on to the next region, never past the
+    // end of the buffer
+    GLintptr last = -1;
+    for (int i = 0; i < 10; ++i) {
+        auto offset = buffer.upload(data.data(), data.size(), 256);
+        BOOST_CHECK_EQUAL(offset % kRegionSize, 0);
+        BOOST_CHECK_NE(offset, last);
+        BOOST_CHECK_LE(offset + static_cast<GLintptr>(data.size()),
+                       kBufferSize);
+        last = offset;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_upload_contents) {
+    Global::get();
+    StreamBuffer buffer(256);
+
+    std::array<uint8_t, 200> data;
+    std::array<uint8_t, 200> contents;
+    for (uint8_t frame = 0; frame < 5; ++frame) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>(frame * 31 + i);
+        }
+        auto offset = buffer.upload(data.data(), data.size(), 4);
+
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer.getName());
+        glGetBufferSubData(GL_COPY_READ_BUFFER, offset, data.size(),
+                           contents.data());
+        BOOST_CHECK_EQUAL_COLLECTIONS(contents.begin(), contents.end(),
+                                      data.begin(), data.end());
+        buffer.nextFrame();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
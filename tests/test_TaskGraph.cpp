@@ -0,0 +1,66 @@
+#include <boost/test/unit_test.hpp>
+#include <core/TaskGraph.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(TaskGraphTests)
+
+BOOST_AUTO_TEST_CASE(test_dependency_order) {
+    for (unsigned int workers : {0u, 4u}) {
+        TaskGraph tasks;
+        std::vector<int> order;
+        std::atomic<int> independent{0};
+
+        auto first = tasks.add([&]() { order.push_back(0); });
+        for (int i = 0; i < 8; ++i) {
+            tasks.add([&]() { independent++; }, {first});
+        }
+        auto second = tasks.add([&]() { order.push_back(1); }, {first},
+                                TaskGraph::Affinity::MainThread);
+        tasks.add([&]() { order.push_back(2); }, {first, second});
+
+        tasks.run(workers);
+
+        BOOST_CHECK_EQUAL(independent, 8);
+        BOOST_REQUIRE_EQUAL(order.size(), 3);
+        BOOST_CHECK_EQUAL(order[0], 0);
+        BOOST_CHECK_EQUAL(order[1], 1);
+        BOOST_CHECK_EQUAL(order[2], 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_main_thread_affinity) {
+    TaskGraph tasks;
+    auto caller = std::this_thread::get_id();
+    std::atomic<int> onMain{0};
+
+    for (int i = 0; i < 16; ++i) {
+        tasks.add(
+            [&]() {
+                if (std::this_thread::get_id() == caller) {
+                    onMain++;
+                }
+            },
+            {}, TaskGraph::Affinity::MainThread);
+    }
+
+    tasks.run(2);
+
+    BOOST_CHECK_EQUAL(onMain, 16);
+}
+
+BOOST_AUTO_TEST_CASE(test_exception_stops_graph) {
+    TaskGraph tasks;
+    bool ran = false;
+
+    auto fail = tasks.add([]() { throw std::runtime_error("failed"); });
+    tasks.add([&]() { ran = true; }, {fail});
+
+    BOOST_CHECK_THROW(tasks.run(2), std::runtime_error);
+    BOOST_CHECK(!ran);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+#include <boost/test/unit_test.hpp>
+#include <loaders/TextTokenizer.hpp>
+
+namespace {
+constexpr auto kTestText =
+    "inst\r\n"
+    "101, ModelA, -10.5, 12.0, 5e2\r\n"
+    "  weapon\tMELEE  1.5,,7f  \n"
+    "\n"
+    "end";
+}
+
+BOOST_AUTO_TEST_SUITE(TextTokenizerTests)
+
+BOOST_AUTO_TEST_CASE(test_lines) {
+    std::string text = kTestText;
+    TextTokenizer tokenizer(text);
+
+    BOOST_REQUIRE(tokenizer.nextLine());
+    BOOST_CHECK(tokenizer.line() == "inst");
+    BOOST_REQUIRE(tokenizer.nextLine());
+    BOOST_REQUIRE(tokenizer.nextLine());
+    BOOST_REQUIRE(tokenizer.nextLine());
+    BOOST_CHECK(tokenizer.line().empty());
+    BOOST_CHECK(!tokenizer.hasField());
+    BOOST_REQUIRE(tokenizer.nextLine());
+    BOOST_CHECK(tokenizer.line() == "end");
+    BOOST_CHECK(!tokenizer.nextLine());
+}
+
+BOOST_AUTO_TEST_CASE(test_fields) {
+    std::string text = kTestText;
+    TextTokenizer tokenizer(text);
+    tokenizer.nextLine();
+
+    BOOST_REQUIRE(tokenizer.nextLine());
+    BOOST_CHECK_EQUAL(tokenizer.nextInt(), 101);
+    BOOST_CHECK_EQUAL(tokenizer.nextString(), "ModelA");
+    BOOST_CHECK_EQUAL(tokenizer.nextFloat(), -10.5f);
+    BOOST_CHECK_EQUAL(tokenizer.nextFloat(), 12.f);
+    BOOST_CHECK_EQUAL(tokenizer.nextFloat(), 500.f);
+    BOOST_CHECK(!tokenizer.hasField());
+    BOOST_CHECK(!tokenizer.hasError());
+
+    BOOST_REQUIRE(tokenizer.nextLine());
+    BOOST_CHECK_EQUAL(tokenizer.nextString(), "weapon");
+    BOOST_CHECK(tokenizer.nextField() == "MELEE");
+    BOOST_CHECK_EQUAL(tokenizer.nextFloat(), 1.5f);
+    // Empty fields between commas are kept
+    BOOST_CHECK(tokenizer.nextField().empty());
+    BOOST_CHECK_EQUAL(tokenizer.nextInt(16), 0x7f);
+    BOOST_CHECK(!tokenizer.hasError());
+
+    // Reading past the end gives empty fields
+    BOOST_CHECK_EQUAL(tokenizer.nextInt(), 0);
+    BOOST_CHECK(tokenizer.hasError());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_numbers) {
+    long long i = 0;
+    BOOST_CHECK(TextTokenizer::parseInt({"-42", 3}, i));
+    BOOST_CHECK_EQUAL(i, -42);
+    BOOST_CHECK(TextTokenizer::parseInt({"0x1F", 4}, i, 16));
+    BOOST_CHECK_EQUAL(i, 0x1f);
+    // Trailing characters are ignored, like strtol
+    BOOST_CHECK(TextTokenizer::parseInt({"0\"", 2}, i));
+    BOOST_CHECK_EQUAL(i, 0);
+    BOOST_CHECK(!TextTokenizer::parseInt({"abc", 3}, i));
+
+    float f = 0.f;
+    BOOST_CHECK(TextTokenizer::parseFloat({"0.8", 3}, f));
+    BOOST_CHECK_EQUAL(f, 0.8f);
+    BOOST_CHECK(TextTokenizer::parseFloat({"-.25", 4}, f));
+    BOOST_CHECK_EQUAL(f, -0.25f);
+    BOOST_CHECK(TextTokenizer::parseFloat({"1.5E-3", 6}, f));
+    BOOST_CHECK_EQUAL(f, 1.5e-3f);
+    BOOST_CHECK(TextTokenizer::parseFloat({"3.14159265358979323846", 22}, f));
+    BOOST_CHECK_EQUAL(f, 3.14159265358979323846f);
+    BOOST_CHECK(!TextTokenizer::parseFloat({"x", 1}, f));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+#include <boost/test/unit_test.hpp>
+#include <loaders/TextureDecoder.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(TextureDecoderTests)
+
+BOOST_AUTO_TEST_CASE(test_block_size) {
+    BOOST_CHECK_EQUAL(blockDataSize(BlockFormat::DXT1, 4, 4), 8);
+    BOOST_CHECK_EQUAL(blockDataSize(BlockFormat::DXT3, 4, 4), 16);
+    BOOST_CHECK_EQUAL(blockDataSize(BlockFormat::DXT1, 64, 32), 1024);
+    // Partial blocks are stored whole
+    BOOST_CHECK_EQUAL(blockDataSize(BlockFormat::DXT1, 1, 1), 8);
+    BOOST_CHECK_EQUAL(blockDataSize(BlockFormat::DXT3, 6, 2), 32);
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_dxt1) {
+    // Pure red and blue endpoints, each row uses one of the four colours
+    const uint8_t block[] = {0x00, 0xF8, 0x1F, 0x00,
+                             0x00, 0x55, 0xAA, 0xFF};
+    std::vector<uint8_t> rgba(4 * 4 * 4);
+    decodeBlocks(BlockFormat::DXT1, block, 4, 4, rgba.data());
+
+    auto pixel = [&](size_t x, size_t y) { return &rgba[(y * 4 + x) * 4]; };
+    BOOST_CHECK_EQUAL(pixel(0, 0)[0], 255);
+    BOOST_CHECK_EQUAL(pixel(0, 0)[2], 0);
+    BOOST_CHECK_EQUAL(pixel(3, 1)[0], 0);
+    BOOST_CHECK_EQUAL(pixel(3, 1)[2], 255);
+    BOOST_CHECK_EQUAL(pixel(1, 2)[0], 170);
+    BOOST_CHECK_EQUAL(pixel(1, 2)[2], 85);
+    BOOST_CHECK_EQUAL(pixel(2, 3)[0], 85);
+    BOOST_CHECK_EQUAL(pixel(2, 3)[2], 170);
+    BOOST_CHECK_EQUAL(pixel(2, 3)[3], 255);
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_dxt1_transparent) {
+    // With the first colour not above the second, index 3 is transparent
+    const uint8_t block[] = {0x1F, 0x00, 0x00, 0xF8,
+                             0xFF, 0xFF, 0xFF, 0xFF};
+    std::vector<uint8_t> rgba(2 * 2 * 4, 1);
+    decodeBlocks(BlockFormat::DXT1, block, 2, 2, rgba.data());
+    for (size_t i = 0; i < rgba.size(); ++i) {
+        BOOST_CHECK_EQUAL(rgba[i], 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_dxt3) {
+    // Alpha increasing by one step per pixel, every pixel the first colour
+    const uint8_t block[] = {0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE,
+                             0xE0, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    std::vector<uint8_t> rgba(4 * 4 * 4);
+    decodeBlocks(BlockFormat::DXT3, block, 4, 4, rgba.data());
+    for (size_t i = 0; i < 16; ++i) {
+        BOOST_CHECK_EQUAL(rgba[i * 4 + 0], 0);
+        BOOST_CHECK_EQUAL(rgba[i * 4 + 1], 255);
+        BOOST_CHECK_EQUAL(rgba[i * 4 + 3], i * 17);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_expand_palette) {
+    std::vector<uint32_t> palette(256);
+    for (size_t i = 0; i < palette.size(); ++i) {
+        palette[i] = 0xFF000000u | static_cast<uint32_t>(i * 3);
+    }
+    // Long enough to cover the vector loop and its tail
+    std::vector<uint8_t> indices(37);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = static_cast<uint8_t>(255 - i * 7);
+    }
+
+    std::vector<uint32_t> rgba(indices.size());
+    expandPalette(palette.data(), palette.size(), indices.data(),
+                  indices.size(), rgba.data());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        BOOST_CHECK_EQUAL(rgba[i], palette[indices[i]]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_expand_palette_pal4) {
+    std::vector<uint32_t> palette(16);
+    for (size_t i = 0; i < palette.size(); ++i) {
+        palette[i] = 0xFF000000u | static_cast<uint32_t>(i * 3);
+    }
+    // Indices past the end of the palette only keep their low bits
+    std::vector<uint8_t> indices(37);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = static_cast<uint8_t>(255 - i * 7);
+    }
+
+    std::vector<uint32_t> rgba(indices.size());
+    expandPalette(palette.data(), palette.size(), indices.data(),
+                  indices.size(), rgba.data());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        BOOST_CHECK_EQUAL(rgba[i], palette[indices[i] & 0x0F]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_mip_level_count) {
+    BOOST_CHECK_EQUAL(mipLevelCount(1, 1), 1);
+    BOOST_CHECK_EQUAL(mipLevelCount(256, 256), 9);
+    BOOST_CHECK_EQUAL(mipLevelCount(64, 16), 7);
+    BOOST_CHECK_EQUAL(mipLevelCount(5, 3), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_downsample) {
+    // Each 2x2 block is averaged, rounding to nearest
+    const uint8_t pixels[] = {
+        0,   0,   0,   0,   4,   8,   12,  16,  100, 100, 100, 100, 255, 255, 255, 255,
+        2,   4,   6,   8,   6,   12,  18,  24,  100, 100, 100, 100, 255, 255, 255, 254,
+    };
+    uint8_t out[8];
+    downsample(pixels, 4, 2, out);
+    const uint8_t expected[] = {3, 6, 9, 12, 178, 178, 178, 177};
+    BOOST_CHECK_EQUAL_COLLECTIONS(out, out + 8, expected, expected + 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_downsample_odd) {
+    // A 5x1 image keeps its single row, the last column is dropped
+    std::vector<uint8_t> pixels(5 * 4);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<uint8_t>(i * 10);
+    }
+    uint8_t out[8];
+    downsample(pixels.data(), 5, 1, out);
+    for (size_t c = 0; c < 4; ++c) {
+        BOOST_CHECK_EQUAL(out[c], (pixels[c] + pixels[4 + c] + 1) / 2);
+        BOOST_CHECK_EQUAL(out[4 + c], (pixels[8 + c] + pixels[12 + c] + 1) / 2);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,30 @@
+#include <boost/test/unit_test.hpp>
+#include <core/WorkerPool.hpp>
+
+#include <atomic>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(WorkerPoolTests)
+
+BOOST_AUTO_TEST_CASE(test_runs_every_index) {
+    for (unsigned int workers : {0u, 3u}) {
+        WorkerPool pool(workers);
+        BOOST_CHECK_EQUAL(pool.getThreadCount(), workers + 1);
+
+        // Run several times to check that the workers pick up each run
+        for (size_t count : {0u, 1u, 100u, 1000u}) {
+            std::vector<std::atomic<int>> calls(count);
+            for (auto& c : calls) {
+                c = 0;
+            }
+
+            pool.run(count, [&](size_t index) { calls[index]++; });
+
+            for (auto& c : calls) {
+                BOOST_CHECK_EQUAL(c, 1);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+#include <boost/test/unit_test.hpp>
+#include <data/InstanceData.hpp>
+#include <loaders/WorldCache.hpp>
+#include <rw/filesystem.hpp>
+
+#include <fstream>
+
+namespace {
+struct CacheFiles {
+    rwfs::path source =
+        rwfs::temp_directory_path() / "openrw_test_worldcache.ide";
+    rwfs::path cache =
+        rwfs::temp_directory_path() / "openrw_test_worldcache.bin";
+
+    CacheFiles() {
+        std::ofstream(source.string()) << "objs\nend\n";
+    }
+
+    ~CacheFiles() {
+        rwfs::error_code ec;
+        rwfs::remove(source, ec);
+        rwfs::remove(cache, ec);
+    }
+};
+
+void writeTestCache(const CacheFiles& files) {
+    ModelInfoTable models;
+
+    auto simple = std::make_unique<SimpleModelInfo>();
+    simple->setModelID(100);
+    simple->name = "building";
+    simple->textureslot = "buildingtxd";
+    simple->setNumAtomics(2);
+    simple->setLodDistance(0, 100.f);
+    simple->setLodDistance(1, 200.f);
+    simple->flags = SimpleModelInfo::DRAW_LAST;
+    simple->paths.push_back(
+        {PathData::PATH_PED, 100, "building", {{PathNode::EXTERNAL, -1,
+                                                 glm::vec3(1.f, 2.f, 3.f),
+                                                 1.f, 0, 0}}});
+    auto col = std::make_unique<CollisionModel>();
+    col->name = "building";
+    col->vertices = {glm::vec3(1.f), glm::vec3(2.f), glm::vec3(3.f)};
+    col->faces.push_back({{0, 1, 2}, {1, 0, 0, 0}});
+    simple->setCollisionModel(col);
+    models.emplace(100, std::move(simple));
+
+    auto ped = std::make_unique<PedModelInfo>();
+    ped->setModelID(5);
+    ped->name = "cop";
+    ped->pedtype_ = PedModelInfo::COP;
+    ped->animgroup_ = "man";
+    models.emplace(5, std::move(ped));
+
+    std::map<std::string, LoaderIPL> ipls;
+    auto& ipl = ipls["data/maps/test.ipl"];
+    ipl.m_instances.push_back(std::make_shared<InstanceData>(
+        100, "building", glm::vec3(10.f, 20.f, 30.f), glm::vec3(1.f),
+        glm::quat(1.f, 0.f, 0.f, 0.f)));
+    ipl.zones.emplace_back("ZONE", 0, glm::vec3(-10.f), glm::vec3(10.f), 1, 2,
+                           3);
+
+    WorldCache cache;
+    cache.addSource(files.source.string());
+    BOOST_REQUIRE(cache.write(files.cache.string(), models, ipls));
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(WorldCacheTests)
+
+BOOST_AUTO_TEST_CASE(test_round_trip) {
+    CacheFiles files;
+    writeTestCache(files);
+
+    WorldCache cache;
+    ModelInfoTable models;
+    std::map<std::string, LoaderIPL> ipls;
+    BOOST_REQUIRE(cache.read(files.cache.string(), models, ipls));
+    BOOST_CHECK_EQUAL(cache.getSourceCount(), 1);
+
+    BOOST_REQUIRE_EQUAL(models.size(), 2);
+    BOOST_REQUIRE(models[100]->type() == ModelDataType::SimpleInfo);
+    auto simple = static_cast<SimpleModelInfo*>(models[100].get());
+    BOOST_CHECK_EQUAL(simple->name, "building");
+    BOOST_CHECK_EQUAL(simple->textureslot, "buildingtxd");
+    BOOST_CHECK_EQUAL(simple->getNumAtomics(), 2);
+    BOOST_CHECK_EQUAL(simple->getLargestLodDistance(), 200.f);
+    BOOST_CHECK_EQUAL(simple->flags, SimpleModelInfo::DRAW_LAST);
+    BOOST_REQUIRE_EQUAL(simple->paths.size(), 1);
+    BOOST_REQUIRE_EQUAL(simple->paths[0].nodes.size(), 1);
+    BOOST_CHECK_EQUAL(simple->paths[0].nodes[0].position.z, 3.f);
+    BOOST_REQUIRE(simple->getCollision());
+    BOOST_CHECK_EQUAL(simple->getCollision()->vertices.size(), 3);
+    BOOST_CHECK_EQUAL(simple->getCollision()->faces[0].tri[2], 2);
+
+    BOOST_REQUIRE(models[5]->type() == ModelDataType::PedInfo);
+    auto ped = static_cast<PedModelInfo*>(models[5].get());
+    BOOST_CHECK_EQUAL(ped->pedtype_, PedModelInfo::COP);
+    BOOST_CHECK_EQUAL(ped->animgroup_, "man");
+    BOOST_CHECK(!ped->getCollision());
+
+    BOOST_REQUIRE_EQUAL(ipls.size(), 1);
+    const auto& ipl = ipls["data/maps/test.ipl"];
+    BOOST_REQUIRE_EQUAL(ipl.m_instances.size(), 1);
+    BOOST_CHECK_EQUAL(ipl.m_instances[0]->id, 100);
+    BOOST_CHECK_EQUAL(ipl.m_instances[0]->model, "building");
+    BOOST_CHECK_EQUAL(ipl.m_instances[0]->pos.y, 20.f);
+    BOOST_REQUIRE_EQUAL(ipl.zones.size(), 1);
+    BOOST_CHECK_EQUAL(ipl.zones[0].name, "ZONE");
+    BOOST_CHECK_EQUAL(ipl.zones[0].pedGroupNight, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_changed_source) {
+    CacheFiles files;
+    writeTestCache(files);
+
+    std::ofstream(files.source.string(), std::ios::app) << "# changed\n";
+
+    WorldCache cache;
+    ModelInfoTable models;
+    std::map<std::string, LoaderIPL> ipls;
+    BOOST_CHECK(!cache.read(files.cache.string(), models, ipls));
+    BOOST_CHECK(models.empty());
+    BOOST_CHECK(ipls.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_cache) {
+    CacheFiles files;
+    writeTestCache(files);
+
+    // Truncate the cache
+    rwfs::resize_file(files.cache, rwfs::file_size(files.cache) / 2);
+
+    WorldCache cache;
+    ModelInfoTable models;
+    std::map<std::string, LoaderIPL> ipls;
+    BOOST_CHECK(!cache.read(files.cache.string(), models, ipls));
+    BOOST_CHECK(models.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()